@@ -116,6 +116,13 @@ def define_options(parser):
         default=50000,
         help="network-level deadlock threshold.",
     )
+    parser.add_argument(
+        "--garnet-no-activity-tracking",
+        action="store_true",
+        default=False,
+        help="""evaluate every stage of a woken garnet router, rather
+            than only the stages with flits to move.""",
+    )
     parser.add_argument(
         "--simple-physical-channels",
         action="store_true",
@@ -172,6 +179,7 @@ def init_network(options, network, InterfaceClass):
         network.ni_flit_size = options.link_width_bits / 8
         network.routing_algorithm = options.routing_algorithm
         network.garnet_deadlock_threshold = options.garnet_deadlock_threshold
+        network.activity_tracking = not options.garnet_no_activity_tracking
 
         # Create Bridges and connect them to the corresponding links
         for intLink in network.int_links:
@@ -108,10 +108,9 @@ class VegaPWCIndexingPolicy : public BaseIndexingPolicy
      */
     ~VegaPWCIndexingPolicy() {};
 
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr &addr) const
-                                                                     override
+    EntrySpan getPossibleEntrySpan(const Addr &addr) const override
     {
-        return sets[extractSet(addr)];
+        return setEntries(extractSet(addr));
     }
 
     Addr regenerateAddr(const Addr &tag,
@@ -137,7 +136,7 @@ class PageWalkCache : public AssociativeCache<PWCEntry>
     }
     PWCEntry* findEntry(const KeyType &key) const override
     {
-        for (auto candidate : indexingPolicy->getPossibleEntries(key)) {
+        for (auto candidate : indexingPolicy->getPossibleEntrySpan(key)) {
         auto entry = static_cast<PWCEntry*>(candidate);
         if (entry->match(key))
             return entry;
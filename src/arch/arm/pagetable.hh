@@ -213,11 +213,11 @@ class TLBSetAssociative : public TLBIndexingPolicy
       : TLBIndexingPolicy(p, p.num_entries, 0)
     {}
 
-    std::vector<ReplaceableEntry*>
-    getPossibleEntries(const KeyType &key) const override
+    EntrySpan
+    getPossibleEntrySpan(const KeyType &key) const override
     {
         Addr set_number = (key.va >> key.pageSize) & setMask;
-        return sets[set_number];
+        return setEntries(set_number);
     }
 
     Addr
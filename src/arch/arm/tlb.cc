@@ -78,7 +78,7 @@ TLB::Table::findEntry(const KeyType &key) const
         return prev;
     }
 
-    for (auto candidate : indexingPolicy->getPossibleEntries(key)) {
+    for (auto candidate : indexingPolicy->getPossibleEntrySpan(key)) {
         auto entry = static_cast<TlbEntry*>(candidate);
         // We check for pageSize match outside of the Entry::match
         // as the latter is also used to match entries in TLBI invalidation
@@ -24,9 +24,20 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 from m5.objects.InstDecoder import InstDecoder
+from m5.params import *
 
 
 class X86Decoder(InstDecoder):
     type = "X86Decoder"
     cxx_class = "gem5::X86ISA::Decoder"
     cxx_header = "arch/x86/decoder.hh"
+
+    # Decoders on the same event queue share decoded instructions, which
+    # saves decoding a binary again on each CPU that runs it. The
+    # StaticInsts are not thread safe, so decoders on other event queues,
+    # i.e. other host threads, do not share
+    shared_cache = Param.Bool(
+        False,
+        "Share decoded instructions with the other decoders on the same "
+        "event queue",
+    )
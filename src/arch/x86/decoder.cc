@@ -34,6 +34,7 @@
 #include "base/types.hh"
 #include "debug/Decode.hh"
 #include "debug/Decoder.hh"
+#include "sim/eventq.hh"
 
 namespace gem5
 {
@@ -638,8 +639,18 @@ Decoder::decode(ExtMachInst mach_inst, Addr addr)
     auto iter = instMap->find(mach_inst);
     if (iter != instMap->end()) {
         si = iter->second;
+        ++stats.hits;
     } else {
-        si = decodeInst(mach_inst);
+        if (useSharedCache)
+            si = lookupShared(mach_inst);
+        if (si) {
+            ++stats.sharedHits;
+        } else {
+            si = decodeInst(mach_inst);
+            ++stats.decodes;
+            if (useSharedCache)
+                (*sharedMap)[mach_inst] = si;
+        }
         (*instMap)[mach_inst] = si;
     }
 
@@ -693,6 +704,49 @@ Decoder::decode(PCStateBase &next_pc)
     return decode(emi, origPC);
 }
 
+std::mutex Decoder::SharedCache::cachesMutex;
+std::unordered_map<const EventQueue *, Decoder::SharedCache>
+    Decoder::SharedCache::caches;
+
+Decoder::SharedCache &
+Decoder::SharedCache::get(const EventQueue *eq)
+{
+    std::lock_guard<std::mutex> lock(cachesMutex);
+    return caches[eq];
+}
+
+StaticInstPtr
+Decoder::lookupShared(ExtMachInst mach_inst)
+{
+    // the decoder may run on another event queue than the one it last
+    // looked up the shared cache on, e.g. once the simulation starts
+    if (!sharedMap || sharedQueue != curEventQueue()) {
+        sharedQueue = curEventQueue();
+        sharedMap = &SharedCache::get(sharedQueue).instMap(m5RegKey);
+    }
+
+    auto iter = sharedMap->find(mach_inst);
+    return iter != sharedMap->end() ? iter->second : nullptr;
+}
+
+Decoder::DecoderStats::DecoderStats(statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(hits, statistics::units::Count::get(),
+               "Number of instructions found in the decoder's own cache"),
+      ADD_STAT(sharedHits, statistics::units::Count::get(),
+               "Number of instructions found in the shared cache rather "
+               "than decoded"),
+      ADD_STAT(decodes, statistics::units::Count::get(),
+               "Number of instructions decoded"),
+      ADD_STAT(hitRate, statistics::units::Ratio::get(),
+               "Fraction of instructions found in a cache"),
+      ADD_STAT(sharedRate, statistics::units::Ratio::get(),
+               "Fraction of the cache misses served by the shared cache")
+{
+    hitRate = (hits + sharedHits) / (hits + sharedHits + decodes);
+    sharedRate = sharedHits / (sharedHits + decodes);
+}
+
 StaticInstPtr
 Decoder::fetchRomMicroop(MicroPC micropc, StaticInstPtr curMacroop)
 {
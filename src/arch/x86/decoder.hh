@@ -30,6 +30,7 @@
 #define __ARCH_X86_DECODER_HH__
 
 #include <cassert>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -39,6 +40,7 @@
 #include "arch/x86/types.hh"
 #include "base/bitfield.hh"
 #include "base/logging.hh"
+#include "base/statistics.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
 #include "cpu/decode_cache.hh"
@@ -50,6 +52,7 @@ namespace gem5
 {
 
 class BaseISA;
+class EventQueue;
 
 namespace X86ISA
 {
@@ -247,6 +250,74 @@ class Decoder : public InstDecoder
             CacheKey, decode_cache::InstMap<ExtMachInst> *> InstCacheMap;
     InstCacheMap instCacheMap;
 
+    /**
+     * Decoded instructions shared by the decoders that have
+     * shared_cache set, so a binary run on many CPUs is only decoded,
+     * and its StaticInsts only allocated, once. The reference counts
+     * of StaticInsts are not atomic, so decoders only share with the
+     * ones running on the same event queue, i.e. the same thread, and
+     * there is one shared cache per event queue. Finding the cache of
+     * an event queue is locked, looking up instructions in it is not.
+     * Sharing across threads would take atomic reference counts on
+     * every copy of a StaticInstPtr, which the CPUs make for every
+     * dynamic instruction. A lock-free map, e.g. of atomic bucket
+     * pointers, would make the lookups safe, but not the copies of the
+     * instructions it returns. So once the CPUs are partitioned over event
+     * queues of their own, e.g. by partition_event_queues, each CPU
+     * ends up with a private cache, and sharing only pays off between
+     * the CPUs that are kept on the same queue.
+     */
+    class SharedCache
+    {
+      private:
+        std::unordered_map<CacheKey,
+                           decode_cache::InstMap<ExtMachInst>> instMaps;
+
+        static std::mutex cachesMutex;
+        static std::unordered_map<const EventQueue *, SharedCache> caches;
+
+      public:
+        /** Get the shared cache of the decoders running on eq */
+        static SharedCache &get(const EventQueue *eq);
+
+        /** Get the instructions decoded in an m5Reg context */
+        decode_cache::InstMap<ExtMachInst> &
+        instMap(CacheKey key)
+        {
+            return instMaps[key];
+        }
+    };
+
+    /** Look up decoded instructions in a shared cache as well */
+    const bool useSharedCache;
+
+    /** The m5Reg context the decoder is in */
+    CacheKey m5RegKey = 0;
+
+    /** Event queue of the shared cache sharedMap is in */
+    const EventQueue *sharedQueue = nullptr;
+
+    /** The shared instructions of the current context, if looked up */
+    decode_cache::InstMap<ExtMachInst> *sharedMap = nullptr;
+
+    /**
+     * Look up an instruction in the shared cache.
+     *
+     * @return The shared instruction, nullptr if none is cached
+     */
+    StaticInstPtr lookupShared(ExtMachInst mach_inst);
+
+    struct DecoderStats : public statistics::Group
+    {
+        DecoderStats(statistics::Group *parent);
+
+        statistics::Scalar hits;
+        statistics::Scalar sharedHits;
+        statistics::Scalar decodes;
+        statistics::Formula hitRate;
+        statistics::Formula sharedRate;
+    } stats;
+
     StaticInstPtr decodeInst(ExtMachInst mach_inst);
 
     /// Decode a machine instruction.
@@ -257,7 +328,9 @@ class Decoder : public InstDecoder
     void process();
 
   public:
-    Decoder(const X86DecoderParams &p) : InstDecoder(p, &fetchChunk)
+    Decoder(const X86DecoderParams &p)
+        : InstDecoder(p, &fetchChunk), useSharedCache(p.shared_cache),
+          stats(this)
     {
         emi.reset();
         emi.mode.cpl = cpl;
@@ -280,6 +353,9 @@ class Decoder : public InstDecoder
         defAddr = m5Reg.defAddr;
         stack = m5Reg.stack;
 
+        m5RegKey = m5Reg;
+        sharedMap = nullptr;
+
         InstCacheMap::iterator imIter = instCacheMap.find(m5Reg);
         if (imIter != instCacheMap.end()) {
             instMap = imIter->second;
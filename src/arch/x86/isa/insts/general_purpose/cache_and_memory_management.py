@@ -113,6 +113,32 @@ def macroop MAJ_P
     majopt seg, riprel, disp, dataSize=1
 };
 
+# Batched forms, the op is performed on rcx targets rdx bytes apart
+# starting at the memory operand, e.g. the same row of rcx subarrays.
+# The memory operand must be 16 byte aligned.
+
+def macroop PUMV_M
+{
+    pumvopt (rcx, rdx), seg, sib, disp, dataSize=8
+};
+
+def macroop PUMV_P
+{
+    rdip t7
+    pumvopt (rcx, rdx), seg, riprel, disp, dataSize=8
+};
+
+def macroop MAJV_M
+{
+    majvopt (rcx, rdx), seg, sib, disp, dataSize=8
+};
+
+def macroop MAJV_P
+{
+    rdip t7
+    majvopt (rcx, rdx), seg, riprel, disp, dataSize=8
+};
+
 
 """
 
@@ -216,7 +216,7 @@ class AssociativeCache : public Named
     virtual Entry*
     findEntry(const KeyType &key) const
     {
-        auto candidates = indexingPolicy->getPossibleEntries(key);
+        auto candidates = indexingPolicy->getPossibleEntrySpan(key);
 
         for (auto candidate : candidates) {
             Entry *entry = static_cast<Entry*>(candidate);
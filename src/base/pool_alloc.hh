@@ -0,0 +1,395 @@
+#ifndef __BASE_POOL_ALLOC_HH__
+#define __BASE_POOL_ALLOC_HH__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace gem5
+{
+
+/**
+ * A thread-local, size-classed free list allocator for small objects
+ * that are allocated and freed at a high rate, such as packets and
+ * requests. Freed blocks are kept on a per-thread list for their size
+ * class and handed out again by the next allocation of that class on
+ * the same thread, so in steady state no allocation reaches the heap.
+ *
+ * Every pooled block remembers the cache of the thread it was allocated
+ * on. A block freed on another thread, as packets crossing between
+ * event queues are, goes back to that cache on a lock-free stack, which
+ * the owner takes over whole when its own list runs dry. The free lists
+ * thus stay bounded by what each thread allocates, however the blocks
+ * travel. The cache of an exited thread is kept for the next thread to
+ * start, so that blocks still in flight have somewhere to go.
+ *
+ * Each Owner type gets its own set of lists and counters, which keeps
+ * the statistics of different object types apart.
+ *
+ * @tparam Owner The type the pool serves, only used as a tag
+ */
+template <typename Owner>
+class PoolAlloc
+{
+  public:
+    /** Size classes are multiples of this many bytes */
+    static constexpr std::size_t Granularity = 16;
+
+    /** Blocks larger than this bypass the pool */
+    static constexpr std::size_t MaxPooledSize = 1024;
+
+    /** Allocation counts, summed over all threads */
+    struct Counts
+    {
+        /** Number of blocks handed out */
+        uint64_t allocs = 0;
+        /** Number of blocks that had to come from the heap */
+        uint64_t heapAllocs = 0;
+    };
+
+  private:
+    static constexpr std::size_t NumClasses = MaxPooledSize / Granularity;
+
+    struct ThreadCache;
+
+    /**
+     * Precedes each pooled block, sized to keep the block as aligned as
+     * the heap would. The owner is null for blocks allocated while the
+     * thread was shutting down, which go back to the heap when freed.
+     */
+    struct alignas(std::max_align_t) Header
+    {
+        ThreadCache *owner;
+    };
+
+    struct Block
+    {
+        Block *next;
+    };
+
+    static std::size_t
+    sizeClass(std::size_t bytes)
+    {
+        return (bytes + Granularity - 1) / Granularity - 1;
+    }
+
+    static Header *
+    header(void *p)
+    {
+        return static_cast<Header *>(p) - 1;
+    }
+
+    /**
+     * Get a block from the heap, with the size of its class so that it
+     * can be reused by any request of the same class.
+     */
+    static Block *
+    newBlock(std::size_t cls, ThreadCache *owner)
+    {
+        auto *h = static_cast<Header *>(
+            ::operator new(sizeof(Header) + (cls + 1) * Granularity));
+        h->owner = owner;
+        return reinterpret_cast<Block *>(h + 1);
+    }
+
+    static void
+    deleteBlock(Block *block)
+    {
+        ::operator delete(header(block));
+    }
+
+    /**
+     * The caches in use and the counts of the threads that exited, and
+     * the caches of those threads, waiting for a new thread to take them.
+     */
+    struct Registry
+    {
+        std::mutex lock;
+        std::vector<const ThreadCache *> caches;
+        std::vector<ThreadCache *> spare;
+        Counts retired;
+    };
+
+    static Registry &
+    registry()
+    {
+        // never destroyed, thread caches may outlive static destructors
+        static Registry *reg = new Registry;
+        return *reg;
+    }
+
+    struct ThreadCache
+    {
+        std::array<Block *, NumClasses> heads{};
+
+        // blocks of this cache freed by other threads
+        std::array<std::atomic<Block *>, NumClasses> remote{};
+
+        // only ever written by the owning thread, the atomics let other
+        // threads read them for statistics without a data race
+        std::atomic<uint64_t> allocs{0};
+        std::atomic<uint64_t> heapAllocs{0};
+
+        static void
+        bump(std::atomic<uint64_t> &counter)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+        }
+
+        /** Called by any thread but the owner to give a block back. */
+        void
+        pushRemote(std::size_t cls, Block *block)
+        {
+            Block *head = remote[cls].load(std::memory_order_relaxed);
+            do {
+                block->next = head;
+            } while (!remote[cls].compare_exchange_weak(
+                         head, block, std::memory_order_release,
+                         std::memory_order_relaxed));
+        }
+
+        /**
+         * Move the blocks given back by other threads to the free list.
+         * Only the owner takes them, and only all at once, so the stack
+         * has no ABA problem.
+         */
+        Block *
+        takeRemote(std::size_t cls)
+        {
+            Block *block =
+                remote[cls].exchange(nullptr, std::memory_order_acquire);
+            if (block)
+                heads[cls] = block->next;
+            return block;
+        }
+    };
+
+    /**
+     * Hands the calling thread a cache, a spare one if there is one, and
+     * makes it spare again when the thread exits.
+     */
+    struct ThreadSlot
+    {
+        ThreadCache *tc;
+
+        ThreadSlot()
+        {
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> guard(reg.lock);
+            if (reg.spare.empty()) {
+                tc = new ThreadCache;
+            } else {
+                tc = reg.spare.back();
+                reg.spare.pop_back();
+            }
+            reg.caches.push_back(tc);
+        }
+
+        ~ThreadSlot()
+        {
+            destroyed() = true;
+
+            // Other threads may still give blocks back, so only the free
+            // list, which no one else sees, goes back to the heap
+            for (auto &head : tc->heads) {
+                while (head) {
+                    Block *next = head->next;
+                    deleteBlock(head);
+                    head = next;
+                }
+            }
+
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> guard(reg.lock);
+            reg.retired.allocs += tc->allocs.load(std::memory_order_relaxed);
+            reg.retired.heapAllocs +=
+                tc->heapAllocs.load(std::memory_order_relaxed);
+            tc->allocs.store(0, std::memory_order_relaxed);
+            tc->heapAllocs.store(0, std::memory_order_relaxed);
+            for (auto it = reg.caches.begin(); it != reg.caches.end(); ++it) {
+                if (*it == tc) {
+                    reg.caches.erase(it);
+                    break;
+                }
+            }
+            reg.spare.push_back(tc);
+        }
+    };
+
+    static ThreadCache &
+    cache()
+    {
+        static thread_local ThreadSlot slot;
+        return *slot.tc;
+    }
+
+    /**
+     * Set once the cache of this thread is gone, so that blocks allocated
+     * during thread or program teardown come straight from the heap, and
+     * blocks freed then are all given back to their owner.
+     * Being trivially destructible, this outlives the cache itself.
+     */
+    static bool &
+    destroyed()
+    {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+  public:
+    static void *
+    allocate(std::size_t bytes)
+    {
+        const bool pooled = bytes <= MaxPooledSize && bytes != 0;
+        if (destroyed())
+            return pooled ? newBlock(sizeClass(bytes), nullptr) :
+                            ::operator new(bytes);
+
+        ThreadCache &tc = cache();
+        ThreadCache::bump(tc.allocs);
+
+        if (!pooled) {
+            ThreadCache::bump(tc.heapAllocs);
+            return ::operator new(bytes);
+        }
+
+        const std::size_t cls = sizeClass(bytes);
+        Block *block = tc.heads[cls];
+        if (block) {
+            tc.heads[cls] = block->next;
+            return block;
+        }
+        if ((block = tc.takeRemote(cls)))
+            return block;
+
+        ThreadCache::bump(tc.heapAllocs);
+        return newBlock(cls, &tc);
+    }
+
+    static void
+    deallocate(void *p, std::size_t bytes)
+    {
+        if (!p)
+            return;
+
+        if (bytes > MaxPooledSize || bytes == 0) {
+            ::operator delete(p);
+            return;
+        }
+
+        Block *block = static_cast<Block *>(p);
+        ThreadCache *owner = header(p)->owner;
+        if (!owner) {
+            deleteBlock(block);
+            return;
+        }
+
+        const std::size_t cls = sizeClass(bytes);
+        if (!destroyed() && owner == &cache()) {
+            block->next = owner->heads[cls];
+            owner->heads[cls] = block;
+        } else {
+            owner->pushRemote(cls, block);
+        }
+    }
+
+    /**
+     * Fill the free list of the calling thread up front, so that even the
+     * first allocations do not reach the heap. Meant for objects whose
+     * peak population is known from the configuration. The blocks are not
+     * counted as allocations until they are handed out.
+     *
+     * @param bytes The size of the objects to reserve blocks for
+     * @param count The number of free blocks to have for that size
+     */
+    static void
+    reserve(std::size_t bytes, std::size_t count)
+    {
+        if (bytes > MaxPooledSize || bytes == 0 || destroyed())
+            return;
+
+        ThreadCache &tc = cache();
+        const std::size_t cls = sizeClass(bytes);
+        std::size_t free = 0;
+        for (Block *b = tc.heads[cls]; b && free < count; b = b->next)
+            free++;
+        for (; free < count; free++) {
+            Block *block = newBlock(cls, &tc);
+            block->next = tc.heads[cls];
+            tc.heads[cls] = block;
+        }
+    }
+
+    /** The allocation counts over all threads so far. */
+    static Counts
+    counts()
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        Counts c = reg.retired;
+        for (const auto *tc : reg.caches) {
+            c.allocs += tc->allocs.load(std::memory_order_relaxed);
+            c.heapAllocs += tc->heapAllocs.load(std::memory_order_relaxed);
+        }
+        return c;
+    }
+};
+
+/**
+ * A standard allocator on top of PoolAlloc, for use with containers
+ * and std::allocate_shared. The latter puts the object and its shared
+ * pointer control block in a single pooled block.
+ */
+template <typename T, typename Owner = T>
+class PoolAllocator
+{
+  public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef PoolAllocator<U, Owner> other;
+    };
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, Owner> &) {}
+
+    T *
+    allocate(std::size_t n)
+    {
+        return static_cast<T *>(PoolAlloc<Owner>::allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *p, std::size_t n)
+    {
+        PoolAlloc<Owner>::deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool
+    operator==(const PoolAllocator<U, Owner> &) const
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool
+    operator!=(const PoolAllocator<U, Owner> &) const
+    {
+        return false;
+    }
+};
+
+} // namespace gem5
+
+#endif // __BASE_POOL_ALLOC_HH__
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "base/pool_alloc.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+struct Small
+{
+    uint64_t data[3];
+};
+
+struct Tracked
+{
+    int value;
+
+    Tracked(int v) : value(v) {}
+
+    static void *
+    operator new(std::size_t size)
+    {
+        return PoolAlloc<Tracked>::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        PoolAlloc<Tracked>::deallocate(p, size);
+    }
+};
+
+} // anonymous namespace
+
+/** A freed block is handed out again for the same size class. */
+TEST(PoolAllocTest, ReusesFreedBlocks)
+{
+    void *a = PoolAlloc<Small>::allocate(sizeof(Small));
+    PoolAlloc<Small>::deallocate(a, sizeof(Small));
+
+    // any size in the same 16 byte class gets the same block back
+    void *b = PoolAlloc<Small>::allocate(sizeof(Small) + 1);
+    EXPECT_EQ(a, b);
+    PoolAlloc<Small>::deallocate(b, sizeof(Small) + 1);
+}
+
+/** In steady state no allocation reaches the heap. */
+TEST(PoolAllocTest, SteadyStateHasNoHeapAllocations)
+{
+    std::vector<Tracked *> objs;
+    for (int i = 0; i < 100; i++)
+        objs.push_back(new Tracked(i));
+    for (auto *obj : objs)
+        delete obj;
+    objs.clear();
+
+    const auto before = PoolAlloc<Tracked>::counts();
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 100; i++)
+            objs.push_back(new Tracked(i));
+        for (int i = 0; i < 100; i++)
+            EXPECT_EQ(i, objs[i]->value);
+        for (auto *obj : objs)
+            delete obj;
+        objs.clear();
+    }
+    const auto after = PoolAlloc<Tracked>::counts();
+
+    EXPECT_EQ(1000u, after.allocs - before.allocs);
+    EXPECT_EQ(0u, after.heapAllocs - before.heapAllocs);
+}
+
+/** Reserved blocks serve the first allocations without the heap. */
+TEST(PoolAllocTest, ReserveFillsTheFreeList)
+{
+    struct Owner {};
+    PoolAlloc<Owner>::reserve(sizeof(Small), 50);
+    // reserving again tops up rather than adds
+    PoolAlloc<Owner>::reserve(sizeof(Small), 50);
+
+    std::vector<void *> blocks;
+    for (int i = 0; i < 50; i++)
+        blocks.push_back(PoolAlloc<Owner>::allocate(sizeof(Small)));
+    auto counts = PoolAlloc<Owner>::counts();
+    EXPECT_EQ(50u, counts.allocs);
+    EXPECT_EQ(0u, counts.heapAllocs);
+
+    blocks.push_back(PoolAlloc<Owner>::allocate(sizeof(Small)));
+    counts = PoolAlloc<Owner>::counts();
+    EXPECT_EQ(1u, counts.heapAllocs);
+
+    for (auto *block : blocks)
+        PoolAlloc<Owner>::deallocate(block, sizeof(Small));
+}
+
+/** Blocks above the pooled size go straight to the heap. */
+TEST(PoolAllocTest, LargeBlocksBypassThePool)
+{
+    const auto size = PoolAlloc<Small>::MaxPooledSize + 1;
+    const auto before = PoolAlloc<Small>::counts();
+    void *p = PoolAlloc<Small>::allocate(size);
+    PoolAlloc<Small>::deallocate(p, size);
+    void *q = PoolAlloc<Small>::allocate(size);
+    PoolAlloc<Small>::deallocate(q, size);
+    const auto after = PoolAlloc<Small>::counts();
+
+    EXPECT_EQ(2u, after.heapAllocs - before.heapAllocs);
+}
+
+/** The object and its control block share one pooled block. */
+TEST(PoolAllocTest, AllocateShared)
+{
+    struct Owner {};
+    auto first = std::allocate_shared<Tracked>(
+        PoolAllocator<Tracked, Owner>(), 1);
+    first.reset();
+
+    const auto before = PoolAlloc<Owner>::counts();
+    auto second = std::allocate_shared<Tracked>(
+        PoolAllocator<Tracked, Owner>(), 2);
+    const auto after = PoolAlloc<Owner>::counts();
+
+    EXPECT_EQ(2, second->value);
+    EXPECT_EQ(1u, after.allocs - before.allocs);
+    EXPECT_EQ(0u, after.heapAllocs - before.heapAllocs);
+}
+
+/** Counts include threads that have exited, and blocks may cross. */
+TEST(PoolAllocTest, CountsAcrossThreads)
+{
+    const auto before = PoolAlloc<Tracked>::counts();
+
+    Tracked *crossing = nullptr;
+    std::thread worker([&crossing]() {
+        for (int i = 0; i < 10; i++)
+            delete new Tracked(i);
+        crossing = new Tracked(42);
+    });
+    worker.join();
+
+    EXPECT_EQ(42, crossing->value);
+    delete crossing;
+
+    const auto after = PoolAlloc<Tracked>::counts();
+    EXPECT_EQ(11u, after.allocs - before.allocs);
+}
+
+/**
+ * Blocks freed on another thread go back to the thread that allocated
+ * them, so a producer and a consumer on two threads need no heap.
+ */
+TEST(PoolAllocTest, CrossThreadFreesGoBackToTheOwner)
+{
+    struct Owner {};
+    std::vector<void *> blocks;
+    for (int i = 0; i < 100; i++)
+        blocks.push_back(PoolAlloc<Owner>::allocate(sizeof(Small)));
+
+    for (int round = 0; round < 10; round++) {
+        std::thread consumer([&blocks]() {
+            for (auto *block : blocks)
+                PoolAlloc<Owner>::deallocate(block, sizeof(Small));
+        });
+        consumer.join();
+
+        for (auto &block : blocks)
+            block = PoolAlloc<Owner>::allocate(sizeof(Small));
+    }
+
+    auto counts = PoolAlloc<Owner>::counts();
+    EXPECT_EQ(1100u, counts.allocs);
+    EXPECT_EQ(100u, counts.heapAllocs);
+
+    for (auto *block : blocks)
+        PoolAlloc<Owner>::deallocate(block, sizeof(Small));
+}
+
+/**
+ * Blocks of a thread that exited are still given back, to a new thread
+ * which takes over its cache.
+ */
+TEST(PoolAllocTest, ExitedThreadsLeaveTheirCache)
+{
+    struct Owner {};
+    // give this thread a cache of its own first
+    PoolAlloc<Owner>::deallocate(PoolAlloc<Owner>::allocate(sizeof(Small)),
+                                 sizeof(Small));
+
+    std::vector<void *> blocks;
+    std::thread producer([&blocks]() {
+        for (int i = 0; i < 100; i++)
+            blocks.push_back(PoolAlloc<Owner>::allocate(sizeof(Small)));
+    });
+    producer.join();
+
+    for (auto *block : blocks)
+        PoolAlloc<Owner>::deallocate(block, sizeof(Small));
+
+    std::thread successor([&blocks]() {
+        for (auto &block : blocks)
+            block = PoolAlloc<Owner>::allocate(sizeof(Small));
+        for (auto *block : blocks)
+            PoolAlloc<Owner>::deallocate(block, sizeof(Small));
+    });
+    successor.join();
+
+    auto counts = PoolAlloc<Owner>::counts();
+    EXPECT_EQ(201u, counts.allocs);
+    EXPECT_EQ(101u, counts.heapAllocs);
+}
@@ -0,0 +1,332 @@
+#include "base/stats/binary.hh"
+
+#include <cassert>
+#include <cstring>
+#include <sstream>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/stats/info.hh"
+#include "base/stats/units.hh"
+#include "sim/byteswap.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+namespace
+{
+
+const char magic[8] = {'g', 'e', 'm', '5', 'b', 's', 't', '1'};
+
+/** Write a string as a JSON string literal */
+void
+jsonString(std::ostream &os, const std::string &str)
+{
+    os << '"';
+    for (const char c : str) {
+        switch (c) {
+          case '"': os << "\\\""; break;
+          case '\\': os << "\\\\"; break;
+          case '\n': os << "\\n"; break;
+          case '\t': os << "\\t"; break;
+          default:
+            if ((unsigned char)c < 0x20)
+                ccprintf(os, "\\u%04x", (unsigned)c);
+            else
+                os << c;
+        }
+    }
+    os << '"';
+}
+
+/** The name of element i of a vector, by subname or index */
+std::string
+subName(const std::vector<std::string> &subnames, size_t i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    return std::to_string(i);
+}
+
+const char *
+typeName(const Info &info)
+{
+    if (dynamic_cast<const FormulaInfo *>(&info))
+        return "formula";
+    if (dynamic_cast<const VectorInfo *>(&info))
+        return "vector";
+    if (dynamic_cast<const Vector2dInfo *>(&info))
+        return "vector2d";
+    if (dynamic_cast<const VectorDistInfo *>(&info))
+        return "vectordist";
+    if (dynamic_cast<const DistInfo *>(&info))
+        return "dist";
+    return "scalar";
+}
+
+//! Values of a distribution ahead of its buckets
+const char *distFields[] = {
+    "samples", "sum", "squares", "min_value", "max_value", "underflows",
+    "overflows", "min", "bucket_size",
+};
+const size_t numDistFields = sizeof(distFields) / sizeof(distFields[0]);
+
+} // anonymous namespace
+
+Binary::Binary(const std::string &file, bool desc)
+    : fname(file), enableDescriptions(desc)
+{
+}
+
+void
+Binary::begin()
+{
+    if (!stream.is_open()) {
+        stream.open(fname, std::ios::out | std::ios::binary |
+                    std::ios::trunc);
+        fatal_if(!stream, "Cannot open binary stat file %s\n", fname);
+        stream.write(magic, sizeof(magic));
+    }
+
+    groups.assign(1, "");
+    path.assign(1, 0);
+    columns.clear();
+    values.clear();
+}
+
+void
+Binary::end()
+{
+    assert(valid());
+
+    if (columns != schema)
+        writeSchema();
+
+    // the values are rebuilt on every dump, so swap them in place
+    if (HostByteOrder != ByteOrder::little) {
+        for (double &value : values) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits = htole(bits);
+            std::memcpy(&value, &bits, sizeof(bits));
+        }
+    }
+
+    const uint64_t tick = htole<uint64_t>(curTick());
+    writeRecord(Frame, values.data(), values.size() * sizeof(double),
+                &tick, sizeof(tick));
+    stream.flush();
+}
+
+bool
+Binary::valid() const
+{
+    return stream.good();
+}
+
+void
+Binary::beginGroup(const char *name)
+{
+    const std::string &parent = groups[path.back()];
+    path.push_back(groups.size());
+    groups.push_back(parent.empty() ? name : parent + "." + name);
+}
+
+void
+Binary::endGroup()
+{
+    assert(path.size() > 1);
+    path.pop_back();
+}
+
+void
+Binary::addStat(const Info &info, size_t count)
+{
+    columns.push_back({&info, path.back(), count});
+}
+
+void
+Binary::addDist(const DistData &data)
+{
+    values.insert(values.end(), {
+        data.samples, data.sum, data.squares, data.min_val, data.max_val,
+        data.underflow, data.overflow, double(data.min),
+        double(data.bucket_size),
+    });
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+void
+Binary::visit(const ScalarInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addStat(info, 1);
+    values.push_back(info.result());
+}
+
+void
+Binary::visit(const VectorInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const VResult &vr = info.result();
+    addStat(info, vr.size());
+    values.insert(values.end(), vr.begin(), vr.end());
+}
+
+void
+Binary::visit(const DistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addStat(info, numDistFields + info.data.cvec.size());
+    addDist(info.data);
+}
+
+void
+Binary::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_t start = values.size();
+    for (const auto &data : info.data)
+        addDist(data);
+    addStat(info, values.size() - start);
+}
+
+void
+Binary::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addStat(info, info.cvec.size());
+    values.insert(values.end(), info.cvec.begin(), info.cvec.end());
+}
+
+void
+Binary::visit(const FormulaInfo &info)
+{
+    visit(static_cast<const VectorInfo &>(info));
+}
+
+void
+Binary::visit(const SparseHistInfo &info)
+{
+    warn_once("Binary stat files don't support sparse histograms.\n");
+}
+
+void
+Binary::distNames(std::vector<std::string> &names, const std::string &name,
+                  const DistData &data)
+{
+    for (size_t i = 0; i < numDistFields; ++i)
+        names.push_back(name + "::" + distFields[i]);
+    for (size_t i = 0; i < data.cvec.size(); ++i)
+        names.push_back(csprintf("%s::%d", name, i));
+}
+
+void
+Binary::statNames(std::vector<std::string> &names,
+                  const Column &column) const
+{
+    const Info &info = *column.info;
+    const std::string &group = groups[column.group];
+    const std::string name =
+        group.empty() ? info.name : group + "." + info.name;
+
+    if (auto *vector = dynamic_cast<const VectorInfo *>(&info)) {
+        for (size_t i = 0; i < column.count; ++i)
+            names.push_back(name + "::" + subName(vector->subnames, i));
+    } else if (auto *vector2d = dynamic_cast<const Vector2dInfo *>(&info)) {
+        for (size_t x = 0; x < vector2d->x; ++x) {
+            for (size_t y = 0; y < vector2d->y; ++y) {
+                names.push_back(name + "::" +
+                                subName(vector2d->subnames, x) + "::" +
+                                subName(vector2d->y_subnames, y));
+            }
+        }
+    } else if (auto *vdist = dynamic_cast<const VectorDistInfo *>(&info)) {
+        for (size_t i = 0; i < vdist->data.size(); ++i) {
+            distNames(names, name + "::" + subName(vdist->subnames, i),
+                      vdist->data[i]);
+        }
+    } else if (auto *dist = dynamic_cast<const DistInfo *>(&info)) {
+        distNames(names, name, dist->data);
+    } else {
+        names.push_back(name);
+    }
+}
+
+void
+Binary::writeSchema()
+{
+    std::vector<std::string> names;
+    std::ostringstream json;
+
+    json << "{\"stats\": [";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const Column &column = columns[i];
+        const Info &info = *column.info;
+        const std::string &group = groups[column.group];
+        const size_t first = names.size();
+        statNames(names, column);
+        assert(names.size() - first == column.count);
+
+        json << (i ? ", " : "") << "{\"name\": ";
+        jsonString(json, group.empty() ? info.name : group + "." + info.name);
+        ccprintf(json, ", \"type\": \"%s\", \"first\": %d, \"count\": %d",
+                 typeName(info), first, column.count);
+        json << ", \"unit\": ";
+        jsonString(json, info.unit->getUnitString());
+        if (enableDescriptions) {
+            json << ", \"desc\": ";
+            jsonString(json, info.desc);
+        }
+        json << "}";
+    }
+
+    json << "], \"columns\": [";
+    for (size_t i = 0; i < names.size(); ++i) {
+        json << (i ? ", " : "");
+        jsonString(json, names[i]);
+    }
+    json << "]}";
+
+    const std::string str = json.str();
+    writeRecord(Schema, str.data(), str.size());
+    schema = columns;
+}
+
+void
+Binary::writeRecord(RecordType type, const void *data, uint64_t size,
+                    const void *header, uint64_t header_size)
+{
+    const uint32_t record_header[2] = { htole<uint32_t>(type), 0 };
+    const uint64_t payload_size = htole(header_size + size);
+    stream.write((const char *)record_header, sizeof(record_header));
+    stream.write((const char *)&payload_size, sizeof(payload_size));
+    if (header_size)
+        stream.write((const char *)header, header_size);
+    stream.write((const char *)data, size);
+}
+
+std::unique_ptr<Output>
+initBinary(const std::string &filename, bool desc)
+{
+    return std::unique_ptr<Output>(
+        new Binary(simout.resolve(filename), desc));
+}
+
+} // namespace statistics
+} // namespace gem5
@@ -0,0 +1,134 @@
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+/**
+ * Stat output that appends the raw values of every dump to a binary
+ * file, instead of formatting them. The layout of the values, the
+ * schema, is written once before the first dump, and again only if it
+ * changes, so a dump costs little more than copying the values.
+ *
+ * The file starts with the 8-byte magic "gem5bst1" and is then a
+ * sequence of records, little endian whatever the host:
+ *
+ *  - u32 type, u32 zero, u64 payload size, payload
+ *
+ * A Schema record holds JSON with the name of every column, and the
+ * name, type, unit, description and first column of every stat. A
+ * Frame record holds the u64 tick of a dump and one double per column
+ * of the last schema. The frames of one schema are all the same size,
+ * so a reader can map them as a single array, see
+ * util/read_binary_stats.py.
+ *
+ * Distributions store their sample count, sum, sum of squares, min and
+ * max value, underflows and overflows, bucket range and buckets, so
+ * every value the text output shows can be derived. Sparse histograms
+ * have no fixed layout and are left out.
+ */
+class Binary : public Output
+{
+  public:
+    enum RecordType : uint32_t
+    {
+        Schema = 1,
+        Frame = 2,
+    };
+
+    Binary(const std::string &file, bool desc);
+
+    Binary() = delete;
+    Binary(const Binary &other) = delete;
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+  protected:
+    /** A stat of the dump and where its values are */
+    struct Column
+    {
+        const Info *info;
+        //! Group of the stat, an index into groups
+        size_t group;
+        //! Number of values
+        size_t count;
+
+        bool
+        operator==(const Column &other) const
+        {
+            return info == other.info && count == other.count;
+        }
+    };
+
+    /** Account for a stat of the dump with the given values */
+    void addStat(const Info &info, size_t count);
+
+    /** Append the values of a distribution */
+    void addDist(const DistData &data);
+
+    /** Column names of the distribution of the given name */
+    static void distNames(std::vector<std::string> &names,
+                          const std::string &name, const DistData &data);
+
+    /** Column names of a stat of the dump */
+    void statNames(std::vector<std::string> &names,
+                   const Column &column) const;
+
+    /** Write the schema of the stats of this dump */
+    void writeSchema();
+
+    void writeRecord(RecordType type, const void *data, uint64_t size,
+                     const void *header=nullptr, uint64_t header_size=0);
+
+    const std::string fname;
+    const bool enableDescriptions;
+
+    std::ofstream stream;
+
+    //! Group of each stat of this dump, the full path
+    std::vector<std::string> groups;
+
+    //! Index into groups of the group being visited
+    std::vector<size_t> path;
+
+    //! Stats of this dump and of the last schema written
+    std::vector<Column> columns;
+    std::vector<Column> schema;
+
+    //! Values of this dump
+    std::vector<double> values;
+};
+
+std::unique_ptr<Output> initBinary(const std::string &filename,
+                                   bool desc = true);
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __BASE_STATS_BINARY_HH__
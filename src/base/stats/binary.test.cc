@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "base/stats/binary.hh"
+#include "base/stats/info.hh"
+#include "sim/byteswap.hh"
+#include "sim/cur_tick.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+class TestScalar : public statistics::ScalarInfo
+{
+  public:
+    double val = 0;
+
+    TestScalar(const std::string &_name)
+    {
+        name = _name;
+        flags.set(statistics::display);
+    }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override { val = 0; }
+    bool zero() const override { return val == 0; }
+    void visit(statistics::Output &visitor) override { visitor.visit(*this); }
+
+    statistics::Counter value() const override { return val; }
+    statistics::Result result() const override { return val; }
+    statistics::Result total() const override { return val; }
+};
+
+class TestVector : public statistics::VectorInfo
+{
+  public:
+    statistics::VCounter vals;
+    statistics::VResult results;
+
+    TestVector(const std::string &_name, size_t size)
+        : vals(size, 0), results(size, 0)
+    {
+        name = _name;
+        flags.set(statistics::display);
+    }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return false; }
+    void visit(statistics::Output &visitor) override { visitor.visit(*this); }
+
+    statistics::size_type size() const override { return vals.size(); }
+    const statistics::VCounter &value() const override { return vals; }
+
+    const statistics::VResult &
+    result() const override
+    {
+        return results;
+    }
+
+    statistics::Result total() const override { return 0; }
+};
+
+/** A record of a binary stat file */
+struct Record
+{
+    uint32_t type;
+    std::string payload;
+};
+
+std::vector<Record>
+readRecords(const std::string &file)
+{
+    std::ifstream in(file, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+    EXPECT_EQ(data.substr(0, 8), "gem5bst1");
+
+    std::vector<Record> records;
+    size_t pos = 8;
+    while (pos + 16 <= data.size()) {
+        uint32_t type;
+        uint64_t size;
+        std::memcpy(&type, data.data() + pos, sizeof(type));
+        std::memcpy(&size, data.data() + pos + 8, sizeof(size));
+        type = letoh(type);
+        size = letoh(size);
+        records.push_back({type, data.substr(pos + 16, size)});
+        pos += 16 + size;
+    }
+    EXPECT_EQ(pos, data.size());
+    return records;
+}
+
+std::vector<double>
+frameValues(const Record &record)
+{
+    std::vector<double> values((record.payload.size() - 8) /
+                               sizeof(double));
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint64_t bits;
+        std::memcpy(&bits, record.payload.data() + 8 + i * sizeof(bits),
+                    sizeof(bits));
+        bits = letoh(bits);
+        std::memcpy(&values[i], &bits, sizeof(bits));
+    }
+    return values;
+}
+
+void
+dump(statistics::Binary &binary, TestScalar &scalar, TestVector &vector)
+{
+    binary.begin();
+    scalar.visit(binary);
+    binary.beginGroup("cpu");
+    vector.visit(binary);
+    binary.endGroup();
+    binary.end();
+}
+
+} // anonymous namespace
+
+/** The schema is written once, then every dump only appends a frame. */
+TEST(StatsBinaryTest, SchemaOnceThenFrames)
+{
+    const std::string file = testing::TempDir() + "stats_binary_test.bin";
+    TestScalar scalar("simTicks");
+    TestVector vector("misses", 2);
+    vector.subnames = {"read", ""};
+
+    {
+        statistics::Binary binary(file, true);
+        Tick tick = 100;
+        Gem5Internal::_curTickPtr = &tick;
+
+        scalar.val = 1;
+        vector.results = {2, 3};
+        dump(binary, scalar, vector);
+
+        tick = 200;
+        scalar.val = 4;
+        vector.results = {5, 6};
+        dump(binary, scalar, vector);
+        Gem5Internal::_curTickPtr = nullptr;
+    }
+
+    const auto records = readRecords(file);
+    ASSERT_EQ(records.size(), 3);
+
+    EXPECT_EQ(records[0].type, statistics::Binary::Schema);
+    EXPECT_NE(records[0].payload.find(
+                  "\"columns\": [\"simTicks\", \"cpu.misses::read\", "
+                  "\"cpu.misses::1\"]"),
+              std::string::npos);
+
+    EXPECT_EQ(records[1].type, statistics::Binary::Frame);
+    // the file is little endian whatever the host
+    EXPECT_EQ(records[1].payload.substr(0, 8),
+              std::string("\x64\0\0\0\0\0\0\0", 8));
+    uint64_t tick;
+    std::memcpy(&tick, records[1].payload.data(), sizeof(tick));
+    EXPECT_EQ(letoh(tick), 100);
+    EXPECT_EQ(frameValues(records[1]), std::vector<double>({1, 2, 3}));
+
+    EXPECT_EQ(records[2].type, statistics::Binary::Frame);
+    std::memcpy(&tick, records[2].payload.data(), sizeof(tick));
+    EXPECT_EQ(letoh(tick), 200);
+    EXPECT_EQ(frameValues(records[2]), std::vector<double>({4, 5, 6}));
+
+    std::remove(file.c_str());
+}
+
+/** A dump with a different layout writes a new schema first. */
+TEST(StatsBinaryTest, NewSchemaOnLayoutChange)
+{
+    const std::string file = testing::TempDir() + "stats_binary_test2.bin";
+    TestScalar scalar("simTicks");
+    TestVector vector("misses", 2);
+
+    {
+        statistics::Binary binary(file, false);
+        Tick tick = 0;
+        Gem5Internal::_curTickPtr = &tick;
+
+        dump(binary, scalar, vector);
+        vector.results.resize(3);
+        dump(binary, scalar, vector);
+        Gem5Internal::_curTickPtr = nullptr;
+    }
+
+    const auto records = readRecords(file);
+    ASSERT_EQ(records.size(), 4);
+    EXPECT_EQ(records[0].type, statistics::Binary::Schema);
+    EXPECT_EQ(records[1].type, statistics::Binary::Frame);
+    EXPECT_EQ(records[2].type, statistics::Binary::Schema);
+    EXPECT_EQ(records[3].type, statistics::Binary::Frame);
+    EXPECT_EQ(frameValues(records[3]).size(), 4);
+    EXPECT_EQ(records[2].payload.find("\"desc\""), std::string::npos);
+
+    std::remove(file.c_str());
+}
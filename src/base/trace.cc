@@ -31,10 +31,18 @@
 
 #include "base/trace.hh"
 
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "base/atomicio.hh"
 #include "base/logging.hh"
@@ -169,5 +177,341 @@ OstreamLogger::logMessage(Tick when, const std::string &name,
     }
 }
 
+struct BinaryLogger::Chunk
+{
+    uint32_t thread = 0;
+    std::vector<char> data;
+    size_t used = 0;
+};
+
+namespace
+{
+
+/** An interned string with its hash, computed once per lookup */
+struct HashedString
+{
+    std::string_view str;
+    size_t hash;
+
+    bool operator==(const HashedString &other) const
+    {
+        return str == other.str;
+    }
+};
+
+struct HashOf
+{
+    size_t operator()(const HashedString &s) const { return s.hash; }
+};
+
+} // anonymous namespace
+
+struct BinaryLogger::ThreadState
+{
+    std::mutex lock;
+    uint32_t index;
+    Chunk *chunk = nullptr;
+    //! Strings defined in the chunks of this thread, by their text
+    std::unordered_map<HashedString, uint32_t, HashOf> ids;
+};
+
+struct BinaryLogger::Ring
+{
+    std::ofstream stream;
+
+    std::mutex lock;
+    //! Wakes the writer when there are full chunks
+    std::condition_variable wake;
+    //! Wakes the threads waiting for a free chunk or for the writer
+    std::condition_variable freed;
+
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<Chunk *> free;
+    std::deque<Chunk *> full;
+    bool writing = false;
+    bool stopping = false;
+    uint64_t stalls = 0;
+
+    std::vector<std::unique_ptr<ThreadState>> threads;
+    //! Ids of all strings, keyed by the strings kept here
+    std::unordered_map<HashedString, uint32_t, HashOf> ids;
+    std::deque<std::string> strings;
+
+    std::atomic<bool> closed{false};
+    std::thread writer;
+};
+
+/** Turns the lines written to a BinaryLogger stream into messages */
+class BinaryLogger::LineBuf : public std::streambuf
+{
+  protected:
+    BinaryLogger &logger;
+    std::string line;
+
+    int
+    overflow(int c) override
+    {
+        if (c == traits_type::eof())
+            return traits_type::not_eof(c);
+        line += (char)c;
+        if (c == '\n') {
+            logger.logMessage(MaxTick, "", "", line);
+            line.clear();
+        }
+        return c;
+    }
+
+  public:
+    LineBuf(BinaryLogger &_logger) : logger(_logger) {}
+};
+
+namespace
+{
+
+const char binaryTraceMagic[8] = {'g', 'e', 'm', '5', 'd', 'b', 't', '1'};
+
+//! The logger to close at exit, the last one created
+BinaryLogger *closeAtExit = nullptr;
+
+//! The generation of the next logger, or of a logger being closed
+std::atomic<uint64_t> nextGeneration{1};
+
+} // anonymous namespace
+
+BinaryLogger::BinaryLogger(const std::string &file, size_t chunk_size,
+                           size_t max_chunks)
+    : chunkSize(chunk_size), maxChunks(max_chunks),
+      generation(nextGeneration++), ring(new Ring),
+      lineBuf(new LineBuf(*this)), lineStream(new std::ostream(lineBuf.get()))
+{
+    binary = this;
+
+    ring->stream.open(file, std::ios::out | std::ios::binary |
+                      std::ios::trunc);
+    fatal_if(!ring->stream, "Cannot open binary trace file %s\n", file);
+    ring->stream.write(binaryTraceMagic, sizeof(binaryTraceMagic));
+    ring->writer = std::thread([this]() { writeChunks(); });
+
+    // Records still in the chunks would be lost on exit, fatal() included
+    if (!closeAtExit)
+        std::atexit([]() { if (closeAtExit) closeAtExit->close(); });
+    closeAtExit = this;
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    close();
+    if (closeAtExit == this)
+        closeAtExit = nullptr;
+}
+
+void
+BinaryLogger::logMessage(Tick when, const std::string &name,
+        const std::string &flag, const std::string &message)
+{
+    if (!isEnabled(name))
+        return;
+    record(when, name, flag, "%s", message);
+}
+
+std::ostream &
+BinaryLogger::getOstream()
+{
+    return *lineStream;
+}
+
+BinaryLogger::ThreadState *
+BinaryLogger::lockThread()
+{
+    thread_local uint64_t owner = 0;
+    thread_local ThreadState *state = nullptr;
+
+    // A closed logger takes no more messages, and the state cached for
+    // it must not be found again
+    if (ring->closed)
+        return nullptr;
+
+    if (owner != generation) {
+        std::lock_guard<std::mutex> lock(ring->lock);
+        ring->threads.push_back(std::make_unique<ThreadState>());
+        state = ring->threads.back().get();
+        state->index = ring->threads.size() - 1;
+        owner = generation;
+    }
+
+    state->lock.lock();
+    if (ring->closed) {
+        state->lock.unlock();
+        return nullptr;
+    }
+    return state;
+}
+
+void
+BinaryLogger::unlockThread(ThreadState &state)
+{
+    state.lock.unlock();
+}
+
+uint32_t
+BinaryLogger::intern(ThreadState &state, std::string_view str)
+{
+    // the string is hashed once, for every lookup and insertion below
+    const HashedString key{str, std::hash<std::string_view>()(str)};
+    auto it = state.ids.find(key);
+    if (it != state.ids.end())
+        return it->second;
+
+    // the threads key their ids by the strings of the ring, which stay
+    // where they are once added
+    {
+        std::lock_guard<std::mutex> lock(ring->lock);
+        auto ring_it = ring->ids.find(key);
+        if (ring_it == ring->ids.end()) {
+            ring->strings.emplace_back(str);
+            ring_it = ring->ids.emplace(
+                HashedString{ring->strings.back(), key.hash},
+                ring->ids.size()).first;
+        }
+        it = state.ids.emplace(ring_it->first, ring_it->second).first;
+    }
+    const uint32_t id = it->second;
+
+    const uint8_t type[4] = { DefineString, 0, 0, 0 };
+    const uint32_t header[2] = { htole(id), htole<uint32_t>(str.size()) };
+    char *p = reserve(state, defineSize + str.size());
+    std::memcpy(p, type, sizeof(type));
+    std::memcpy(p + 4, header, sizeof(header));
+    std::memcpy(p + defineSize, str.data(), str.size());
+    return id;
+}
+
+char *
+BinaryLogger::reserve(ThreadState &state, size_t size)
+{
+    Chunk *chunk = state.chunk;
+    if (!chunk || chunk->used + size > chunk->data.size()) {
+        if (chunk)
+            submit(chunk);
+        chunk = state.chunk = takeChunk(state.index, size);
+    }
+
+    char *p = chunk->data.data() + chunk->used;
+    chunk->used += size;
+    return p;
+}
+
+BinaryLogger::Chunk *
+BinaryLogger::takeChunk(uint32_t thread, size_t size)
+{
+    std::unique_lock<std::mutex> lock(ring->lock);
+    while (ring->free.empty()) {
+        // Grow the ring up to its limit, or when every chunk is held by
+        // a thread and none will come back from the writer
+        if (ring->chunks.size() < maxChunks ||
+            (ring->full.empty() && !ring->writing)) {
+            ring->chunks.push_back(std::make_unique<Chunk>());
+            ring->chunks.back()->data.resize(chunkSize);
+            ring->free.push_back(ring->chunks.back().get());
+        } else {
+            ++ring->stalls;
+            ring->freed.wait(lock);
+        }
+    }
+
+    Chunk *chunk = ring->free.back();
+    ring->free.pop_back();
+    chunk->thread = thread;
+    chunk->used = 0;
+    if (chunk->data.size() < size)
+        chunk->data.resize(size);
+    return chunk;
+}
+
+void
+BinaryLogger::submit(Chunk *chunk)
+{
+    std::lock_guard<std::mutex> lock(ring->lock);
+    ring->full.push_back(chunk);
+    ring->wake.notify_one();
+}
+
+void
+BinaryLogger::writeChunks()
+{
+    std::unique_lock<std::mutex> lock(ring->lock);
+    while (true) {
+        ring->wake.wait(lock, [this]() {
+            return ring->stopping || !ring->full.empty();
+        });
+        if (ring->full.empty())
+            return;
+
+        Chunk *chunk = ring->full.front();
+        ring->full.pop_front();
+        ring->writing = true;
+        lock.unlock();
+
+        const uint32_t header[2] = { htole(chunk->thread), 0 };
+        const uint64_t size = htole<uint64_t>(chunk->used);
+        ring->stream.write((const char *)header, sizeof(header));
+        ring->stream.write((const char *)&size, sizeof(size));
+        ring->stream.write(chunk->data.data(), chunk->used);
+
+        lock.lock();
+        ring->writing = false;
+        ring->free.push_back(chunk);
+        ring->freed.notify_all();
+    }
+}
+
+void
+BinaryLogger::flush()
+{
+    std::vector<ThreadState *> threads;
+    {
+        std::lock_guard<std::mutex> lock(ring->lock);
+        for (auto &state : ring->threads)
+            threads.push_back(state.get());
+    }
+
+    // Threads lock their state before the ring, so not under the ring lock
+    for (auto *state : threads) {
+        std::lock_guard<std::mutex> lock(state->lock);
+        if (state->chunk && state->chunk->used) {
+            submit(state->chunk);
+            state->chunk = nullptr;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(ring->lock);
+    ring->freed.wait(lock, [this]() {
+        return ring->full.empty() && !ring->writing;
+    });
+    ring->stream.flush();
+}
+
+void
+BinaryLogger::close()
+{
+    if (ring->closed.exchange(true))
+        return;
+
+    // The threads drop the state they cached for this logger
+    generation = nextGeneration++;
+
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(ring->lock);
+        ring->stopping = true;
+        ring->wake.notify_all();
+    }
+    ring->writer.join();
+    ring->stream.close();
+
+    warn_if(ring->stalls, "Tracing waited %d times for the binary trace "
+            "writer, consider more or larger chunks.\n", ring->stalls);
+}
+
 } // namespace trace
 } // namespace gem5
@@ -32,9 +32,15 @@
 #ifndef __BASE_TRACE_HH__
 #define __BASE_TRACE_HH__
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <type_traits>
 
 #include "base/compiler.hh"
 #include "base/cprintf.hh"
@@ -42,6 +48,7 @@
 #include "base/logging.hh"
 #include "base/match.hh"
 #include "base/types.hh"
+#include "sim/byteswap.hh"
 #include "sim/cur_tick.hh"
 
 // Return the global context name "global".  This function gets called when
@@ -54,6 +61,8 @@ namespace gem5
 
 namespace trace {
 
+class BinaryLogger;
+
 /** Debug logging base class.  Handles formatting and outputting
  *  time/name/message messages */
 class Logger
@@ -63,6 +72,8 @@ class Logger
     ObjectMatch ignore;
     /** Name match for objects to activate log */
     ObjectMatch activate;
+    /** Set by a BinaryLogger, which records the messages unformatted */
+    BinaryLogger *binary = nullptr;
 
     bool isEnabled(const std::string &name) const
     {
@@ -92,14 +103,7 @@ class Logger
     template <typename ...Args>
     void dprintf_flag(Tick when, const std::string &name,
             const std::string &flag,
-            const char *fmt, const Args &...args)
-    {
-        if (!isEnabled(name))
-            return;
-        std::ostringstream line;
-        ccprintf(line, fmt, args...);
-        logMessage(when, name, flag, line.str());
-    }
+            const char *fmt, const Args &...args);
 
     /** Dump a block of data of length len */
     void dump(Tick when, const std::string &name,
@@ -148,6 +152,244 @@ class OstreamLogger : public Logger
     std::ostream &getOstream() override { return stream; }
 };
 
+/**
+ * Logger that records the messages unformatted, as the tick, the ids of
+ * the name, flag and format string and the raw arguments, and leaves
+ * the formatting to util/decode_binary_trace.py. This makes tracing
+ * cheap enough to leave on for long runs.
+ *
+ * Every thread appends its records to a chunk of its own and hands it
+ * to a writer thread once it is full. The chunks are reused from a
+ * ring of at most max_chunks, which bounds the memory of the tracing;
+ * when the writer falls behind, the threads wait for it.
+ *
+ * The file starts with the magic "gem5dbt1" and is then a sequence of
+ * chunks, each a u32 thread index, a u32 zero and a u64 size followed
+ * by records, all little endian whatever the host:
+ *
+ *  - DefineString: u8 type, u8 0, u16 0, u32 id, u32 size, the string.
+ *    Defines a string before its first use by the thread.
+ *  - Message: u8 type, u8 number of arguments, u16 0, u32 format id,
+ *    u32 name id, u32 flag id, u64 tick, then the arguments. Every
+ *    argument is a byte with its ArgType in the high and its size in
+ *    the low nibble, followed by its value; strings are a u32 size and
+ *    the characters.
+ *
+ * Arguments that are not numbers, pointers or strings are recorded as
+ * their text.
+ */
+class BinaryLogger : public Logger
+{
+  public:
+    enum RecordType : uint8_t
+    {
+        DefineString = 1,
+        Message = 2,
+    };
+
+    enum ArgType : uint8_t
+    {
+        Signed = 1,
+        Unsigned = 2,
+        Float = 3,
+        String = 4,
+        Char = 5,
+        Bool = 6,
+        Pointer = 7,
+    };
+
+    BinaryLogger(const std::string &file, size_t chunk_size = 1 << 20,
+                 size_t max_chunks = 64);
+    ~BinaryLogger();
+
+    /** Record a message, see Logger::dprintf_flag */
+    template <typename ...Args>
+    void
+    record(Tick when, const std::string &name, const std::string &flag,
+           const char *fmt, const Args &...args)
+    {
+        recordRaw(when, name, flag, fmt, rawArg(args)...);
+    }
+
+    void logMessage(Tick when, const std::string &name,
+            const std::string &flag, const std::string &message) override;
+
+    /** A stream whose lines are recorded as messages */
+    std::ostream &getOstream() override;
+
+    /** Write out the records of all threads */
+    void flush();
+
+    /** Flush and stop the writer, later messages are dropped */
+    void close();
+
+  protected:
+    struct Chunk;
+    struct ThreadState;
+    struct Ring;
+    class LineBuf;
+
+    static constexpr size_t messageSize = 24;
+    static constexpr size_t defineSize = 12;
+
+    template <typename T>
+    static constexpr bool isCString =
+        std::is_same_v<T, const char *> || std::is_same_v<T, char *>;
+
+    /** An argument as it is recorded, itself or its text */
+    template <typename T>
+    static decltype(auto)
+    rawArg(const T &arg)
+    {
+        if constexpr (std::is_arithmetic_v<T> || std::is_pointer_v<T> ||
+                      std::is_same_v<T, std::string>) {
+            return (arg);
+        } else if constexpr (std::is_array_v<T> &&
+                             std::is_same_v<std::remove_cv_t<
+                                 std::remove_extent_t<T>>, char>) {
+            return static_cast<const char *>(arg);
+        } else {
+            return csprintf("%s", arg);
+        }
+    }
+
+    template <typename T>
+    static size_t
+    argSize(const T &arg)
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+            return 5 + arg.size();
+        else if constexpr (isCString<T>)
+            return 5 + (arg ? std::strlen(arg) : 0);
+        else if constexpr (std::is_integral_v<T>)
+            return 1 + sizeof(T);
+        else
+            return 9;
+    }
+
+    template <typename T>
+    static char *
+    putValue(char *p, uint8_t type, const T &value)
+    {
+        *p++ = type;
+        if constexpr (std::is_floating_point_v<T>) {
+            uint64_t bits;
+            static_assert(sizeof(value) == sizeof(bits));
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits = htole(bits);
+            std::memcpy(p, &bits, sizeof(bits));
+        } else {
+            const T le = htole(value);
+            std::memcpy(p, &le, sizeof(le));
+        }
+        return p + sizeof(value);
+    }
+
+    static char *
+    putString(char *p, const char *str, uint32_t size)
+    {
+        p = putValue(p, String << 4, size);
+        std::memcpy(p, str, size);
+        return p + size;
+    }
+
+    template <typename T>
+    static char *
+    putArg(char *p, const T &arg)
+    {
+        if constexpr (std::is_same_v<T, std::string>) {
+            return putString(p, arg.data(), arg.size());
+        } else if constexpr (isCString<T>) {
+            return arg ? putString(p, arg, std::strlen(arg)) :
+                         putString(p, "", 0);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return putValue(p, Bool << 4 | 1, uint8_t(arg));
+        } else if constexpr (std::is_same_v<T, char>) {
+            return putValue(p, Char << 4 | 1, arg);
+        } else if constexpr (std::is_integral_v<T>) {
+            return putValue(p, (std::is_signed_v<T> ? Signed : Unsigned) << 4 |
+                            sizeof(T), arg);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return putValue(p, Float << 4 | 8, double(arg));
+        } else {
+            return putValue(p, Pointer << 4 | 8,
+                            uint64_t(reinterpret_cast<uintptr_t>(arg)));
+        }
+    }
+
+    template <typename ...Args>
+    void
+    recordRaw(Tick when, const std::string &name, const std::string &flag,
+              const char *fmt, const Args &...args)
+    {
+        static_assert(sizeof...(Args) < 256, "Too many trace arguments");
+
+        ThreadState *state = lockThread();
+        if (!state)
+            return;
+
+        const uint8_t type[4] = { Message, sizeof...(Args), 0, 0 };
+        const uint32_t ids[3] = {
+            htole(intern(*state, fmt)), htole(intern(*state, name)),
+            htole(intern(*state, flag))
+        };
+        const uint64_t tick = htole<uint64_t>(when);
+        char *p = reserve(*state, messageSize + (argSize(args) + ... + 0));
+        std::memcpy(p, type, sizeof(type));
+        std::memcpy(p + 4, ids, sizeof(ids));
+        std::memcpy(p + 16, &tick, sizeof(tick));
+        p += messageSize;
+        ((p = putArg(p, args)), ...);
+
+        unlockThread(*state);
+    }
+
+    /** The state of the calling thread, locked, or null once closed */
+    ThreadState *lockThread();
+    void unlockThread(ThreadState &state);
+
+    /** The id of a string, defined in the chunk of the thread first */
+    uint32_t intern(ThreadState &state, std::string_view str);
+
+    /** Space for a record in the chunk of the thread */
+    char *reserve(ThreadState &state, size_t size);
+
+    /** A free chunk of at least the given size, waits for the writer */
+    Chunk *takeChunk(uint32_t thread, size_t size);
+    void submit(Chunk *chunk);
+    void writeChunks();
+
+    const size_t chunkSize;
+    const size_t maxChunks;
+
+    /**
+     * Identifies the logger to the state cached by the threads. Unlike
+     * its address, it is never reused by a later logger, nor by this one
+     * once closed.
+     */
+    std::atomic<uint64_t> generation;
+
+    std::unique_ptr<Ring> ring;
+    std::unique_ptr<LineBuf> lineBuf;
+    std::unique_ptr<std::ostream> lineStream;
+};
+
+template <typename ...Args>
+void
+Logger::dprintf_flag(Tick when, const std::string &name,
+        const std::string &flag, const char *fmt, const Args &...args)
+{
+    if (!isEnabled(name))
+        return;
+    if (binary) {
+        binary->record(when, name, flag, fmt, args...);
+        return;
+    }
+    std::ostringstream line;
+    ccprintf(line, fmt, args...);
+    logMessage(when, name, flag, line.str());
+}
+
 /** Get the current global debug logger.  This takes ownership of the given
  *  logger which should be allocated using 'new' */
 Logger *getDebugLogger();
@@ -28,8 +28,16 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <new>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "base/gtest/cur_tick_fake.hh"
 #include "base/gtest/logging.hh"
@@ -657,3 +665,205 @@ TEST(TraceTest, GlobalName)
     DPRINTF(TraceTestDebugFlag, "Test message");
     ASSERT_EQ(getString(trace::output()), "");
 }
+
+namespace
+{
+
+/** A message of a binary trace, with its strings resolved */
+struct BinaryMessage
+{
+    uint32_t thread;
+    Tick tick;
+    std::string fmt;
+    std::string name;
+    std::string flag;
+    //! Type byte and raw value of every argument
+    std::vector<std::pair<uint8_t, std::string>> args;
+};
+
+std::vector<BinaryMessage>
+readBinaryTrace(const std::string &file)
+{
+    std::ifstream in(file, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+    EXPECT_EQ(data.substr(0, 8), "gem5dbt1");
+
+    std::map<uint32_t, std::string> strings;
+    std::vector<BinaryMessage> messages;
+    size_t pos = 8;
+    while (pos < data.size()) {
+        uint32_t thread;
+        uint64_t size;
+        std::memcpy(&thread, &data[pos], 4);
+        std::memcpy(&size, &data[pos + 8], 8);
+        const size_t end = pos + 16 + size;
+        pos += 16;
+        while (pos < end) {
+            uint32_t ids[3];
+            std::memcpy(ids, &data[pos + 4], sizeof(ids));
+            if (data[pos] == trace::BinaryLogger::DefineString) {
+                strings[ids[0]] = data.substr(pos + 12, ids[1]);
+                pos += 12 + ids[1];
+                continue;
+            }
+            EXPECT_EQ(data[pos], trace::BinaryLogger::Message);
+            BinaryMessage msg{thread, 0, strings.at(ids[0]),
+                strings.at(ids[1]), strings.at(ids[2]), {}};
+            std::memcpy(&msg.tick, &data[pos + 16], 8);
+            const int nargs = data[pos + 1];
+            pos += 24;
+            for (int i = 0; i < nargs; ++i) {
+                const uint8_t type = data[pos++];
+                uint32_t arg_size = type & 0xf;
+                if (type >> 4 == trace::BinaryLogger::String) {
+                    std::memcpy(&arg_size, &data[pos], 4);
+                    pos += 4;
+                }
+                msg.args.emplace_back(type, data.substr(pos, arg_size));
+                pos += arg_size;
+            }
+            messages.push_back(msg);
+        }
+        EXPECT_EQ(pos, end);
+    }
+    return messages;
+}
+
+/** A type without a raw encoding in binary traces */
+struct Printable {};
+
+std::ostream &
+operator<<(std::ostream &os, const Printable &)
+{
+    return os << "printable";
+}
+
+template <typename T>
+std::string
+rawBytes(T value)
+{
+    return std::string((const char *)&value, sizeof(value));
+}
+
+} // anonymous namespace
+
+/** Test that a binary logger records the arguments unformatted. */
+TEST(TraceTest, BinaryLoggerRawArguments)
+{
+    const std::string file = testing::TempDir() + "trace_test.bin";
+    {
+        trace::BinaryLogger logger(file);
+        logger.dprintf_flag(100, "obj", "Flag", "%d %s %#x %c %s %.2f\n",
+                            -5, "str", (uint16_t)0xab, 'z',
+                            std::string("text"), 1.5);
+        logger.dprintf_flag(200, "obj", "Flag", "%s\n", Printable());
+    }
+
+    const auto messages = readBinaryTrace(file);
+    ASSERT_EQ(messages.size(), 2);
+
+    const auto &msg = messages[0];
+    EXPECT_EQ(msg.tick, 100);
+    EXPECT_EQ(msg.fmt, "%d %s %#x %c %s %.2f\n");
+    EXPECT_EQ(msg.name, "obj");
+    EXPECT_EQ(msg.flag, "Flag");
+    ASSERT_EQ(msg.args.size(), 6);
+    EXPECT_EQ(msg.args[0].first, trace::BinaryLogger::Signed << 4 | 4);
+    EXPECT_EQ(msg.args[0].second, rawBytes(-5));
+    EXPECT_EQ(msg.args[1].first, trace::BinaryLogger::String << 4);
+    EXPECT_EQ(msg.args[1].second, "str");
+    EXPECT_EQ(msg.args[2].first, trace::BinaryLogger::Unsigned << 4 | 2);
+    EXPECT_EQ(msg.args[2].second, rawBytes((uint16_t)0xab));
+    EXPECT_EQ(msg.args[3].first, trace::BinaryLogger::Char << 4 | 1);
+    EXPECT_EQ(msg.args[3].second, "z");
+    EXPECT_EQ(msg.args[4].second, "text");
+    EXPECT_EQ(msg.args[5].first, trace::BinaryLogger::Float << 4 | 8);
+    EXPECT_EQ(msg.args[5].second, rawBytes(1.5));
+
+    // Types without a raw encoding are recorded as their text
+    EXPECT_EQ(messages[1].args[0].first, trace::BinaryLogger::String << 4);
+    EXPECT_EQ(messages[1].args[0].second, "printable");
+
+    std::remove(file.c_str());
+}
+
+/** Test that the lines written to the stream of a binary logger are kept. */
+TEST(TraceTest, BinaryLoggerStream)
+{
+    const std::string file = testing::TempDir() + "trace_test_stream.bin";
+    {
+        trace::BinaryLogger logger(file);
+        logger.getOstream() << "line " << 1 << "\n";
+    }
+
+    const auto messages = readBinaryTrace(file);
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0].tick, MaxTick);
+    EXPECT_EQ(messages[0].fmt, "%s");
+    EXPECT_EQ(messages[0].args[0].second, "line 1\n");
+
+    std::remove(file.c_str());
+}
+
+/**
+ * Test that the messages of several threads are all written, in order
+ * for each thread, when they wait for the chunks of a small ring.
+ */
+TEST(TraceTest, BinaryLoggerThreads)
+{
+    const std::string file = testing::TempDir() + "trace_test_threads.bin";
+    const int num_threads = 4;
+    const int num_messages = 1000;
+    {
+        trace::BinaryLogger logger(file, 256, 2);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&logger, t]() {
+                for (int i = 0; i < num_messages; ++i)
+                    logger.dprintf_flag(i, "obj", "", "%d %d\n", t, i);
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    std::map<int, int> next;
+    int count = 0;
+    for (const auto &msg : readBinaryTrace(file)) {
+        int t, i;
+        std::memcpy(&t, msg.args[0].second.data(), sizeof(t));
+        std::memcpy(&i, msg.args[1].second.data(), sizeof(i));
+        EXPECT_EQ(i, next[t]++);
+        EXPECT_EQ(msg.tick, i);
+        ++count;
+    }
+    EXPECT_EQ(count, num_threads * num_messages);
+
+    std::remove(file.c_str());
+}
+
+/**
+ * Test that a logger built where a destroyed one was does not use the
+ * state the thread kept for the destroyed one.
+ */
+TEST(TraceTest, BinaryLoggerSameAddress)
+{
+    const std::string files[2] = {
+        testing::TempDir() + "trace_test_first.bin",
+        testing::TempDir() + "trace_test_second.bin",
+    };
+    alignas(trace::BinaryLogger) char storage[sizeof(trace::BinaryLogger)];
+    for (int i = 0; i < 2; ++i) {
+        auto *logger = new (storage) trace::BinaryLogger(files[i]);
+        logger->dprintf_flag(i, "obj", "Flag", "%d\n", i);
+        logger->~BinaryLogger();
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        const auto messages = readBinaryTrace(files[i]);
+        ASSERT_EQ(messages.size(), 1);
+        EXPECT_EQ(messages[0].tick, i);
+        std::remove(files[i].c_str());
+    }
+}
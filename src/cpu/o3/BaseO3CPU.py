@@ -79,6 +79,11 @@ class BaseO3CPU(BaseCPU):
         return True
 
     activity = Param.Unsigned(0, "Initial count")
+    sleepOnMemoryStall = Param.Bool(
+        False,
+        "Deschedule the tick while no stage can progress until a memory "
+        "response arrives",
+    )
 
     cacheStorePorts = Param.Unsigned(
         200, "Cache Ports. Constrains stores only."
@@ -641,6 +641,53 @@ Commit::tick()
     updateStatus();
 }
 
+bool
+Commit::canSkipCycles()
+{
+    ThreadID tid = activeThreads->front();
+
+    if ((commitStatus[tid] != Running && commitStatus[tid] != Idle) ||
+        trapSquash[tid] || tcSquash[tid] || trapInFlight[tid] ||
+        interrupt != NoFault || cpu->checkInterrupts(tid)) {
+        return false;
+    }
+
+    // The ROB must not be about to be reported empty.
+    if (checkEmptyROB[tid] && rob->isEmpty(tid) &&
+        !iewStage->hasStoresToWB(tid)) {
+        return false;
+    }
+
+    skippedStallInst = nullptr;
+    if (rob->isEmpty(tid))
+        return true;
+
+    const DynInstPtr &head_inst = rob->readHeadInst(tid);
+    if (!head_inst->readyToCommit()) {
+        skippedStallInst = head_inst;
+        return true;
+    }
+
+    // A non-speculative head waits for the stores before it.
+    return !head_inst->isSquashed() && !head_inst->isExecuted() &&
+        !head_inst->noCapableFU() && iewStage->hasStoresToWB(tid);
+}
+
+void
+Commit::skipCycles(Cycles cycles)
+{
+    ThreadID tid = activeThreads->front();
+
+    for (Cycles i(0); i < cycles; ++i) {
+        // Each cycle reads the ROB head once.
+        rob->isHeadReady(tid);
+        if (skippedStallInst)
+            ppCommitStall->notify(skippedStallInst);
+    }
+
+    stats.numCommittedDist.sample(0, cycles);
+}
+
 void
 Commit::handleInterrupt()
 {
@@ -205,6 +205,14 @@ class Commit
     /** Ticks the commit stage, which tries to commit instructions. */
     void tick();
 
+    /** Returns if ticking commit would only record the same stall until
+     * something external changes its state.
+     */
+    bool canSkipCycles();
+
+    /** Records the stats of cycles skipped while stalled. */
+    void skipCycles(Cycles cycles);
+
     /** Handles any squashes that are sent from IEW, and adds instructions
      * to the ROB and tries to commit instructions.
      */
@@ -439,6 +447,9 @@ class Commit
         commit_impl.hh). */
     bool checkEmptyROB[MaxThreads];
 
+    /** The ROB head that was not ready in the cycles being skipped. */
+    DynInstPtr skippedStallInst;
+
     /** Pointer to the list of active threads. */
     std::list<ThreadID> *activeThreads;
 
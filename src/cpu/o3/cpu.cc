@@ -110,6 +110,9 @@ CPU::CPU(const BaseO3CPUParams &params)
       activityRec(name(), NumStages,
                   params.backComSize + params.forwardComSize,
                   params.activity),
+      sleepOnMemoryStall(params.sleepOnMemoryStall &&
+                         params.numThreads == 1),
+      memoryStallWindow(params.backComSize + params.forwardComSize),
 
       globalSeqNum(1),
       system(params.system),
@@ -123,6 +126,10 @@ CPU::CPU(const BaseO3CPUParams &params)
             "More workload items (%d) than threads (%d) on CPU %s.",
             params.workload.size(), params.numThreads, name());
 
+    warn_if(params.sleepOnMemoryStall && params.numThreads > 1,
+            "%s: sleepOnMemoryStall only supports a single thread, "
+            "ignoring it.", name());
+
     if (!params.switched_out) {
         _status = Running;
     } else {
@@ -346,7 +353,10 @@ CPU::CPUStats::CPUStats(CPU *cpu)
                "to idling"),
       ADD_STAT(quiesceCycles, statistics::units::Cycle::get(),
                "Total number of cycles that CPU has spent quiesced or waiting "
-               "for an interrupt")
+               "for an interrupt"),
+      ADD_STAT(memoryStallSleeps, statistics::units::Count::get(),
+               "Number of times that the CPU unscheduled itself until a "
+               "memory response arrived")
 {
     // Register any of the O3CPU's stats here.
     timesIdled
@@ -357,6 +367,9 @@ CPU::CPUStats::CPUStats(CPU *cpu)
 
     quiesceCycles
         .prereq(quiesceCycles);
+
+    memoryStallSleeps
+        .prereq(memoryStallSleeps);
 }
 
 void
@@ -366,6 +379,12 @@ CPU::tick()
     assert(!switchedOut());
     assert(drainState() != DrainState::Drained);
 
+    if (memoryStalled) {
+        // Account for the ticks skipped since the CPU went to sleep.
+        skipStalledCycles(Cycles(curCycle() - 1));
+        memoryStalled = false;
+    }
+
     ++baseStats.numCycles;
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
@@ -396,6 +415,9 @@ CPU::tick()
         cleanUpRemovedInsts();
     }
 
+    if (sleepOnMemoryStall)
+        stalledTicks = stalledOnMemory() ? stalledTicks + 1 : 0;
+
     if (!tickEvent.scheduled()) {
         if (_status == SwitchedOut) {
             DPRINTF(O3CPU, "Switched out!\n");
@@ -405,6 +427,15 @@ CPU::tick()
             DPRINTF(O3CPU, "Idle!\n");
             lastRunningCycle = curCycle();
             cpuStats.timesIdled++;
+        } else if (stalledTicks > memoryStallWindow) {
+            // Every following tick would only repeat this one until a
+            // memory response arrives, so skip them and replay their
+            // stats once woken.
+            DPRINTF(Activity, "Stalled on memory, descheduling tick\n");
+            cpuStats.memoryStallSleeps++;
+            memoryStalled = true;
+            memoryStallCycle = curCycle();
+            stalledTicks = 0;
         } else {
             schedule(tickEvent, clockEdge(Cycles(1)));
             DPRINTF(O3CPU, "Scheduling next tick!\n");
@@ -447,6 +478,29 @@ CPU::startup()
     commit.startupStage();
 }
 
+void
+CPU::preDumpStats()
+{
+    // A CPU sleeping on memory has not accounted for its last ticks yet.
+    if (memoryStalled) {
+        skipStalledCycles(clockEdge() == curTick() ?
+                          curCycle() : Cycles(curCycle() - 1));
+    }
+
+    BaseCPU::preDumpStats();
+}
+
+void
+CPU::resetStats()
+{
+    if (memoryStalled) {
+        skipStalledCycles(clockEdge() == curTick() ?
+                          curCycle() : Cycles(curCycle() - 1));
+    }
+
+    BaseCPU::resetStats();
+}
+
 void
 CPU::activateThread(ThreadID tid)
 {
@@ -1118,6 +1172,9 @@ CPU::squashFromTC(ThreadID tid)
 {
     thread[tid]->noSquashFromTC = true;
     commit.generateTCEvent(tid);
+
+    if (memoryStalled)
+        wakeCPU();
 }
 
 CPU::ListIt
@@ -1303,9 +1360,65 @@ CPU::wakeDependents(const DynInstPtr &inst)
     iew.wakeDependents(inst);
 }
 */
+bool
+CPU::stalledOnMemory()
+{
+    if (_status != Running || drainState() != DrainState::Running ||
+        activeThreads.size() != 1 || removeInstsThisCycle) {
+        return false;
+    }
+
+    // Nothing may be left in flight between the stages.
+    int active_stages = 0;
+    for (int idx = 0; idx < activityRec.getNumStages(); ++idx)
+        active_stages += activityRec.getStageActive(idx);
+    if (activityRec.getActivityCount() != active_stages)
+        return false;
+
+    if (!fetch.canSkipCycles() || !decode.canSkipCycles() ||
+        !rename.canSkipCycles() || !iew.canSkipCycles() ||
+        !commit.canSkipCycles()) {
+        return false;
+    }
+
+    // Only sleep if a response is on its way to wake the CPU up.
+    return fetch.awaitingMemory() || iew.ldstQueue.awaitingMemory();
+}
+
+void
+CPU::skipStalledCycles(Cycles until)
+{
+    if (until <= memoryStallCycle)
+        return;
+
+    Cycles cycles(until - memoryStallCycle);
+    DPRINTF(Activity, "Accounting for %d cycles stalled on memory\n",
+            cycles);
+
+    baseStats.numCycles += cycles;
+
+    fetch.skipCycles(cycles);
+    decode.skipCycles(cycles);
+    rename.skipCycles(cycles);
+    iew.skipCycles(cycles);
+    commit.skipCycles(cycles);
+
+    memoryStallCycle = until;
+}
+
 void
 CPU::wakeCPU()
 {
+    if (memoryStalled) {
+        // The tick accounts for the skipped cycles once it runs.
+        if (!tickEvent.scheduled()) {
+            DPRINTF(Activity, "Waking up CPU stalled on memory\n");
+            schedule(tickEvent, clockEdge(
+                        Cycles(curCycle() > memoryStallCycle ? 0 : 1)));
+        }
+        return;
+    }
+
     if (activityRec.active() || tickEvent.scheduled()) {
         DPRINTF(Activity, "CPU already running.\n");
         return;
@@ -1327,6 +1440,10 @@ CPU::wakeCPU()
 void
 CPU::wakeup(ThreadID tid)
 {
+    // Interrupts are posted through here.
+    if (memoryStalled)
+        wakeCPU();
+
     if (thread[tid]->status() != gem5::ThreadContext::Suspended)
         return;
 
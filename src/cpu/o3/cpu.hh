@@ -195,6 +195,9 @@ class CPU : public BaseCPU
 
     void startup() override;
 
+    void preDumpStats() override;
+    void resetStats() override;
+
     /** Returns the Number of Active Threads in the CPU */
     int
     numActiveThreads()
@@ -483,6 +486,33 @@ class CPU : public BaseCPU
      */
     ActivityRecorder activityRec;
 
+    /** Whether to deschedule the tick while stalled on memory. */
+    const bool sleepOnMemoryStall;
+
+    /** Number of consecutive stalled ticks needed before sleeping, so
+     * that nothing is left in flight in the time buffers.
+     */
+    const unsigned memoryStallWindow;
+
+    /** Consecutive ticks in which no stage could make progress. */
+    unsigned stalledTicks = 0;
+
+    /** Whether the tick is descheduled waiting on a memory response. */
+    bool memoryStalled = false;
+
+    /** The last cycle accounted for while stalled on memory. */
+    Cycles memoryStallCycle;
+
+    /** Returns if no stage can make progress before a memory response
+     * wakes the CPU.
+     */
+    bool stalledOnMemory();
+
+    /** Accounts for the ticks skipped while stalled on memory, up to
+     * and including the given cycle, as if the CPU had run them.
+     */
+    void skipStalledCycles(Cycles until);
+
   public:
     /** Records that there was time buffer activity this cycle. */
     void activityThisCycle() { activityRec.activity(); }
@@ -584,6 +614,9 @@ class CPU : public BaseCPU
         /** Stat for total number of cycles the CPU spends descheduled due to a
          * quiesce operation or waiting for an interrupt. */
         statistics::Scalar quiesceCycles;
+        /** Stat for the times the CPU descheduled its tick until a memory
+         * response arrives, see sleepOnMemoryStall. */
+        statistics::Scalar memoryStallSleeps;
     } cpuStats;
 
   public:
@@ -576,6 +576,30 @@ Decode::tick()
     }
 }
 
+bool
+Decode::canSkipCycles()
+{
+    ThreadID tid = activeThreads->front();
+
+    // A stall persists until rename signals otherwise.
+    if (checkStall(tid)) {
+        skippedStall = &stats.blockedCycles;
+        return decodeStatus[tid] == Blocked && insts[tid].empty();
+    }
+
+    skippedStall = &stats.idleCycles;
+    return (decodeStatus[tid] == Running || decodeStatus[tid] == Idle) &&
+        insts[tid].empty() && skidBuffer[tid].empty();
+}
+
+void
+Decode::skipCycles(Cycles cycles)
+{
+    assert(skippedStall);
+
+    *skippedStall += cycles;
+}
+
 void
 Decode::decode(bool &status_change, ThreadID tid)
 {
@@ -136,6 +136,14 @@ class Decode
      */
     void tick();
 
+    /** Returns if ticking decode would only record the same stall until
+     * something external changes its state.
+     */
+    bool canSkipCycles();
+
+    /** Records the stats of cycles skipped while stalled. */
+    void skipCycles(Cycles cycles);
+
     /** Determines what to do based on decode's current status.
      * @param status_change decode() sets this variable if there was a status
      * change (ie switching from from blocking to unblocking).
@@ -294,6 +302,9 @@ class Decode
      */
     bool squashAfterDelaySlot[MaxThreads];
 
+    /** The stall counter that skipped cycles are recorded in. */
+    statistics::Scalar *skippedStall = nullptr;
+
     struct DecodeStats : public statistics::Group
     {
         DecodeStats(CPU *cpu);
@@ -564,7 +564,7 @@ Fetch::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
     // Setup the memReq to do a read of the first instruction's address.
     // Set the appropriate read size and flags as well.
     // Build request here.
-    RequestPtr mem_req = std::make_shared<Request>(
+    RequestPtr mem_req = Request::create(
         fetchBufferBlockPC, fetchBufferSize,
         Request::INST_FETCH, cpu->instRequestorId(), pc,
         cpu->thread[tid]->contextId());
@@ -911,6 +911,60 @@ Fetch::tick()
     numInst = 0;
 }
 
+bool
+Fetch::canSkipCycles()
+{
+    ThreadID tid = activeThreads->front();
+
+    if (stalls[tid].drain)
+        return false;
+
+    if (fetchStatus[tid] == IcacheWaitResponse ||
+        fetchStatus[tid] == ItlbWait) {
+        skippedStall = fetchStatus[tid] == IcacheWaitResponse ?
+            &cpu->fetchStats[tid]->icacheStallCycles : &fetchStats.tlbCycles;
+
+        // Nothing may be sent to decode while waiting.
+        return stalls[tid].decode || fetchQueue[tid].empty();
+    }
+
+    // Otherwise the fetch queue must be full and blocked by decode, and
+    // the fetch buffer still valid, so that no access is started.
+    if (fetchStatus[tid] != Running || interruptPending ||
+        !stalls[tid].decode || fetchQueue[tid].size() < fetchQueueSize) {
+        return false;
+    }
+
+    skippedStall = &fetchStats.cycles;
+
+    Addr fetch_addr = (pc[tid]->instAddr() + fetchOffset[tid]) &
+        decoder[tid]->pcMask();
+    return macroop[tid] || (fetchBufferValid[tid] &&
+            fetchBufferAlignPC(fetch_addr) == fetchBufferPC[tid]);
+}
+
+bool
+Fetch::awaitingMemory() const
+{
+    ThreadID tid = activeThreads->front();
+
+    return fetchStatus[tid] == IcacheWaitResponse ||
+        fetchStatus[tid] == ItlbWait;
+}
+
+void
+Fetch::skipCycles(Cycles cycles)
+{
+    assert(skippedStall);
+
+    *skippedStall += cycles;
+    fetchStats.nisnDist.sample(0, cycles);
+
+    // Draw from the random stream as each tick would have.
+    for (Cycles i(0); i < cycles; ++i)
+        rng->random<uint8_t>(0, activeThreads->size() - 1);
+}
+
 bool
 Fetch::checkSignalsAndUpdate(ThreadID tid)
 {
@@ -339,6 +339,17 @@ class Fetch
      */
     void tick();
 
+    /** Returns if ticking fetch would only record the same stalls until
+     * something external changes its state.
+     */
+    bool canSkipCycles();
+
+    /** Returns if fetch is waiting on the I-cache or the ITLB. */
+    bool awaitingMemory() const;
+
+    /** Records the stats of cycles skipped while stalled. */
+    void skipCycles(Cycles cycles);
+
     /** Checks all input signals and updates the status as necessary.
      *  @return: Returns if the status has changed due to input signals.
      */
@@ -521,6 +532,9 @@ class Fetch
      */
     bool interruptPending;
 
+    /** The stall counter that skipped cycles are recorded in. */
+    statistics::Scalar *skippedStall = nullptr;
+
     /** Instruction port. Note that it has to appear after the fetch stage. */
     IcachePort icachePort;
 
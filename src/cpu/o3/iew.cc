@@ -1527,6 +1527,35 @@ IEW::tick()
     }
 }
 
+bool
+IEW::canSkipCycles()
+{
+    ThreadID tid = activeThreads->front();
+
+    if (exeStatus != Idle || updateLSQNextCycle ||
+        !instQueue.canSkipCycles() || !ldstQueue.canSkipCycles()) {
+        return false;
+    }
+
+    // Dispatch stays blocked until an instruction leaves the IQ.
+    skippedBlocked = checkStall(tid);
+    if (skippedBlocked)
+        return dispatchStatus[tid] == Blocked && insts[tid].empty();
+
+    return (dispatchStatus[tid] == Running || dispatchStatus[tid] == Idle) &&
+        insts[tid].empty() && skidBuffer[tid].empty();
+}
+
+void
+IEW::skipCycles(Cycles cycles)
+{
+    if (skippedBlocked)
+        iewStats.blockCycles += cycles;
+
+    instQueue.skipCycles(cycles);
+    instQueue.iqIOStats.intInstQueueReads += cycles;
+}
+
 void
 IEW::updateExeInstStats(const DynInstPtr& inst)
 {
@@ -295,6 +295,14 @@ class IEW
      */
     void tick();
 
+    /** Returns if ticking IEW would only record the same stall until
+     * something external changes its state.
+     */
+    bool canSkipCycles();
+
+    /** Records the stats of cycles skipped while stalled. */
+    void skipCycles(Cycles cycles);
+
   private:
     /** Updates execution stats based on the instruction. */
     void updateExeInstStats(const DynInstPtr &inst);
@@ -367,6 +375,9 @@ class IEW
      */
     bool updateLSQNextCycle;
 
+    /** Whether dispatch was blocked in the cycles being skipped. */
+    bool skippedBlocked = false;
+
   private:
     /** Records if there is a fetch redirect on this cycle for each thread. */
     bool fetchRedirect[MaxThreads];
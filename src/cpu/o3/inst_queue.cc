@@ -554,6 +554,21 @@ InstructionQueue::hasReadyInsts()
     return false;
 }
 
+bool
+InstructionQueue::canSkipCycles()
+{
+    // Blocked memory instructions are retried once the cache unblocks,
+    // which wakes the CPU up.
+    return !hasReadyInsts() && instsToExecute.empty() &&
+        deferredMemInsts.empty() && retryMemInsts.empty();
+}
+
+void
+InstructionQueue::skipCycles(Cycles cycles)
+{
+    iqStats.numIssuedDist.sample(0, cycles);
+}
+
 void
 InstructionQueue::insert(const DynInstPtr &new_inst)
 {
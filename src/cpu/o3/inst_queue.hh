@@ -181,6 +181,14 @@ class InstructionQueue
     /** Returns if there are any ready instructions in the IQ. */
     bool hasReadyInsts();
 
+    /** Returns if the IQ has nothing to issue until an instruction
+     * completes.
+     */
+    bool canSkipCycles();
+
+    /** Records the stats of cycles skipped while nothing could issue. */
+    void skipCycles(Cycles cycles);
+
     /** Inserts a new instruction into the IQ. */
     void insert(const DynInstPtr &new_inst);
 
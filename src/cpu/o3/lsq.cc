@@ -738,6 +738,28 @@ LSQ::willWB(ThreadID tid)
     return thread.at(tid).willWB();
 }
 
+bool
+LSQ::canSkipCycles()
+{
+    for (ThreadID tid : *activeThreads) {
+        if (!thread[tid].canSkipCycles())
+            return false;
+    }
+
+    return true;
+}
+
+bool
+LSQ::awaitingMemory()
+{
+    for (ThreadID tid : *activeThreads) {
+        if (thread[tid].awaitingMemory())
+            return true;
+    }
+
+    return false;
+}
+
 void
 LSQ::dumpInsts() const
 {
@@ -962,7 +984,7 @@ LSQ::SplitDataRequest::initiateTranslation()
     Addr final_addr = addrBlockAlign(_addr + _size, cacheLineSize);
     uint32_t size_so_far = 0;
 
-    _mainReq = std::make_shared<Request>(base_addr,
+    _mainReq = Request::create(base_addr,
                 _size, _flags, _inst->requestorId(),
                 _inst->pcState().instAddr(), _inst->contextId());
     _mainReq->setByteEnable(_byteEnable);
@@ -1079,7 +1101,7 @@ LSQ::LSQRequest::addReq(Addr addr, unsigned size,
            const std::vector<bool>& byte_enable)
 {
     if (isAnyActiveElement(byte_enable.begin(), byte_enable.end())) {
-        auto req = new Request(
+        RequestPtr req = Request::create(
                 addr, size, _flags, _inst->requestorId(),
                 _inst->pcState().instAddr(), _inst->contextId(),
                 std::move(_amo_op));
@@ -1087,10 +1109,12 @@ LSQ::LSQRequest::addReq(Addr addr, unsigned size,
 
         /* If the request is marked as NO_ACCESS, setup a local access */
         if (_flags.isSet(Request::NO_ACCESS)) {
+            // capture a plain pointer, the request owns the accessor
+            Request *r = req.get();
             req->setLocalAccessor(
-                [this, req](gem5::ThreadContext *tc, PacketPtr pkt) -> Cycles
+                [this, r](gem5::ThreadContext *tc, PacketPtr pkt) -> Cycles
                 {
-                    if ((req->isHTMStart() || req->isHTMCommit())) {
+                    if ((r->isHTMStart() || r->isHTMCommit())) {
                         auto& inst = this->instruction();
                         assert(inst->inHtmTransactionalState());
                         pkt->setHtmTransactional(
@@ -1101,7 +1125,7 @@ LSQ::LSQRequest::addReq(Addr addr, unsigned size,
             );
         }
 
-        _reqs.emplace_back(req);
+        _reqs.emplace_back(std::move(req));
     }
 }
 
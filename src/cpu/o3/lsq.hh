@@ -863,6 +863,14 @@ class LSQ
      */
     bool willWB(ThreadID tid);
 
+    /** Returns if no store can be written back until a response
+     * arrives.
+     */
+    bool canSkipCycles();
+
+    /** Returns if any load or store waits on a response from memory. */
+    bool awaitingMemory();
+
     /** Debugging function to print out all instructions. */
     void dumpInsts() const;
     /** Debugging function to print out instructions from a specific thread. */
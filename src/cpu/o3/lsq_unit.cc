@@ -1141,6 +1141,39 @@ LSQUnit::writeback(const DynInstPtr &inst, PacketPtr pkt)
     iewStage->checkMisprediction(inst);
 }
 
+bool
+LSQUnit::canSkipCycles()
+{
+    if (isStoreBlocked)
+        return false;
+
+    // Under TSO the next store waits for the one in flight.
+    return storesToWB == 0 || (needsTSO && storeInFlight) ||
+        !(storeWBIt.dereferenceable() && storeWBIt->valid() &&
+          storeWBIt->canWB());
+}
+
+bool
+LSQUnit::awaitingMemory()
+{
+    auto sent = [](LSQEntry &entry) {
+        return entry.valid() && entry.hasRequest() &&
+            entry.request()->isSent() &&
+            entry.request()->isAnyOutstandingRequest();
+    };
+
+    for (auto &entry : storeQueue) {
+        if (sent(entry))
+            return true;
+    }
+    for (auto &entry : loadQueue) {
+        if (sent(entry))
+            return true;
+    }
+
+    return false;
+}
+
 void
 LSQUnit::completeStore(typename StoreQueue::iterator store_idx)
 {
@@ -277,6 +277,14 @@ class LSQUnit
     /** Writes back stores. */
     void writebackStores();
 
+    /** Returns if no store can be written back until a response
+     * arrives.
+     */
+    bool canSkipCycles();
+
+    /** Returns if any load or store waits on a response from memory. */
+    bool awaitingMemory();
+
     /** Completes the data access that has been returned from the
      * memory system. */
     void completeDataAccess(PacketPtr pkt);
@@ -466,6 +466,35 @@ Rename::tick()
 
 }
 
+bool
+Rename::canSkipCycles()
+{
+    ThreadID tid = activeThreads->front();
+
+    if (!freeingInProgress[tid].empty() || resumeSerialize ||
+        resumeUnblocking) {
+        return false;
+    }
+
+    // A stall persists until IEW or commit signal free entries.
+    if (checkStall(tid)) {
+        skippedStall = &stats.blockCycles;
+        return renameStatus[tid] == Blocked && insts[tid].empty();
+    }
+
+    skippedStall = &stats.idleCycles;
+    return (renameStatus[tid] == Running || renameStatus[tid] == Idle) &&
+        insts[tid].empty() && skidBuffer[tid].empty();
+}
+
+void
+Rename::skipCycles(Cycles cycles)
+{
+    assert(skippedStall);
+
+    *skippedStall += cycles;
+}
+
 void
 Rename::rename(bool &status_change, ThreadID tid)
 {
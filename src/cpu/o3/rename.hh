@@ -195,6 +195,14 @@ class Rename
      */
     void tick();
 
+    /** Returns if ticking rename would only record the same stall until
+     * something external changes its state.
+     */
+    bool canSkipCycles();
+
+    /** Records the stats of cycles skipped while stalled. */
+    void skipCycles(Cycles cycles);
+
     /** Debugging function used to dump history buffer of renamings. */
     void dumpHistory();
 
@@ -362,6 +370,9 @@ class Rename
     /** Hold phys regs to be released after squash finish */
     std::vector<PhysRegIdPtr> freeingInProgress[MaxThreads];
 
+    /** The stall counter that skipped cycles are recorded in. */
+    statistics::Scalar *skippedStall = nullptr;
+
     /** Pointer to the list of active threads. */
     std::list<ThreadID> *activeThreads;
 
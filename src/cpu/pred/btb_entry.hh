@@ -99,14 +99,10 @@ class BTBSetAssociative : public BTBIndexingPolicy
     /**
      * Find all possible entries for insertion and replacement of an address.
      */
-    std::vector<ReplaceableEntry*>
-    getPossibleEntries(const KeyType &key) const override
+    EntrySpan
+    getPossibleEntrySpan(const KeyType &key) const override
     {
-        auto set_idx = extractSet(key);
-
-        assert(set_idx < sets.size());
-
-        return sets[set_idx];
+        return setEntries(extractSet(key));
     }
 
     /**
@@ -0,0 +1,22 @@
+from m5.objects.ClockedObject import ClockedObject
+from m5.params import *
+from m5.proxy import *
+
+
+class PUMTracePlayer(ClockedObject):
+    type = "PUMTracePlayer"
+    cxx_header = "cpu/testers/pum_trace_player/pum_trace_player.hh"
+    cxx_class = "gem5::PUMTracePlayer"
+
+    port = RequestPort("Port to the memory the trace is replayed on")
+
+    # a packet trace, e.g. recorded by a MemTraceProbe on the PktRequest
+    # probe point of a Ramulator2 controller. It holds no data, so the
+    # replay is timing only and the memory should be null
+    trace_file = Param.String("Packet trace to replay")
+
+    max_outstanding = Param.Unsigned(
+        128, "Maximum number of requests waiting for a response"
+    )
+
+    system = Param.System(Parent.any, "System the player belongs to")
@@ -0,0 +1,238 @@
+#include "cpu/testers/pum_trace_player/pum_trace_player.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/PUMTracePlayer.hh"
+#include "proto/packet.pb.h"
+#include "sim/core.hh"
+#include "sim/cur_tick.hh"
+#include "sim/sim_exit.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+PUMTracePlayer::PUMTracePlayer(const Params &p)
+    : ClockedObject(p),
+      port(name() + ".port", *this),
+      trace(p.trace_file),
+      system(p.system),
+      maxOutstanding(p.max_outstanding),
+      traceDone(false),
+      firstTick(0),
+      startTick(0),
+      retryPkt(nullptr),
+      outstanding(0),
+      sendEvent([this]{ sendRequests(); }, name()),
+      stats(this)
+{
+    fatal_if(maxOutstanding == 0, "%s: max_outstanding must be at least "
+             "one\n", name());
+
+    ProtoMessage::PacketHeader header_msg;
+    fatal_if(!trace.read(header_msg), "%s: failed to read the header of "
+             "%s\n", name(), p.trace_file);
+    fatal_if(header_msg.tick_freq() != sim_clock::Frequency,
+             "%s: trace was recorded with a different tick frequency %d\n",
+             name(), header_msg.tick_freq());
+
+    // requestors have to be known before the memories size their
+    // per-requestor statistics, so register one for every requestor
+    // named in the header, whether or not it shows up in the trace
+    for (const auto &id_string : header_msg.id_strings()) {
+        requestorIds[id_string.key()] =
+            system->getRequestorId(this, id_string.value());
+    }
+}
+
+Port &
+PUMTracePlayer::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "port")
+        return port;
+    return ClockedObject::getPort(if_name, idx);
+}
+
+void
+PUMTracePlayer::init()
+{
+    fatal_if(!port.isConnected(), "%s: port is not connected\n", name());
+}
+
+void
+PUMTracePlayer::startup()
+{
+    startTick = curTick();
+    traceDone = !readElement(next);
+    if (!traceDone)
+        firstTick = next.tick;
+
+    sendRequests();
+}
+
+bool
+PUMTracePlayer::readElement(Element &elem)
+{
+    ProtoMessage::Packet pkt_msg;
+    if (!trace.read(pkt_msg))
+        return false;
+
+    elem.tick = pkt_msg.tick();
+    elem.cmd = MemCmd(pkt_msg.cmd());
+    elem.addr = pkt_msg.addr();
+    elem.size = pkt_msg.size();
+
+    // the trace only holds the lower half of the request flags, put
+    // back the PUM and MAJ flags the command implies
+    elem.flags = pkt_msg.has_flags() ? pkt_msg.flags() : 0;
+    if (elem.cmd.isPUM())
+        elem.flags |= Request::PUM;
+    if (elem.cmd.isMAJ())
+        elem.flags |= Request::MAJ;
+    fatal_if(elem.cmd.isPUMBatch(), "%s: cannot replay the batched PUM op "
+             "at %#x, record its targets instead\n", name(), elem.addr);
+
+    auto it = requestorIds.find(pkt_msg.pkt_id());
+    if (it == requestorIds.end()) {
+        // not named in the header, replay it as the player itself
+        it = requestorIds.emplace(pkt_msg.pkt_id(),
+                                  system->getRequestorId(this)).first;
+    }
+    elem.id = it->second;
+
+    return true;
+}
+
+PacketPtr
+PUMTracePlayer::makePacket(const Element &elem)
+{
+    RequestPtr req = Request::create(elem.addr, elem.size, elem.flags,
+                                     elem.id);
+    PacketPtr pkt = new Packet(req, elem.cmd);
+    // the trace has no data, writes carry zeros
+    pkt->dataDynamic(new uint8_t[elem.size]());
+    return pkt;
+}
+
+bool
+PUMTracePlayer::trySend(PacketPtr pkt)
+{
+    const bool needs_response = pkt->needsResponse();
+    const RequestPtr req = pkt->req;
+    const MemCmd cmd = pkt->cmd;
+
+    DPRINTF(PUMTracePlayer, "Sending %s\n", pkt->print());
+
+    if (!port.sendTimingReq(pkt)) {
+        ++stats.numRetries;
+        return false;
+    }
+
+    if (needs_response) {
+        sendTicks[req] = curTick();
+        ++outstanding;
+    }
+
+    if (cmd.isPUM())
+        ++stats.numPUMs;
+    else if (cmd.isMAJ())
+        ++stats.numMAJs;
+    else if (cmd.isWrite())
+        ++stats.numWrites;
+    else
+        ++stats.numReads;
+
+    return true;
+}
+
+void
+PUMTracePlayer::sendRequests()
+{
+    while (!retryPkt && !traceDone && outstanding < maxOutstanding &&
+           startTick + (next.tick - firstTick) <= curTick()) {
+        PacketPtr pkt = makePacket(next);
+        traceDone = !readElement(next);
+        if (!trySend(pkt))
+            retryPkt = pkt;
+    }
+
+    scheduleNext();
+    checkDone();
+}
+
+void
+PUMTracePlayer::scheduleNext()
+{
+    // a refused request or a full window is resolved by the memory
+    if (traceDone || retryPkt || outstanding >= maxOutstanding ||
+        sendEvent.scheduled()) {
+        return;
+    }
+
+    schedule(sendEvent,
+             std::max(curTick(), startTick + (next.tick - firstTick)));
+}
+
+bool
+PUMTracePlayer::recvTimingResp(PacketPtr pkt)
+{
+    auto it = sendTicks.find(pkt->req);
+    panic_if(it == sendTicks.end(), "%s: unexpected response %s\n",
+             name(), pkt->print());
+
+    stats.totalLatency += curTick() - it->second;
+    ++stats.numResponses;
+    sendTicks.erase(it);
+    --outstanding;
+
+    delete pkt;
+
+    sendRequests();
+    return true;
+}
+
+void
+PUMTracePlayer::recvReqRetry()
+{
+    assert(retryPkt);
+    if (!trySend(retryPkt))
+        return;
+
+    retryPkt = nullptr;
+    sendRequests();
+}
+
+void
+PUMTracePlayer::checkDone()
+{
+    if (traceDone && !retryPkt && outstanding == 0)
+        exitSimLoop(name() + " replayed the whole trace");
+}
+
+PUMTracePlayer::PUMTracePlayerStats::PUMTracePlayerStats(
+    statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(numReads, statistics::units::Count::get(),
+               "Number of reads sent"),
+      ADD_STAT(numWrites, statistics::units::Count::get(),
+               "Number of writes sent"),
+      ADD_STAT(numPUMs, statistics::units::Count::get(),
+               "Number of PUM ops sent"),
+      ADD_STAT(numMAJs, statistics::units::Count::get(),
+               "Number of MAJ ops sent"),
+      ADD_STAT(numRetries, statistics::units::Count::get(),
+               "Number of requests refused by the memory"),
+      ADD_STAT(totalLatency, statistics::units::Tick::get(),
+               "Total latency of the answered requests"),
+      ADD_STAT(numResponses, statistics::units::Count::get(),
+               "Number of responses received"),
+      ADD_STAT(avgLatency, statistics::units::Rate<
+                    statistics::units::Tick, statistics::units::Count>::get(),
+               "Average latency of the answered requests")
+{
+    avgLatency = totalLatency / numResponses;
+}
+
+} // namespace gem5
@@ -0,0 +1,166 @@
+#ifndef __CPU_TESTERS_PUM_TRACE_PLAYER_PUM_TRACE_PLAYER_HH__
+#define __CPU_TESTERS_PUM_TRACE_PLAYER_PUM_TRACE_PLAYER_HH__
+
+#include <unordered_map>
+
+#include "base/statistics.hh"
+#include "mem/packet.hh"
+#include "mem/port.hh"
+#include "params/PUMTracePlayer.hh"
+#include "proto/protoio.hh"
+#include "sim/clocked_object.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+class System;
+
+/**
+ * Replays a packet trace of the requests seen by a memory, such as the
+ * trace a MemTraceProbe records from the PktRequest probe point of a
+ * Ramulator2 controller. This drives the same memory configuration
+ * with the reads, writes and PUM/MAJ ops of a workload without
+ * simulating the CPUs that generated them, which makes sweeps over
+ * the DRAM scheduler and timing parameters much faster.
+ *
+ * Requests are sent at their recorded tick, relative to the first
+ * request of the trace, or as soon as the memory takes them when it
+ * falls behind. Every requestor of the trace is replayed by a
+ * requestor of its own, named after the recorded one, so the memory
+ * still tells the sources apart. The simulation exits once every
+ * request has been answered.
+ *
+ * The trace holds no data, so the replay is timing only. Writes carry
+ * zeros and reads are not checked. The memory should be null, which
+ * skips the functional accesses and PUM/MAJ ops rather than running
+ * them on zeros; their timing does not depend on the data.
+ */
+class PUMTracePlayer : public ClockedObject
+{
+  public:
+
+    PARAMS(PUMTracePlayer);
+    PUMTracePlayer(const Params &p);
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+    void init() override;
+    void startup() override;
+
+  private:
+
+    class PlayerPort : public RequestPort
+    {
+        PUMTracePlayer &player;
+
+      public:
+
+        PlayerPort(const std::string &_name, PUMTracePlayer &_player)
+            : RequestPort(_name), player(_player)
+        { }
+
+      protected:
+
+        bool
+        recvTimingResp(PacketPtr pkt) override
+        {
+            return player.recvTimingResp(pkt);
+        }
+
+        void recvReqRetry() override { player.recvReqRetry(); }
+    };
+
+    /** A request of the trace */
+    struct Element
+    {
+        Tick tick;
+        MemCmd cmd;
+        Addr addr;
+        unsigned size;
+        Request::FlagsType flags;
+        RequestorID id;
+    };
+
+    PlayerPort port;
+
+    ProtoInputStream trace;
+
+    System *system;
+
+    const unsigned maxOutstanding;
+
+    /** Requestor of this player for each requestor of the trace */
+    std::unordered_map<uint32_t, RequestorID> requestorIds;
+
+    /** The next request to send, valid unless the trace is done */
+    Element next;
+
+    /** True once every request of the trace has been read */
+    bool traceDone;
+
+    /** Tick of the first request of the trace */
+    Tick firstTick;
+
+    /** Tick the replay started at */
+    Tick startTick;
+
+    /** Request refused by the memory, to send again on a retry */
+    PacketPtr retryPkt;
+
+    /** Requests sent and waiting for a response */
+    unsigned outstanding;
+
+    /** Send time of the requests waiting for a response */
+    std::unordered_map<RequestPtr, Tick> sendTicks;
+
+    /**
+     * Read the next request of the trace.
+     *
+     * @return false at the end of the trace
+     */
+    bool readElement(Element &elem);
+
+    /** Create the packet of a request of the trace */
+    PacketPtr makePacket(const Element &elem);
+
+    /**
+     * Send a request to the memory and account for it.
+     *
+     * @return false if the memory refused it
+     */
+    bool trySend(PacketPtr pkt);
+
+    /** Send the requests that are due, as far as the memory allows */
+    void sendRequests();
+
+    EventFunctionWrapper sendEvent;
+
+    /** Schedule sendEvent for the next request, if it can be sent */
+    void scheduleNext();
+
+    bool recvTimingResp(PacketPtr pkt);
+    void recvReqRetry();
+
+    /** Exit the simulation once all requests are answered */
+    void checkDone();
+
+    struct PUMTracePlayerStats : public statistics::Group
+    {
+        PUMTracePlayerStats(statistics::Group *parent);
+
+        statistics::Scalar numReads;
+        statistics::Scalar numWrites;
+        statistics::Scalar numPUMs;
+        statistics::Scalar numMAJs;
+        statistics::Scalar numRetries;
+        statistics::Scalar totalLatency;
+        statistics::Scalar numResponses;
+        statistics::Formula avgLatency;
+    } stats;
+};
+
+} // namespace gem5
+
+#endif // __CPU_TESTERS_PUM_TRACE_PLAYER_PUM_TRACE_PLAYER_HH__
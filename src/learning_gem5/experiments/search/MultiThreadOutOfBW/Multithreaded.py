@@ -5,7 +5,9 @@ from m5.objects import (
     DerivO3CPU,
     L2XBar,
     LocalBP,
+    MemTraceProbe,
     Process,
+    PUMGeometry,
     Ramulator2,
     Root,
     SEWorkload,
@@ -91,8 +93,20 @@ mmio_range = AddrRange(MMIO_BASE, size=MMIO_SIZE)
 for i in range(NCORES):
     system.cpu[i].icache_port = system.icaches[i].cpu_side
 
+# PUM/MAJ ops and uncacheable MMIO accesses take the direct lane of the
+# crossbars, skipping the snoop filters and the layer arbitration
+system.membus.direct_ranges = [mmio_range]
+
 # ---------- D-side: splitter + two Bridges ----------
-system.dsplit = [SystemXBar(width=64) for _ in range(NCORES)]
+# The O3 CPU has a single data port and the L1D only carries reads and
+# writes, not PUM/MAJ commands, so the PUM traffic is split off in front
+# of it. The bridges only accept their own range, which keeps the ranges
+# of the splitter's ports from overlapping. Carrying PUM commands through
+# the caches is out of scope, the direct lanes of the splitter and the
+# membus are what keeps the PUM path short.
+system.dsplit = [
+    SystemXBar(width=64, direct_ranges=[mmio_range]) for _ in range(NCORES)
+]
 for i in range(NCORES):
     system.cpu[i].dcache_port = system.dsplit[i].cpu_side_ports
 
@@ -101,8 +115,11 @@ system.to_l1d = [
 ]
 MMIO_FWD_NS = 6
 
+# The forwarding delay of the MMIO path is charged by the MMIO controller
+# as its static frontend/backend latency instead of here, which lets it
+# simulate several DRAM cycles per tick event.
 system.bypass_mmio = [
-    Bridge(delay=f"{MMIO_FWD_NS}ns", ranges=[mmio_range])  # <- only hits MMIO addrs
+    Bridge(delay="0ns", ranges=[mmio_range])  # <- only hits MMIO addrs
     for _ in range(NCORES)
 ]
 
@@ -160,31 +177,40 @@ CHANNELS_MMIO = (
     2
 )
 
-mmio_total_bytes = toMemorySize(MMIO_SIZE)
-slice_bytes = mmio_total_bytes // CHANNELS_MMIO
-
-mmio_slices = []
-mmio_chans = []
-for ch in range(CHANNELS_MMIO):
-    start = MMIO_BASE + ch * slice_bytes
-    stripe = AddrRange(start, size=slice_bytes)
-    mmio_slices.append(stripe)
+# One geometry drives the functional PUM model and the Ramulator2 command
+# selection. It has to match the subarray layout the workload assumes.
+system.pum_geometry = PUMGeometry(
+    rows_per_subarray=1024,
+    row_bits=512,
+)
 
-    ram = Ramulator2(
-        config_path="ext/ramulator2/ramulator2/gem5_pum_ram.yaml",
-        output_dir=f"ramulator_mmio_ch{ch}_out",
+# A single controller owns all MMIO channels, splits the window into one
+# contiguous slice per channel and ticks the channels in parallel.
+system.ram_mmio = Ramulator2(
+    config_path="ext/ramulator2/ramulator2/gem5_pum_ram.yaml",
+    output_dir="ramulator_mmio_out",
+    channels=CHANNELS_MMIO,
+    tick_threads=CHANNELS_MMIO,
+    static_frontend_latency=f"{MMIO_FWD_NS}ns",
+    static_backend_latency=f"{MMIO_FWD_NS}ns",
+)
+system.ram_mmio.range = mmio_range
+system.ram_mmio.null = False
+system.ram_mmio.pum_geometry = system.pum_geometry
+
+# Set to a file name to record every read, write and PUM/MAJ op the MMIO
+# controller receives. replay_pum_trace.py drives the same controller
+# from the trace without simulating the cores.
+PUM_TRACE_FILE = None  # e.g. "pum_mmio.trc.gz"
+if PUM_TRACE_FILE:
+    system.pum_trace = MemTraceProbe(
+        manager=system.ram_mmio,
+        probe_name="PktRequest",
+        trace_file=PUM_TRACE_FILE,
     )
-    ram.range = stripe
-    ram.null = False
-    mmio_chans.append(ram)
 
-for i, ram in enumerate(mmio_chans):
-    setattr(system, f"ram_mmio_ch{i}", ram)
-
-# Connect all memory controllers to membus (main + all mmio channels)
-system.membus.mem_side_ports = [system.ram_main.port] + [
-    r.port for r in mmio_chans
-]
+# Connect all memory controllers to membus (main + mmio)
+system.membus.mem_side_ports = [system.ram_main.port, system.ram_mmio.port]
 # publish memory ranges (logical view). Keeping the contiguous MMIO window is fine.
 system.mem_ranges = [main_range, mmio_range]
 
@@ -210,6 +236,31 @@ for cpu in system.cpu:
 # --------- instantiate first, then map ---------
 root = Root(full_system=False, system=system)
 
+# Run every core with its L1s and D-side splitter on a host thread of its
+# own, the L2, the crossbars and the memories stay on the main thread.
+# Packets crossing between threads take CROSSING_LATENCY longer, and the
+# threads synchronise every CROSSING_LATENCY of simulated time.
+PARTITION_EVENT_QUEUES = False
+CROSSING_LATENCY = "1ns"
+if PARTITION_EVENT_QUEUES:
+    from gem5.utils.eventq_partition import partition_event_queues
+
+    partition_event_queues(
+        root,
+        [
+            [
+                system.cpu[i],
+                system.icaches[i],
+                system.dcaches[i],
+                system.dsplit[i],
+                system.to_l1d[i],
+                system.bypass_mmio[i],
+            ]
+            for i in range(NCORES)
+        ],
+        crossing_latency=CROSSING_LATENCY,
+    )
+
 import m5
 
 m5.instantiate()
@@ -94,34 +94,59 @@ static inline void majority(uintptr_t target_addr){
     asm volatile("xor %%rax, %%rax" ::: "rax");
 }
 
+/* Batched PuM op: the op on count targets stride bytes apart, starting
+ * at target_addr, in a single instruction (0x1d takes rcx/rdx). The
+ * target_addr must be 16 byte aligned, else the op raises #GP */
+static inline void rowclone_batch(uintptr_t target_addr, uint64_t stride,
+                                  uint64_t count){
+    asm volatile(
+        "mov %0, %%rax\n\t"
+        "mov %1, %%rdx\n\t"
+        "mov %2, %%rcx\n\t"
+        ".byte 0x1d, 0x28\n\t"
+        :: "r"(target_addr), "r"(stride), "r"(count)
+        : "rax", "eax", "rcx", "rdx", "memory"
+    );
+    asm volatile("xor %%rax, %%rax" ::: "rax");
+}
+
 /* LUT identifiers used in this variant */
 enum { ANDOutB1C0 = 0, OROutB1C1 = 1 };
 
-/* One PuM compare for a given subarray; called per (bank, step) */
+/* One PuM compare on the same subarray of banks banks, bank_stride bytes
+ * apart; called per step. The row copies of all banks are batched, the
+ * majority ops go through the LUT of each bank, whose identifiers are
+ * NUM_WORKERS apart in subarray_identifier */
 static inline void
-pum_similarity_check(uint64_t subarray_addr, const lut_t *L, uint64_t subarray_identifier)
+pum_similarity_check(uint64_t subarray_addr, uint64_t bank_stride,
+                     uint64_t banks, const lut_t *L,
+                     const uint64_t *subarray_identifier)
 {
     for (int i = 0; i < (int)data_size; i++){
         /* Copy 0/1 row */
-        rowclone(subarray_addr);
-        rowclone(subarray_addr);
+        rowclone_batch(subarray_addr, bank_stride, banks);
+        rowclone_batch(subarray_addr, bank_stride, banks);
 
         /* Copy Di row */
-        rowclone(subarray_addr);
-        rowclone(subarray_addr);
+        rowclone_batch(subarray_addr, bank_stride, banks);
+        rowclone_batch(subarray_addr, bank_stride, banks);
+
+        for (uint64_t k = 0; k < banks; ++k) {
+            const uint64_t id = subarray_identifier[k * NUM_WORKERS];
 
-        /* Choose AND vs OR half/half */
-        addrpair_t APA = (i < (int)(data_size/2))
-                         ? lut_lookup(L, subarray_identifier, ANDOutB1C0)
-                         : lut_lookup(L, subarray_identifier, OROutB1C1);
+            /* Choose AND vs OR half/half */
+            addrpair_t APA = (i < (int)(data_size/2))
+                             ? lut_lookup(L, id, ANDOutB1C0)
+                             : lut_lookup(L, id, OROutB1C1);
 
-        majority(APA.a);
-        majority(APA.b);
+            majority(APA.a);
+            majority(APA.b);
+        }
 
         /* Seed Out rows on first items of each half */
         if (i == 0 || i == (int)(data_size/2)) {
-            rowclone(subarray_addr);
-            rowclone(subarray_addr);
+            rowclone_batch(subarray_addr, bank_stride, banks);
+            rowclone_batch(subarray_addr, bank_stride, banks);
         }
     }
 }
@@ -149,27 +174,34 @@ typedef struct {
     uint64_t         stride_bytes;
     uint64_t         steps_per_subarray;
     uint64_t         total_banks;
+    uint64_t         bank_stride;         // bytes between the banks of a worker
 } worker_arg_t;
 
 static void* worker_main(void *vp)
 {
     worker_arg_t *wa = (worker_arg_t*)vp;
+    const uint64_t tid = (uint64_t)wa->tid;
+    if (tid >= wa->total_banks)
+        return NULL;
+
+    // This worker handles banks: tid, tid+NUM_WORKERS, tid+2*NUM_WORKERS, ...
+    const uint64_t banks = (wa->total_banks - tid + NUM_WORKERS - 1) / NUM_WORKERS;
 
     for (uint64_t step = 0; step < wa->steps; ++step) {
         const uint64_t off = step * wa->stride_bytes;
         const bool at_boundary = (wa->steps_per_subarray != 0)
                                && ((step % wa->steps_per_subarray) == 0);
 
-        // This worker handles banks: tid, tid+NUM_WORKERS, tid+2*NUM_WORKERS, ...
-        for (uint64_t b = (uint64_t)wa->tid; b < wa->total_banks; b += (uint64_t)NUM_WORKERS) {
-            const uint64_t addr = wa->bank_base0[b] + off;
-
+        for (uint64_t b = tid; b < wa->total_banks; b += (uint64_t)NUM_WORKERS) {
             if (at_boundary)
-                wa->sub_id[b] = addr;  // update this bank's current subarray base
-
-            pum_similarity_check(addr, wa->L, wa->sub_id[b]);
-            (void)a1_b0_any((volatile const uint8_t*)(uintptr_t)addr);
+                wa->sub_id[b] = wa->bank_base0[b] + off;  // update this bank's current subarray base
         }
+
+        pum_similarity_check(wa->bank_base0[tid] + off, wa->bank_stride,
+                             banks, wa->L, wa->sub_id + tid);
+
+        for (uint64_t b = tid; b < wa->total_banks; b += (uint64_t)NUM_WORKERS)
+            (void)a1_b0_any((volatile const uint8_t*)(uintptr_t)(wa->bank_base0[b] + off));
     }
     return NULL;
 }
@@ -204,6 +236,16 @@ uint64_t parallel_access(const lut_t *L)
         bank_base0[b] = base_ch[ch] + bank_off_in_ch[rem];
     }
 
+    /* The banks of a worker are NUM_WORKERS banks apart, which the batched
+     * ops need to be the same number of bytes everywhere */
+    const uint64_t bank_stride = (uint64_t)NUM_WORKERS * bank_region_bytes;
+    for (uint64_t b = 0; b + NUM_WORKERS < total_banks; ++b) {
+        if (bank_base0[b + NUM_WORKERS] - bank_base0[b] != bank_stride) {
+            fprintf(stderr, "banks are not evenly spaced\n");
+            abort();
+        }
+    }
+
     /* Step limits */
     const uint64_t stride_bytes       = STRIDE_BYTES;                     // 4 KiB
     const uint64_t max_steps_per_bank = bank_region_bytes / stride_bytes; // 512 MiB / 4 KiB
@@ -232,6 +274,7 @@ uint64_t parallel_access(const lut_t *L)
         args[t].stride_bytes      = stride_bytes;
         args[t].steps_per_subarray= steps_per_subarray;
         args[t].total_banks       = total_banks;
+        args[t].bank_stride       = bank_stride;
         if (pthread_create(&thr[t], NULL, worker_main, &args[t]) != 0) {
             perror("pthread_create");
             abort();
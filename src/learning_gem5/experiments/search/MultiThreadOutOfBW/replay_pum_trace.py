@@ -0,0 +1,79 @@
+"""Replay a trace recorded by Multithreaded.py on the MMIO controller.
+
+Only the MMIO Ramulator2 controller is simulated, driven by a
+PUMTracePlayer, so DRAM scheduler and timing sweeps run at the speed of
+the memory model. The trace holds no data, so the replay is timing only
+and the controller has no backing store. Keep the controller and geometry below in sync with
+Multithreaded.py, except for the parameters being swept.
+
+    gem5.opt replay_pum_trace.py m5out/pum_mmio.trc.gz [--config X.yaml]
+"""
+
+import argparse
+
+import m5
+from m5.objects import (
+    AddrRange,
+    PUMGeometry,
+    PUMTracePlayer,
+    Ramulator2,
+    Root,
+    SrcClockDomain,
+    System,
+    VoltageDomain,
+)
+
+parser = argparse.ArgumentParser()
+parser.add_argument("trace", help="trace recorded by Multithreaded.py")
+parser.add_argument(
+    "--config",
+    default="ext/ramulator2/ramulator2/gem5_pum_ram.yaml",
+    help="Ramulator2 config of the MMIO controller",
+)
+parser.add_argument("--channels", type=int, default=2)
+parser.add_argument("--max-outstanding", type=int, default=128)
+args = parser.parse_args()
+
+MMIO_BASE = 0x2_0000_0000
+MMIO_SIZE = "16GiB"
+MMIO_FWD_NS = 6
+
+system = System()
+system.mem_mode = "timing"
+system.clk_domain = SrcClockDomain(
+    clock="3GHz", voltage_domain=VoltageDomain()
+)
+
+mmio_range = AddrRange(MMIO_BASE, size=MMIO_SIZE)
+system.mem_ranges = [mmio_range]
+
+system.pum_geometry = PUMGeometry(
+    rows_per_subarray=1024,
+    row_bits=512,
+)
+
+system.ram_mmio = Ramulator2(
+    config_path=args.config,
+    output_dir="ramulator_mmio_out",
+    channels=args.channels,
+    tick_threads=args.channels,
+    static_frontend_latency=f"{MMIO_FWD_NS}ns",
+    static_backend_latency=f"{MMIO_FWD_NS}ns",
+)
+system.ram_mmio.range = mmio_range
+# Without data in the trace the functional accesses and PUM/MAJ ops would
+# only run on zeros, so skip them
+system.ram_mmio.null = True
+system.ram_mmio.pum_geometry = system.pum_geometry
+
+system.player = PUMTracePlayer(
+    trace_file=args.trace, max_outstanding=args.max_outstanding
+)
+system.player.port = system.ram_mmio.port
+
+root = Root(full_system=False, system=system)
+m5.instantiate()
+
+print("Beginning replay!")
+event = m5.simulate()
+print(f"Exiting @ tick {m5.curTick()} because {event.getCause()}")
@@ -77,6 +77,12 @@ class AbstractMemory(ClockedObject):
 
     writeable = Param.Bool(True, "Allow writes to this memory")
 
+    # Subarray organisation used to functionally perform PUM and MAJ
+    # operations. Without one they are accepted but leave the data as is.
+    pum_geometry = Param.PUMGeometry(
+        NULL, "Subarray geometry of the PUM operations"
+    )
+
     collect_stats = Param.Bool(
         True,
         "Collect statistics per requestor for "
@@ -166,6 +166,15 @@ class DRAMInterface(MemInterface):
     tXAW = Param.Latency("X activation window")
     activation_limit = Param.Unsigned("Max number of activates in window")
 
+    # PUM and MAJ ops are performed in the DRAM array, on a precharged
+    # bank that is precharged again afterwards
+    # RowClone (AAP) activates the source row, then the destination row
+    # once the source is sensed, then precharges, 0 uses tRCD + tRAS
+    tAAP = Param.Latency("0ns", "ACT to PRE delay of a RowClone")
+    # MAJ is a triple row activation (TRA) of the three MAJ rows, 0 uses
+    # tRAS
+    tTRA = Param.Latency("0ns", "ACT to PRE delay of a triple row activation")
+
     # time to exit power-down mode
     # Exit power-down to next valid command delay
     tXP = Param.Latency("0ns", "Power-up Delay")
@@ -0,0 +1,28 @@
+from m5.params import *
+from m5.SimObject import SimObject
+
+
+class PUMGeometry(SimObject):
+    type = "PUMGeometry"
+    cxx_header = "mem/pum_geometry.hh"
+    cxx_class = "gem5::memory::PUMGeometry"
+
+    rows_per_subarray = Param.Unsigned(1024, "Number of rows in a subarray")
+    row_bits = Param.Unsigned(512, "Number of bit cells (columns) in a row")
+
+    # Reserved rows, relative to the start of every subarray
+    zero_row = Param.Unsigned(0, "Row holding constant 0s")
+    one_row = Param.Unsigned(1, "Row holding constant 1s")
+    compare_row = Param.Unsigned(2, "Row holding the compare input")
+    maj_rows = VectorParam.Unsigned(
+        [3, 4, 5], "The three rows used as triple row activation inputs"
+    )
+
+    # Every bit of a row is a bit cell, so a row takes row_bits / 8 bytes
+    # and MAJ computes the majority of each bit
+    check_maj_inputs = Param.Bool(
+        False,
+        "Check that the MAJ rows hold a single 0/1 value per byte, for "
+        "workloads that only use the lowest cell of each byte (not done "
+        "in fast builds)",
+    )
@@ -14,3 +14,46 @@ class Ramulator2(AbstractMemory):
 
     config_path = Param.String("", "--ramulator-config")
     output_dir = Param.String("", "--outdir")
+
+    skip_idle_cycles = Param.Bool(
+        True,
+        "Stop ticking while Ramulator2 has no requests in flight and "
+        "fast-forward the skipped DRAM cycles on the next request",
+    )
+
+    max_outstanding = Param.Unsigned(
+        1024,
+        "Number of requests that can be in flight in Ramulator2 at once, "
+        "further requests are refused until one completes",
+    )
+
+    channels = Param.Unsigned(
+        1,
+        "Number of channels, each a Ramulator2 memory system of its own "
+        "created from config_path, which should describe one channel",
+    )
+    channel_interleave = Param.MemorySize(
+        "0",
+        "Channel interleaving granularity, 0 splits the range into "
+        "contiguous slices, one per channel. Either way, with a "
+        "pum_geometry the channels must hold whole subarrays",
+    )
+    tick_threads = Param.Unsigned(
+        1,
+        "Number of host threads ticking the channels, including the "
+        "simulation thread, the results do not depend on it",
+    )
+
+    static_frontend_latency = Param.Latency(
+        "0ns",
+        "Static latency before a request reaches Ramulator2, e.g. of a "
+        "bridge in front of the controller",
+    )
+    static_backend_latency = Param.Latency(
+        "0ns", "Static latency added to every response"
+    )
+    tick_batching = Param.Bool(
+        True,
+        "Simulate as many DRAM cycles per tick event as fit in the static "
+        "frontend latency, with no effect on the results",
+    )
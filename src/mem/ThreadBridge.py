@@ -24,6 +24,7 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 from m5.params import *
+from m5.proxy import *
 from m5.SimObject import SimObject
 
 
@@ -39,8 +40,12 @@ class ThreadBridge(SimObject):
     the issue. The receiver side is expected to use the same EventQueue that
     the ThreadBridge is using.
 
-    Given that this is only used for simulation speed accelerating, only the
-    atomic and functional access are supported.
+    Atomic and functional accesses, and snoops, are made right away with the
+    EventQueue migrated. Timing requests, responses and snoop responses are
+    handed over to the queue of the other side instead, and arrive there
+    `delay` later. The delay has to be at least the simulation quantum, so
+    that they never arrive in the past of the other side. The EventQueue
+    of the requestor side is `in_eventq_index`.
 
     Example:
 
@@ -58,3 +63,8 @@ class ThreadBridge(SimObject):
 
     in_port = ResponsePort("Incoming port")
     out_port = RequestPort("Outgoing port")
+
+    in_eventq_index = Param.UInt32(
+        Parent.eventq_index, "Event queue of the requestor side"
+    )
+    delay = Param.Latency("0ns", "Latency of timing packets crossing over")
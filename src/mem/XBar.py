@@ -139,6 +139,12 @@ class CoherentXBar(BaseXBar):
 
     system = Param.System(Parent.any, "System that the crossbar belongs to.")
 
+    # PUM and MAJ ops, and uncacheable requests to these ranges, are
+    # never snooped and bypass the layers, see CoherentXBar::isDirect
+    direct_ranges = VectorParam.AddrRange(
+        [], "Ranges whose uncacheable requests take the direct lane"
+    )
+
 
 class SnoopFilter(SimObject):
     type = "SnoopFilter"
@@ -151,9 +157,18 @@ class SnoopFilter(SimObject):
 
     system = Param.System(Parent.any, "System that the crossbar belongs to.")
 
-    # Sanity check on max capacity to track, adjust if needed.
+    # Sanity check on max capacity to track, adjust if needed. This also
+    # sizes the preallocated line table, so it should cover the capacity
+    # of the caches above.
     max_capacity = Param.MemorySize("8MiB", "Maximum capacity of snoop filter")
 
+    # With a non-zero associativity the snoop filter is finite: it drops
+    # the least recently used line of a full set and back-invalidates it
+    # in the caches holding it.
+    assoc = Param.Unsigned(
+        0, "Associativity of a finite snoop filter, 0 for unbounded"
+    )
+
 
 # We use a coherent crossbar to connect multiple requestors to the L2
 # caches. Normally this crossbar would be part of the cache itself.
@@ -48,6 +48,7 @@
 #include "debug/LLSC.hh"
 #include "debug/MemoryAccess.hh"
 #include "mem/packet_access.hh"
+#include "mem/pum_geometry.hh"
 #include "sim/system.hh"
 
 namespace gem5
@@ -64,11 +65,14 @@ AbstractMemory::AbstractMemory(const Params &p) :
                  MemBackdoor::Readable)),
     confTableReported(p.conf_table_reported), inAddrMap(p.in_addr_map),
     kvmMap(p.kvm_map), writeable(p.writeable), collectStats(p.collect_stats),
-    _system(NULL), stats(*this)
+    pumGeometry(p.pum_geometry), _system(NULL), stats(*this)
 {
     panic_if(!range.valid() || !range.size(),
              "Memory range %s must be valid with non-zero size.",
              range.to_string());
+
+    if (pumGeometry)
+        pumGeometry->checkRange(range);
 }
 
 void
@@ -476,10 +480,10 @@ AbstractMemory::access(PacketPtr pkt)
                 stats.bytesWritten[pkt->req->requestorId()] += pkt->getSize();
             }
         }
-    } else if (pkt->isPUM()) {
-        pkt->setPUM(host_addr);
-    } else if (pkt->isMAJ()) {
-        pkt->setPUM(host_addr);
+    } else if (pkt->isPUM() || pkt->isMAJ()) {
+        if (pmemAddr && pumGeometry) {
+            pumGeometry->execute(*pkt, range, toHostAddr(range.start()));
+        }
     }
     else {
         panic("Unexpected packet %s", pkt->print());
@@ -60,6 +60,8 @@ class System;
 namespace memory
 {
 
+class PUMGeometry;
+
 /**
  * Locked address class that represents a physical address and a
  * context id.
@@ -135,6 +137,9 @@ class AbstractMemory : public ClockedObject
     // Should collect traffic statistics
     const bool collectStats;
 
+    // Subarray geometry for PUM operations, may be null
+    const PUMGeometry *pumGeometry;
+
     std::list<LockedAddr> lockedAddrList;
 
     // helper function for checkLockedAddrs(): we really want to
@@ -1257,6 +1257,37 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
 }
 
 
+PacketPtr
+Cache::writecleanWriteback(PacketPtr wb_pkt, Request::Flags dest,
+                           PacketId id)
+{
+    RequestPtr req = std::make_shared<Request>(
+        wb_pkt->getAddr(), blkSize, 0, Request::wbRequestorId);
+
+    if (wb_pkt->isSecure()) {
+        req->setFlags(Request::SECURE);
+    }
+    req->taskId(wb_pkt->req->taskId());
+
+    PacketPtr pkt = new Packet(req, MemCmd::WriteClean, blkSize, id);
+
+    if (dest) {
+        req->setFlags(dest);
+        pkt->setWriteThrough();
+    }
+
+    if (wb_pkt->hasSharers()) {
+        pkt->setHasSharers();
+    }
+
+    pkt->allocate();
+    pkt->setData(wb_pkt->getConstPtr<uint8_t>());
+
+    DPRINTF(Cache, "Create %s from %s\n", pkt->print(), wb_pkt->print());
+
+    return pkt;
+}
+
 void
 Cache::recvTimingSnoopReq(PacketPtr pkt)
 {
@@ -1331,9 +1362,10 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
         // this cache, so the behaviour is modelled after handleSnoop,
         // the difference being that instead of querying the block
         // state to determine if it is dirty and writable, we use the
-        // command and fields of the writeback packet
+        // command and fields of the writeback packet. Cache clean
+        // requests are not responded to, see below
         bool respond = wb_pkt->cmd == MemCmd::WritebackDirty &&
-            pkt->needsResponse();
+            pkt->needsResponse() && !pkt->isClean();
         bool have_writable = !wb_pkt->hasSharers();
         bool invalidate = pkt->isInvalidate();
 
@@ -1354,7 +1386,19 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
                                    false, false);
         }
 
-        if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
+        if (pkt->isClean() && wb_pkt->cmd == MemCmd::WritebackDirty) {
+            // As for a dirty block, write the dirty data back as a
+            // WriteClean that the cache clean request waits for
+            PacketList writebacks;
+            writebacks.push_back(writecleanWriteback(wb_pkt,
+                pkt->req->getDest(), pkt->id));
+            markInService(wb_entry);
+            delete wb_pkt;
+
+            doWritebacks(writebacks,
+                         clockEdge(forwardLatency) + pkt->headerDelay);
+            pkt->setSatisfied();
+        } else if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
             // Invalidation trumps our writeback... discard here
             // Note: markInService will remove entry from writeback buffer.
             markInService(wb_entry);
@@ -122,6 +122,18 @@ class Cache : public BaseCache
     void doTimingSupplyResponse(PacketPtr req_pkt, const uint8_t *blk_data,
                                 bool already_copied, bool pending_inval);
 
+    /**
+     * Create a WriteClean carrying the data of a pending writeback, the
+     * way writecleanBlk does for a block.
+     *
+     * @param wb_pkt The WritebackDirty in the write buffer
+     * @param dest The destination of the write clean operation
+     * @param id Use the given packet id for the write clean operation
+     * @return The generated write clean packet
+     */
+    PacketPtr writecleanWriteback(PacketPtr wb_pkt, Request::Flags dest,
+                                  PacketId id);
+
     /**
      * Perform an upward snoop if needed, and update the block state
      * (possibly invalidating the block). Also create a response if required.
@@ -82,8 +82,7 @@ CacheBlk*
 BaseTags::findBlock(const CacheBlk::KeyType &key) const
 {
     // Find possible entries that may contain the given address
-    const std::vector<ReplaceableEntry*> entries =
-        indexingPolicy->getPossibleEntries(key);
+    const EntrySpan entries = indexingPolicy->getPossibleEntrySpan(key);
 
     // Search for block
     for (const auto& location : entries) {
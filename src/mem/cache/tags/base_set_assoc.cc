@@ -69,6 +69,8 @@ BaseSetAssoc::BaseSetAssoc(const Params &p)
 void
 BaseSetAssoc::tagsInit()
 {
+    tagArray.resize(numBlocks);
+
     // Initialize all blocks
     for (unsigned blk_index = 0; blk_index < numBlocks; blk_index++) {
         // Locate next cache block
@@ -85,9 +87,37 @@ BaseSetAssoc::tagsInit()
 
         // This is not used as of now but we set it for security
         blk->registerTagExtractor(genTagExtractor(indexingPolicy));
+
+        // Mirror the tag of the block for lookups
+        blk->setTagSlot(tagArray.slot(blk_index));
     }
 }
 
+CacheBlk*
+BaseSetAssoc::findBlock(const CacheBlk::KeyType &key) const
+{
+    const EntrySpan entries = indexingPolicy->getPossibleEntrySpan(key);
+
+    if (entries.set() == EntrySpan::NoSet) {
+        // Skewed policies spread the entries over several sets
+        for (const auto& location : entries) {
+            CacheBlk* blk = static_cast<CacheBlk*>(location);
+            if (blk->match(key)) {
+                return blk;
+            }
+        }
+        return nullptr;
+    }
+
+    // The blocks of a set were given consecutive indices
+    const Addr word = TagArray::encode(
+        indexingPolicy->extractTag(key.address), key.secure);
+    const std::size_t way = tagArray.find(entries.set() * entries.size(),
+                                          entries.size(), word);
+    return way < entries.size() ? static_cast<CacheBlk*>(entries[way]) :
+                                  nullptr;
+}
+
 void
 BaseSetAssoc::invalidate(CacheBlk *blk)
 {
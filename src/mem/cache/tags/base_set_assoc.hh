@@ -60,6 +60,7 @@
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
 #include "mem/cache/tags/partitioning_policies/partition_manager.hh"
+#include "mem/cache/tags/tag_array.hh"
 #include "mem/packet.hh"
 #include "params/BaseSetAssoc.hh"
 
@@ -82,6 +83,9 @@ class BaseSetAssoc : public BaseTags
     /** The cache blocks. */
     std::vector<CacheBlk> blks;
 
+    /** The lookup state of the cache blocks, in the same order. */
+    TagArray tagArray;
+
     /** Whether tags and data are accessed sequentially. */
     const bool sequentialAccess;
 
@@ -115,6 +119,15 @@ class BaseSetAssoc : public BaseTags
      */
     void invalidate(CacheBlk *blk) override;
 
+    /**
+     * Finds the block in the cache without touching it. The tags of a set
+     * are compared straight from the tag array.
+     *
+     * @param key The key to find the block of.
+     * @return Pointer to the cache block.
+     */
+    CacheBlk *findBlock(const CacheBlk::KeyType &key) const override;
+
     /**
      * Access block and update replacement data. May not succeed, in which case
      * nullptr is returned. This has all the implications of a cache access and
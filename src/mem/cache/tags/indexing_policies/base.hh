@@ -47,6 +47,8 @@
 #ifndef __MEM_CACHE_INDEXING_POLICIES_BASE_HH__
 #define __MEM_CACHE_INDEXING_POLICIES_BASE_HH__
 
+#include <cstddef>
+#include <limits>
 #include <vector>
 
 #include "base/intmath.hh"
@@ -58,6 +60,41 @@
 namespace gem5
 {
 
+/**
+ * A view of the entries an indexing policy maps a key to. It does not own
+ * them: it points either into the set storage of the policy or into a
+ * buffer the policy reuses, so it is only valid until the next lookup.
+ */
+class EntrySpan
+{
+  public:
+    using iterator = ReplaceableEntry *const *;
+
+    /** The set of spans whose entries are spread over several sets. */
+    static constexpr uint32_t NoSet = std::numeric_limits<uint32_t>::max();
+
+    EntrySpan(iterator first, std::size_t size, uint32_t set=NoSet)
+      : _begin(first), _size(size), _set(set)
+    {}
+
+    iterator begin() const { return _begin; }
+    iterator end() const { return _begin + _size; }
+    std::size_t size() const { return _size; }
+    ReplaceableEntry *operator[](std::size_t i) const { return _begin[i]; }
+
+    /**
+     * Get the set holding all the entries, which are then in way order.
+     *
+     * @return The set, or NoSet if the entries are spread over several sets.
+     */
+    uint32_t set() const { return _set; }
+
+  private:
+    iterator _begin;
+    std::size_t _size;
+    uint32_t _set;
+};
+
 /**
  * A common base class for indexing table locations. Classes that inherit
  * from it determine hash functions that should be applied based on the set
@@ -96,15 +133,29 @@ class IndexingPolicyTemplate : public SimObject
     const unsigned setMask;
 
     /**
-     * The cache sets.
+     * The entries of all sets, contiguous and in set-major order, so the
+     * ways of a set can be handed out without copying them.
      */
-    std::vector<std::vector<ReplaceableEntry*>> sets;
+    std::vector<ReplaceableEntry*> entries;
 
     /**
      * The amount to shift the address to get the tag.
      */
     const int tagShift;
 
+    /**
+     * Get all ways of a set, straight from the set storage.
+     *
+     * @param set The set index.
+     * @return A view of the entries of the set.
+     */
+    EntrySpan
+    setEntries(const uint32_t set) const
+    {
+        assert(set < numSets);
+        return EntrySpan(&entries[set * assoc], assoc, set);
+    }
+
   public:
     /**
      * Construct and initialize this policy.
@@ -114,17 +165,13 @@ class IndexingPolicyTemplate : public SimObject
                            const uint32_t set_shift)
       : SimObject(p), assoc(p.assoc),
         numSets(num_entries / assoc),
-        setShift(set_shift), setMask(numSets - 1), sets(numSets),
+        setShift(set_shift), setMask(numSets - 1),
+        entries(numSets * assoc),
         tagShift(setShift + floorLog2(numSets))
     {
         fatal_if(!isPowerOf2(numSets),
             "# of sets must be non-zero and a power of 2");
         fatal_if(assoc <= 0, "associativity must be greater than zero");
-
-        // Make space for the entries
-        for (uint32_t i = 0; i < numSets; ++i) {
-            sets[i].resize(assoc);
-        }
     }
 
     /**
@@ -150,7 +197,7 @@ class IndexingPolicyTemplate : public SimObject
         assert(set < numSets);
 
         // Assign a free pointer
-        sets[set][way] = entry;
+        entries[index] = entry;
 
         // Inform the entry its position
         entry->setPosition(set, way);
@@ -167,7 +214,7 @@ class IndexingPolicyTemplate : public SimObject
     ReplaceableEntry*
     getEntry(const uint32_t set, const uint32_t way) const
     {
-        return sets[set][way];
+        return entries[set * assoc + way];
     }
 
     /**
@@ -191,8 +238,22 @@ class IndexingPolicyTemplate : public SimObject
      * @param addr The addr to a find possible entries for.
      * @return The possible entries.
      */
-    virtual std::vector<ReplaceableEntry*> getPossibleEntries(const KeyType &key)
-                                                                    const = 0;
+    std::vector<ReplaceableEntry*>
+    getPossibleEntries(const KeyType &key) const
+    {
+        const EntrySpan span = getPossibleEntrySpan(key);
+        return std::vector<ReplaceableEntry*>(span.begin(), span.end());
+    }
+
+    /**
+     * Find all possible entries of an address without allocating memory,
+     * as lookups do on every access. The span is only valid until the next
+     * call.
+     *
+     * @param key The key to find possible entries for.
+     * @return A view of the possible entries.
+     */
+    virtual EntrySpan getPossibleEntrySpan(const KeyType &key) const = 0;
 
     /**
      * Regenerate an entry's address from its tag and assigned indexing bits.
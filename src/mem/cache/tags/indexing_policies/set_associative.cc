@@ -69,10 +69,10 @@ SetAssociative::regenerateAddr(const Addr &tag,
     return (tag << tagShift) | (entry->getSet() << setShift);
 }
 
-std::vector<ReplaceableEntry*>
-SetAssociative::getPossibleEntries(const Addr &addr) const
+EntrySpan
+SetAssociative::getPossibleEntrySpan(const Addr &addr) const
 {
-    return sets[extractSet(addr)];
+    return setEntries(extractSet(addr));
 }
 
 } // namespace gem5
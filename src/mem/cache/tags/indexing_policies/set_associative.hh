@@ -107,16 +107,14 @@ class SetAssociative : public BaseIndexingPolicy
     ~SetAssociative() {};
 
     /**
-     * Find all possible entries for insertion and replacement of an address.
-     * Should be called immediately before ReplacementPolicy's findVictim()
-     * not to break cache resizing.
-     * Returns entries in all ways belonging to the set of the address.
+     * Find all possible entries of an address, which are the entries in all
+     * ways belonging to the set of the address. The span points into the
+     * set storage.
      *
      * @param addr The addr to a find possible entries for.
-     * @return The possible entries.
+     * @return A view of the possible entries.
      */
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr &addr) const
-                                                                     override;
+    EntrySpan getPossibleEntrySpan(const Addr &addr) const override;
 
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
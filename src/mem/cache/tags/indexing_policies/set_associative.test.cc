@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+const unsigned assoc = 4;
+const unsigned blkSize = 64;
+const unsigned numSets = 16;
+
+/** A 4 KiB, 4-way policy with 64 B entries, so 16 sets. */
+class SetAssociativeTest : public testing::Test
+{
+  protected:
+    SetAssociativeParams params;
+    std::vector<ReplaceableEntry> entries;
+
+    SetAssociativeTest()
+      : entries(assoc * numSets)
+    {
+        params.name = "indexing_policy";
+        params.eventq_index = 0;
+        params.assoc = assoc;
+        params.size = assoc * numSets * blkSize;
+        params.entry_size = blkSize;
+    }
+
+    void
+    setEntries(SetAssociative &ip)
+    {
+        for (unsigned i = 0; i < entries.size(); i++) {
+            ip.setEntry(&entries[i], i);
+        }
+    }
+};
+
+} // anonymous namespace
+
+/** The entries are laid out set-major, as their index says. */
+TEST_F(SetAssociativeTest, SetEntryPosition)
+{
+    SetAssociative ip(params);
+    setEntries(ip);
+
+    for (unsigned set = 0; set < numSets; set++) {
+        for (unsigned way = 0; way < assoc; way++) {
+            ReplaceableEntry *entry = ip.getEntry(set, way);
+            ASSERT_EQ(entry, &entries[set * assoc + way]);
+            ASSERT_EQ(entry->getSet(), set);
+            ASSERT_EQ(entry->getWay(), way);
+        }
+    }
+}
+
+/** The span of an address is all the ways of its set, in way order. */
+TEST_F(SetAssociativeTest, SpanIsSet)
+{
+    SetAssociative ip(params);
+    setEntries(ip);
+
+    for (unsigned set = 0; set < numSets; set++) {
+        const Addr addr = 0x10000 + set * blkSize + 8;
+        const EntrySpan span = ip.getPossibleEntrySpan(addr);
+        ASSERT_EQ(span.set(), set);
+        ASSERT_EQ(span.size(), assoc);
+        for (unsigned way = 0; way < assoc; way++) {
+            ASSERT_EQ(span[way], ip.getEntry(set, way));
+        }
+    }
+}
+
+/** The vector of possible entries holds the entries of the span. */
+TEST_F(SetAssociativeTest, PossibleEntriesMatchSpan)
+{
+    SetAssociative ip(params);
+    setEntries(ip);
+
+    for (Addr addr = 0; addr < 4 * params.size; addr += 40) {
+        const EntrySpan span = ip.getPossibleEntrySpan(addr);
+        const std::vector<ReplaceableEntry*> candidates =
+            ip.getPossibleEntries(addr);
+        ASSERT_EQ(std::vector<ReplaceableEntry*>(span.begin(), span.end()),
+                  candidates);
+    }
+}
+
+/** Addresses a cache size apart share a set but not a tag. */
+TEST_F(SetAssociativeTest, SetWrapsAround)
+{
+    SetAssociative ip(params);
+    setEntries(ip);
+
+    const Addr addr = 0x2340;
+    const Addr stride = numSets * blkSize;
+    for (int i = 1; i < 8; i++) {
+        ASSERT_EQ(ip.getPossibleEntrySpan(addr + i * stride).set(),
+                  ip.getPossibleEntrySpan(addr).set());
+        ASSERT_NE(ip.extractTag(addr + i * stride), ip.extractTag(addr));
+    }
+    ASSERT_NE(ip.getPossibleEntrySpan(addr + blkSize).set(),
+              ip.getPossibleEntrySpan(addr).set());
+}
+
+/** The address of an entry is rebuilt from its tag and its set. */
+TEST_F(SetAssociativeTest, RegenerateAddr)
+{
+    SetAssociative ip(params);
+    setEntries(ip);
+
+    for (Addr addr = 0x80000; addr < 0x80000 + 8 * params.size;
+         addr += 3 * blkSize) {
+        const EntrySpan span = ip.getPossibleEntrySpan(addr);
+        for (ReplaceableEntry *entry : span) {
+            ASSERT_EQ(ip.regenerateAddr(ip.extractTag(addr), entry), addr);
+        }
+    }
+}
@@ -43,7 +43,7 @@ namespace gem5
 
 SkewedAssociative::SkewedAssociative(const Params &p)
     : BaseIndexingPolicy(p, p.size / p.entry_size, floorLog2(p.entry_size)),
-      msbShift(floorLog2(numSets) - 1)
+      msbShift(floorLog2(numSets) - 1), candidates(assoc)
 {
     if (assoc > NUM_SKEWING_FUNCTIONS) {
         warn_once("Associativity higher than number of skewing functions. " \
@@ -207,18 +207,16 @@ SkewedAssociative::regenerateAddr(const Addr &tag,
            ((deskew(addr_set, entry->getWay()) & setMask) << setShift);
 }
 
-std::vector<ReplaceableEntry*>
-SkewedAssociative::getPossibleEntries(const Addr &addr) const
+EntrySpan
+SkewedAssociative::getPossibleEntrySpan(const Addr &addr) const
 {
-    std::vector<ReplaceableEntry*> entries;
-
     // Parse all ways
     for (uint32_t way = 0; way < assoc; ++way) {
         // Apply hash to get set, and get way entry in it
-        entries.push_back(sets[extractSet(addr, way)][way]);
+        candidates[way] = getEntry(extractSet(addr, way), way);
     }
 
-    return entries;
+    return EntrySpan(candidates.data(), assoc);
 }
 
 } // namespace gem5
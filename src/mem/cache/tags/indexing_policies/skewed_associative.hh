@@ -85,6 +85,12 @@ class SkewedAssociative : public BaseIndexingPolicy
      */
     const int msbShift;
 
+    /**
+     * The possible entries of the last lookup, one per way, reused so that
+     * lookups do not allocate.
+     */
+    mutable std::vector<ReplaceableEntry*> candidates;
+
     /**
      * The hash function itself. Uses the hash function H, as described in
      * "Skewed-Associative Caches", from Seznec et al. (section 3.3): It
@@ -153,15 +159,13 @@ class SkewedAssociative : public BaseIndexingPolicy
     ~SkewedAssociative() {};
 
     /**
-     * Find all possible entries for insertion and replacement of an address.
-     * Should be called immediately before ReplacementPolicy's findVictim()
-     * not to break cache resizing.
+     * Find all possible entries of an address, one per way. As they lie in
+     * different sets, the span points into a buffer of the policy.
      *
      * @param addr The addr to a find possible entries for.
-     * @return The possible entries.
+     * @return A view of the possible entries.
      */
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr &addr) const
-                                                                   override;
+    EntrySpan getPossibleEntrySpan(const Addr &addr) const override;
 
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
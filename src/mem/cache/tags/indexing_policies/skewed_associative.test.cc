@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <vector>
+
+#include "base/cache/associative_cache.hh"
+#include "base/cache/cache_entry.hh"
+#include "base/gtest/cur_tick_fake.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/cache/tags/indexing_policies/skewed_associative.hh"
+#include "params/LRURP.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+// Instantiate the fake class to have a valid curTick of 0
+GTestTickHandler tickHandler;
+
+const unsigned assoc = 4;
+const unsigned blkSize = 64;
+const unsigned numSets = 64;
+
+/** A 16 KiB, 4-way skewed policy with 64 B entries, so 64 sets. */
+class SkewedAssociativeTest : public testing::Test
+{
+  protected:
+    SkewedAssociativeParams params;
+    std::vector<ReplaceableEntry> entries;
+
+    SkewedAssociativeTest()
+      : entries(assoc * numSets)
+    {
+        params.name = "indexing_policy";
+        params.eventq_index = 0;
+        params.assoc = assoc;
+        params.size = assoc * numSets * blkSize;
+        params.entry_size = blkSize;
+    }
+
+    void
+    setEntries(SkewedAssociative &ip)
+    {
+        for (unsigned i = 0; i < entries.size(); i++) {
+            ip.setEntry(&entries[i], i);
+        }
+    }
+};
+
+} // anonymous namespace
+
+/**
+ * The span of an address holds one entry per way, each in the set the
+ * skewing function of that way picks, so it is not a single set.
+ */
+TEST_F(SkewedAssociativeTest, SpanHasOneEntryPerWay)
+{
+    SkewedAssociative ip(params);
+    setEntries(ip);
+
+    for (Addr addr = 0; addr < 16 * params.size; addr += 5 * blkSize) {
+        const EntrySpan span = ip.getPossibleEntrySpan(addr);
+        ASSERT_EQ(span.set(), EntrySpan::NoSet);
+        ASSERT_EQ(span.size(), assoc);
+        for (unsigned way = 0; way < assoc; way++) {
+            ASSERT_EQ(span[way]->getWay(), way);
+            ASSERT_EQ(span[way], ip.getEntry(span[way]->getSet(), way));
+        }
+        const std::vector<ReplaceableEntry*> candidates =
+            ip.getPossibleEntries(addr);
+        ASSERT_EQ(std::vector<ReplaceableEntry*>(span.begin(), span.end()),
+                  candidates);
+    }
+}
+
+/**
+ * Addresses that share the set of the first way are spread over other
+ * sets in the remaining ways.
+ */
+TEST_F(SkewedAssociativeTest, ConflictsAreSkewed)
+{
+    SkewedAssociative ip(params);
+    setEntries(ip);
+
+    const uint32_t set0 = ip.getPossibleEntrySpan(0)[0]->getSet();
+    unsigned conflicts = 0;
+    std::set<uint32_t> sets1;
+    for (Addr addr = 0; addr < 64 * params.size; addr += blkSize) {
+        const EntrySpan span = ip.getPossibleEntrySpan(addr);
+        if (span[0]->getSet() == set0) {
+            conflicts++;
+            sets1.insert(span[1]->getSet());
+        }
+    }
+    ASSERT_GT(conflicts, 1);
+    ASSERT_GT(sets1.size(), 1);
+}
+
+/**
+ * The span points into a buffer reused by the next lookup, so a span
+ * taken earlier sees the entries of the later address.
+ */
+TEST_F(SkewedAssociativeTest, SpanReusesBuffer)
+{
+    SkewedAssociative ip(params);
+    setEntries(ip);
+
+    const EntrySpan first = ip.getPossibleEntrySpan(0);
+    const std::vector<ReplaceableEntry*> second =
+        ip.getPossibleEntries(numSets * blkSize);
+    ASSERT_EQ(std::vector<ReplaceableEntry*>(first.begin(), first.end()),
+              second);
+}
+
+/** The address of an entry is rebuilt from its tag and its way. */
+TEST_F(SkewedAssociativeTest, RegenerateAddr)
+{
+    SkewedAssociative ip(params);
+    setEntries(ip);
+
+    for (Addr addr = 0x40000; addr < 0x40000 + 16 * params.size;
+         addr += 7 * blkSize) {
+        const EntrySpan span = ip.getPossibleEntrySpan(addr);
+        for (ReplaceableEntry *entry : span) {
+            ASSERT_EQ(ip.regenerateAddr(ip.extractTag(addr), entry), addr);
+        }
+    }
+}
+
+/**
+ * Fill a skewed cache with random addresses, with LRU replacement. An
+ * inserted address hits until it is replaced, every entry left valid is
+ * found at the address it was filled with, and addresses never inserted
+ * miss.
+ */
+TEST_F(SkewedAssociativeTest, HitMissReplacement)
+{
+    SkewedAssociative ip(params);
+    LRURPParams rp_params;
+    rp_params.name = "replacement_policy";
+    rp_params.eventq_index = 0;
+    replacement_policy::LRU rp(rp_params);
+    AssociativeCache<CacheEntry> cache("cache", assoc * numSets, assoc,
+        &rp, &ip, CacheEntry(genTagExtractor(&ip)));
+
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<Addr> dist(0, (1 << 20) - 1);
+    unsigned replaced = 0;
+    for (int i = 0; i < 4 * assoc * numSets; i++) {
+        tickHandler.setCurTick(i);
+        const Addr addr = dist(gen) * blkSize;
+        if (cache.accessEntry(addr)) {
+            continue;
+        }
+        CacheEntry *victim = cache.findVictim(addr);
+        ASSERT_NE(victim, nullptr);
+        ASSERT_FALSE(victim->isValid());
+        cache.insertEntry(addr, victim);
+        ASSERT_EQ(cache.findEntry(addr), victim);
+        replaced++;
+    }
+    ASSERT_GT(replaced, assoc * numSets);
+
+    unsigned valid = 0;
+    for (CacheEntry &entry : cache) {
+        if (entry.isValid()) {
+            const Addr addr = ip.regenerateAddr(entry.getTag(), &entry);
+            ASSERT_EQ(cache.findEntry(addr), &entry);
+            valid++;
+        }
+    }
+    ASSERT_EQ(valid, assoc * numSets);
+
+    // Addresses above the random range were never inserted
+    for (Addr addr = 1ULL << 26; addr < (1ULL << 26) + params.size;
+         addr += blkSize) {
+        ASSERT_EQ(cache.findEntry(addr), nullptr);
+    }
+}
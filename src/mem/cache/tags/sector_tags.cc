@@ -269,8 +269,7 @@ SectorTags::findBlock(const CacheBlk::KeyType &key) const
     const Addr offset = extractSectorOffset(key.address);
 
     // Find all possible sector entries that may contain the given address
-    const std::vector<ReplaceableEntry*> entries =
-        indexingPolicy->getPossibleEntries(key);
+    const EntrySpan entries = indexingPolicy->getPossibleEntrySpan(key);
 
     // Search for block
     for (const auto& sector : entries) {
@@ -0,0 +1,76 @@
+#ifndef __MEM_CACHE_TAGS_TAG_ARRAY_HH__
+#define __MEM_CACHE_TAGS_TAG_ARRAY_HH__
+
+#include <cstddef>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/**
+ * The lookup state of a table of tagged entries, laid out as a structure
+ * of arrays: one word per entry, encoding the tag and secure bit of valid
+ * entries. With the entries stored in set-major order, comparing a set is
+ * a scan over consecutive words, which the compiler can vectorize, rather
+ * than a walk over the entries calling their accessors one way at a time.
+ *
+ * The entries keep their own word up to date, see TaggedEntry::setTagSlot.
+ */
+class TagArray
+{
+  public:
+    /**
+     * The word of an invalid entry. Valid entries cannot encode to it, as
+     * tags are narrower than an address by at least the block offset.
+     */
+    static constexpr Addr Invalid = MaxAddr;
+
+    /**
+     * Encode the lookup state of a valid entry.
+     *
+     * @param tag The tag of the entry.
+     * @param secure Whether the entry belongs to the secure space.
+     * @return The word to compare lookups against.
+     */
+    static Addr
+    encode(Addr tag, bool secure)
+    {
+        return (tag << 1) | secure;
+    }
+
+    /** Make room for the given number of entries, all invalid. */
+    void resize(std::size_t size) { words.assign(size, Invalid); }
+
+    /** Get the word of an entry, for the entry to update. */
+    Addr *slot(std::size_t index) { return &words[index]; }
+
+    /**
+     * Look for a word among consecutive entries.
+     *
+     * @param first The index of the first entry.
+     * @param count The number of entries to compare.
+     * @param word The encoded lookup.
+     * @return The offset of the first match from first, or count on a miss.
+     */
+    std::size_t
+    find(std::size_t first, std::size_t count, Addr word) const
+    {
+        const Addr *set = &words[first];
+        // No early exit, so that the loop vectorizes. Going backwards
+        // keeps the first match should there be several.
+        std::size_t hit = count;
+        for (std::size_t i = count; i-- > 0;) {
+            hit = set[i] == word ? i : hit;
+        }
+        return hit;
+    }
+
+  private:
+    std::vector<Addr> words;
+};
+
+} // namespace gem5
+
+#endif // __MEM_CACHE_TAGS_TAG_ARRAY_HH__
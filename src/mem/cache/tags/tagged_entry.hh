@@ -47,6 +47,7 @@
 #include "base/types.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "mem/cache/tags/tag_array.hh"
 #include "params/TaggedIndexingPolicy.hh"
 #include "params/TaggedSetAssociative.hh"
 
@@ -88,10 +89,10 @@ class TaggedSetAssociative : public TaggedIndexingPolicy
       : TaggedIndexingPolicy(p, p.size / p.entry_size, floorLog2(p.entry_size))
     {}
 
-    std::vector<ReplaceableEntry*>
-    getPossibleEntries(const KeyType &key) const override
+    EntrySpan
+    getPossibleEntrySpan(const KeyType &key) const override
     {
-        return sets[extractSet(key)];
+        return setEntries(extractSet(key));
     }
 
     Addr
@@ -125,6 +126,20 @@ class TaggedEntry : public ReplaceableEntry
         extractTag = ext;
     }
 
+    /**
+     * Mirror the lookup state of this entry into a word of a tag array,
+     * which is then kept up to date. Only the state held by this class is
+     * mirrored, so entries overriding isValid() or getTag() cannot use it.
+     *
+     * @param slot The word of the entry in the tag array.
+     */
+    void
+    setTagSlot(Addr *slot)
+    {
+        tagSlot = slot;
+        updateTagSlot();
+    }
+
     /**
      * Checks if the entry is valid.
      *
@@ -197,13 +212,28 @@ class TaggedEntry : public ReplaceableEntry
      *
      * @param tag The tag value.
      */
-    virtual void setTag(Addr tag) { _tag = tag; }
+    virtual void
+    setTag(Addr tag)
+    {
+        _tag = tag;
+        updateTagSlot();
+    }
 
     /** Set secure bit. */
-    virtual void setSecure() { _secure = true; }
+    virtual void
+    setSecure()
+    {
+        _secure = true;
+        updateTagSlot();
+    }
 
     /** Clear secure bit. Should be only used by the invalidation function. */
-    void clearSecure() { _secure = false; }
+    void
+    clearSecure()
+    {
+        _secure = false;
+        updateTagSlot();
+    }
 
     /** Set valid bit. The block must be invalid beforehand. */
     virtual void
@@ -211,6 +241,7 @@ class TaggedEntry : public ReplaceableEntry
     {
         assert(!isValid());
         _valid = true;
+        updateTagSlot();
     }
 
     /** Callback used to extract the tag from the entry */
@@ -232,6 +263,19 @@ class TaggedEntry : public ReplaceableEntry
 
     /** The entry's tag. */
     Addr _tag;
+
+    /** The word mirroring this entry in a tag array, if any. */
+    Addr *tagSlot = nullptr;
+
+    /** Write the lookup state of this entry to its tag array word. */
+    void
+    updateTagSlot()
+    {
+        if (tagSlot) {
+            *tagSlot = _valid ? TagArray::encode(_tag, _secure) :
+                                TagArray::Invalid;
+        }
+    }
 };
 
 /**
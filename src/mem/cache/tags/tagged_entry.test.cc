@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "base/cache/associative_cache.hh"
+#include "base/gtest/cur_tick_fake.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/cache/tags/tag_array.hh"
+#include "mem/cache/tags/tagged_entry.hh"
+#include "params/LRURP.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+// Instantiate the fake class to have a valid curTick of 0
+GTestTickHandler tickHandler;
+
+const unsigned assoc = 4;
+const unsigned blkSize = 64;
+const unsigned numSets = 16;
+
+/**
+ * A 4 KiB, 4-way set associative tag store of 64 B blocks with LRU
+ * replacement, whose blocks are mirrored into a tag array the way
+ * BaseSetAssoc mirrors its blocks.
+ */
+class TaggedEntryTest : public testing::Test
+{
+  protected:
+    TaggedSetAssociativeParams ipParams;
+    LRURPParams rpParams;
+    TaggedSetAssociative ip;
+    replacement_policy::LRU rp;
+    AssociativeCache<TaggedEntry> cache;
+    TagArray tagArray;
+    Tick tick = 0;
+
+    static const TaggedSetAssociativeParams &
+    setIPParams(TaggedSetAssociativeParams &p)
+    {
+        p.name = "indexing_policy";
+        p.eventq_index = 0;
+        p.assoc = assoc;
+        p.size = assoc * numSets * blkSize;
+        p.entry_size = blkSize;
+        return p;
+    }
+
+    static const LRURPParams &
+    setRPParams(LRURPParams &p)
+    {
+        p.name = "replacement_policy";
+        p.eventq_index = 0;
+        return p;
+    }
+
+    TaggedEntryTest()
+      : ip(setIPParams(ipParams)), rp(setRPParams(rpParams)),
+        cache("cache")
+    {
+        TaggedEntry init;
+        init.registerTagExtractor(genTagExtractor(&ip));
+        cache.init(assoc * numSets, assoc, &rp, &ip, init);
+
+        tagArray.resize(assoc * numSets);
+        for (TaggedEntry &entry : cache) {
+            entry.setTagSlot(tagArray.slot(
+                entry.getSet() * assoc + entry.getWay()));
+        }
+        tickHandler.setCurTick(0);
+    }
+
+    /** Access a block, filling it on a miss. */
+    TaggedEntry *
+    access(Addr addr, bool secure=false)
+    {
+        tickHandler.setCurTick(++tick);
+        const TaggedEntry::KeyType key{addr, secure};
+        TaggedEntry *entry = cache.accessEntry(key);
+        if (!entry) {
+            entry = cache.findVictim(key);
+            cache.insertEntry(key, entry);
+        }
+        return entry;
+    }
+
+    /**
+     * Look a block up through the tag array, as BaseSetAssoc does for
+     * set spans.
+     */
+    TaggedEntry *
+    findInTagArray(Addr addr, bool secure=false)
+    {
+        const TaggedEntry::KeyType key{addr, secure};
+        const EntrySpan span = ip.getPossibleEntrySpan(key);
+        const std::size_t way = tagArray.find(span.set() * assoc, assoc,
+            TagArray::encode(ip.extractTag(addr), secure));
+        return way == assoc ? nullptr : static_cast<TaggedEntry*>(span[way]);
+    }
+};
+
+} // anonymous namespace
+
+/** An empty cache misses everywhere. */
+TEST_F(TaggedEntryTest, EmptyMisses)
+{
+    for (Addr addr = 0; addr < 4 * ipParams.size; addr += blkSize) {
+        ASSERT_EQ(cache.findEntry({addr, false}), nullptr);
+        ASSERT_EQ(findInTagArray(addr), nullptr);
+    }
+}
+
+/** A filled block hits at any offset, and only in its own space. */
+TEST_F(TaggedEntryTest, HitAfterFill)
+{
+    const Addr addr = 0x12340;
+    TaggedEntry *entry = access(addr);
+    ASSERT_TRUE(entry->isValid());
+
+    ASSERT_EQ(cache.findEntry({addr, false}), entry);
+    ASSERT_EQ(cache.findEntry({addr + blkSize - 1, false}), entry);
+    ASSERT_EQ(findInTagArray(addr), entry);
+
+    ASSERT_EQ(cache.findEntry({addr, true}), nullptr);
+    ASSERT_EQ(findInTagArray(addr, true), nullptr);
+    ASSERT_EQ(cache.findEntry({addr + blkSize, false}), nullptr);
+    ASSERT_EQ(cache.findEntry({addr + numSets * blkSize, false}), nullptr);
+}
+
+/** Secure and non-secure copies of an address are different blocks. */
+TEST_F(TaggedEntryTest, SecureIsPartOfTheTag)
+{
+    const Addr addr = 0x4000;
+    TaggedEntry *ns = access(addr, false);
+    TaggedEntry *s = access(addr, true);
+    ASSERT_NE(ns, s);
+    ASSERT_EQ(cache.findEntry({addr, false}), ns);
+    ASSERT_EQ(cache.findEntry({addr, true}), s);
+    ASSERT_EQ(findInTagArray(addr, false), ns);
+    ASSERT_EQ(findInTagArray(addr, true), s);
+}
+
+/**
+ * Filling one block more than the ways of a set evicts the least
+ * recently used block of the set, and no block of another set.
+ */
+TEST_F(TaggedEntryTest, LRUReplacement)
+{
+    const Addr base = 0x100 * blkSize;
+    const Addr stride = numSets * blkSize;
+    const Addr other = base + blkSize;
+    access(other);
+    for (unsigned i = 0; i < assoc; i++) {
+        access(base + i * stride);
+    }
+
+    // Touch the oldest block so that the second one becomes the LRU
+    access(base);
+    TaggedEntry *victim = cache.findEntry({base + stride, false});
+    ASSERT_NE(victim, nullptr);
+
+    ASSERT_EQ(access(base + assoc * stride), victim);
+    ASSERT_EQ(cache.findEntry({base + stride, false}), nullptr);
+    ASSERT_EQ(findInTagArray(base + stride), nullptr);
+    for (unsigned i : {0u, 2u, 3u, assoc}) {
+        ASSERT_NE(cache.findEntry({base + i * stride, false}), nullptr);
+        ASSERT_EQ(findInTagArray(base + i * stride),
+                  cache.findEntry({base + i * stride, false}));
+    }
+    ASSERT_NE(cache.findEntry({other, false}), nullptr);
+}
+
+/** An invalidated block misses, and is the next victim of its set. */
+TEST_F(TaggedEntryTest, Invalidate)
+{
+    const Addr base = 0x3 * blkSize;
+    const Addr stride = numSets * blkSize;
+    for (unsigned i = 0; i < assoc; i++) {
+        access(base + i * stride);
+    }
+
+    TaggedEntry *entry = cache.findEntry({base + 2 * stride, false});
+    cache.invalidate(entry);
+    ASSERT_FALSE(entry->isValid());
+    ASSERT_EQ(cache.findEntry({base + 2 * stride, false}), nullptr);
+    ASSERT_EQ(findInTagArray(base + 2 * stride), nullptr);
+
+    ASSERT_EQ(access(base + assoc * stride), entry);
+    ASSERT_NE(cache.findEntry({base, false}), nullptr);
+}
+
+/**
+ * The tag array agrees with matching the blocks one by one over a
+ * stream of fills that keeps every set full.
+ */
+TEST_F(TaggedEntryTest, TagArrayMatchesBlocks)
+{
+    for (unsigned i = 0; i < 16 * assoc * numSets; i++) {
+        const Addr addr = ((i * 2654435761u) % (64 * numSets)) * blkSize;
+        access(addr, i % 3 == 0);
+        for (Addr probe : {addr, addr + blkSize, addr ^ (8 * blkSize)}) {
+            for (bool secure : {false, true}) {
+                ASSERT_EQ(findInTagArray(probe, secure),
+                          cache.findEntry({probe, secure}));
+            }
+        }
+    }
+}
@@ -45,6 +45,8 @@
 
 #include "mem/coherent_xbar.hh"
 
+#include <algorithm>
+
 #include "base/compiler.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -62,11 +64,14 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams &p)
       maxRoutingTableSizeCheck(p.max_routing_table_size),
       pointOfCoherency(p.point_of_coherency),
       pointOfUnification(p.point_of_unification),
+      directRanges(p.direct_ranges),
 
       ADD_STAT(snoops, statistics::units::Count::get(), "Total snoops"),
       ADD_STAT(snoopTraffic, statistics::units::Byte::get(), "Total snoop traffic"),
       ADD_STAT(snoopFanout, statistics::units::Count::get(),
-               "Request fanout histogram")
+               "Request fanout histogram"),
+      ADD_STAT(directReqs, statistics::units::Count::get(),
+               "Requests forwarded on the direct lane")
 {
     // create the ports based on the size of the memory-side port and
     // CPU-side port vector ports, and the presence of the default port,
@@ -106,6 +111,8 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams &p)
                                            csprintf("respLayer%d", i)));
         snoopRespPorts.push_back(new SnoopRespPort(*bp, *this));
     }
+
+    directWaiting.resize(memSidePorts.size());
 }
 
 CoherentXBar::~CoherentXBar()
@@ -148,6 +155,9 @@ CoherentXBar::init()
 bool
 CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
 {
+    if (isDirect(pkt))
+        return recvTimingReqDirect(pkt, cpu_side_port_id);
+
     // determine the source port based on the id
     ResponsePort *src_port = cpuSidePorts[cpu_side_port_id];
 
@@ -197,7 +207,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
     const bool is_destination = isDestination(pkt);
 
     const bool snoop_caches = (!system->bypassCaches() &&
-        pkt->cmd != MemCmd::WriteClean) && !(pkt->isPUM() || pkt->isMAJ()); // Should use uncacheable instead
+        pkt->cmd != MemCmd::WriteClean);
 
     if (snoop_caches) {
         assert(pkt->snoopDelay == 0);
@@ -231,6 +241,10 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
                     __func__, src_port->name(), pkt->print(),
                     sf_res.first.size(), sf_res.second);
 
+            SnoopFilter::Eviction eviction;
+            if (snoopFilter->takeEviction(eviction))
+                backInvalidate(eviction, true);
+
             if (pkt->isEviction()) {
                 // for block-evicting packets, i.e. writebacks and
                 // clean evictions, there is no need to snoop up, as
@@ -444,6 +458,85 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
     return success;
 }
 
+bool
+CoherentXBar::isDirect(const PacketPtr pkt) const
+{
+    const RequestPtr &req = pkt->req;
+    if (req->isPUM() || req->isMAJ())
+        return true;
+    if (directRanges.empty() || !req->isUncacheable())
+        return false;
+    for (const auto &r : directRanges) {
+        if (r.contains(pkt->getAddr()))
+            return true;
+    }
+    return false;
+}
+
+bool
+CoherentXBar::recvTimingReqDirect(PacketPtr pkt, PortID cpu_side_port_id)
+{
+    // direct lane packets are never snooped, so no cache can have
+    // committed to responding to them
+    assert(!pkt->cacheResponding());
+
+    PortID mem_side_port_id = findPort(pkt);
+
+    DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
+            cpuSidePorts[cpu_side_port_id]->name(), pkt->print());
+
+    unsigned int pkt_size = pkt->hasData() ? pkt->getSize() : 0;
+    unsigned int pkt_cmd = pkt->cmdToIndex();
+    const bool expect_response = pkt->needsResponse();
+    const RequestPtr req = pkt->req;
+
+    // there is no layer to hold the port, so remember it until the
+    // peer tells us to retry
+    auto &waiting = directWaiting[mem_side_port_id];
+    auto wait = [&]() {
+        if (std::find(waiting.begin(), waiting.end(), cpu_side_port_id) ==
+            waiting.end()) {
+            waiting.push_back(cpu_side_port_id);
+        }
+        return false;
+    };
+
+    // while the peer owes a retry, to the layer or to the direct lane,
+    // the request waits its turn rather than overtaking the ones that
+    // were refused before it
+    if (!waiting.empty() || reqLayers[mem_side_port_id]->waitingForRetry()) {
+        DPRINTF(CoherentXBar, "%s: src %s packet %s WAITING\n", __func__,
+                cpuSidePorts[cpu_side_port_id]->name(), pkt->print());
+        return wait();
+    }
+
+    Tick old_header_delay = pkt->headerDelay;
+    calcPacketTiming(pkt, (frontendLatency + forwardLatency) * clockPeriod());
+
+    if (!memSidePorts[mem_side_port_id]->sendTimingReq(pkt)) {
+        DPRINTF(CoherentXBar, "%s: src %s packet %s RETRY\n", __func__,
+                cpuSidePorts[cpu_side_port_id]->name(), pkt->print());
+        pkt->headerDelay = old_header_delay;
+        return wait();
+    }
+
+    if (expect_response) {
+        assert(routeTo.find(req) == routeTo.end());
+        routeTo[req] = cpu_side_port_id;
+
+        panic_if(routeTo.size() > maxRoutingTableSizeCheck,
+                 "%s: Routing table exceeds %d packets\n",
+                 name(), maxRoutingTableSizeCheck);
+    }
+
+    pktCount[cpu_side_port_id][mem_side_port_id]++;
+    pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+    transDist[pkt_cmd]++;
+    directReqs++;
+
+    return true;
+}
+
 bool
 CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
 {
@@ -457,9 +550,12 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     assert(cpu_side_port_id != InvalidPortID);
     assert(cpu_side_port_id < respLayers.size());
 
+    // responses on the direct lane do not occupy a layer either
+    const bool direct = isDirect(pkt);
+
     // test if the crossbar should be considered occupied for the
     // current port
-    if (!respLayers[cpu_side_port_id]->tryTiming(src_port)) {
+    if (!direct && !respLayers[cpu_side_port_id]->tryTiming(src_port)) {
         DPRINTF(CoherentXBar, "%s: src %s packet %s BUSY\n", __func__,
                 src_port->name(), pkt->print());
         return false;
@@ -482,7 +578,7 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     // determine how long to be crossbar layer is busy
     Tick packetFinishTime = clockEdge(headerLatency) + pkt->payloadDelay;
 
-    if (snoopFilter && !system->bypassCaches()) {
+    if (snoopFilter && !system->bypassCaches() && !direct) {
         // let the snoop filter inspect the response and update its state
         snoopFilter->updateResponse(pkt, *cpuSidePorts[cpu_side_port_id]);
     }
@@ -497,7 +593,8 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     // remove the request from the routing table
     routeTo.erase(route_lookup);
 
-    respLayers[cpu_side_port_id]->succeededTiming(packetFinishTime);
+    if (!direct)
+        respLayers[cpu_side_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
     pktCount[cpu_side_port_id][mem_side_port_id]++;
@@ -730,8 +827,20 @@ CoherentXBar::recvReqRetry(PortID mem_side_port_id)
 {
     // responses and snoop responses never block on forwarding them,
     // so the retry will always be coming from a port to which we
-    // tried to forward a request
-    reqLayers[mem_side_port_id]->recvRetry();
+    // tried to forward a request, either on the direct lane or
+    // through the layer. The layer goes first, as the direct lane
+    // refuses requests while it waits for the retry
+    if (reqLayers[mem_side_port_id]->waitingForRetry())
+        reqLayers[mem_side_port_id]->recvRetry();
+
+    if (!directWaiting[mem_side_port_id].empty()) {
+        // the retried ports may be refused again and re-add
+        // themselves, so work on a copy of the list
+        std::vector<PortID> waiting;
+        waiting.swap(directWaiting[mem_side_port_id]);
+        for (PortID id : waiting)
+            cpuSidePorts[id]->sendRetryReq();
+    }
 }
 
 Tick
@@ -744,6 +853,30 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
     unsigned int pkt_size = pkt->hasData() ? pkt->getSize() : 0;
     unsigned int pkt_cmd = pkt->cmdToIndex();
 
+    if (isDirect(pkt)) {
+        // no snooping on the direct lane, straight to the destination
+        PortID mem_side_port_id = findPort(pkt);
+        auto mem_side_port = memSidePorts[mem_side_port_id];
+        Tick response_latency = backdoor ?
+            mem_side_port->sendAtomicBackdoor(pkt, *backdoor) :
+            mem_side_port->sendAtomic(pkt);
+
+        pktCount[cpu_side_port_id][mem_side_port_id]++;
+        pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+        transDist[pkt_cmd]++;
+        directReqs++;
+
+        if (pkt->isResponse()) {
+            pktCount[cpu_side_port_id][mem_side_port_id]++;
+            pktSize[cpu_side_port_id][mem_side_port_id] +=
+                pkt->hasData() ? pkt->getSize() : 0;
+            transDist[pkt->cmdToIndex()]++;
+        }
+
+        pkt->payloadDelay = response_latency;
+        return response_latency;
+    }
+
     MemCmd snoop_response_cmd = MemCmd::InvalidCmd;
     Tick snoop_response_latency = 0;
 
@@ -774,6 +907,10 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
             // between and change the filter state
             snoopFilter->finishRequest(false, pkt->getAddr(), pkt->isSecure());
 
+            SnoopFilter::Eviction eviction;
+            if (snoopFilter->takeEviction(eviction))
+                backInvalidate(eviction, false);
+
             if (pkt->isEviction()) {
                 // for block-evicting packets, i.e. writebacks and
                 // clean evictions, there is no need to snoop up, as
@@ -998,6 +1135,32 @@ CoherentXBar::forwardAtomic(PacketPtr pkt, PortID exclude_cpu_side_port_id,
     return std::make_pair(snoop_response_cmd, snoop_response_latency);
 }
 
+void
+CoherentXBar::backInvalidate(const SnoopFilter::Eviction &eviction,
+                             bool is_timing)
+{
+    RequestPtr req = Request::create(eviction.addr, system->cacheLineSize(),
+        Request::CLEAN | Request::INVALIDATE, Request::wbRequestorId);
+    if (eviction.secure)
+        req->setFlags(Request::SECURE);
+
+    // The caches copy anything they keep of a snoop, and they do not
+    // respond to cleans, so the packet need not outlive the snoop
+    Packet pkt(req, MemCmd::CleanInvalidReq);
+
+    DPRINTF(CoherentXBar, "%s: %s to %d holders\n", __func__, pkt.print(),
+            eviction.holders.size());
+
+    if (is_timing) {
+        // express snoops take effect right away, ahead of the request
+        // that caused the eviction
+        pkt.setExpressSnoop();
+        forwardTiming(&pkt, InvalidPortID, eviction.holders);
+    } else {
+        forwardAtomic(&pkt, InvalidPortID, InvalidPortID, eviction.holders);
+    }
+}
+
 void
 CoherentXBar::recvMemBackdoorReq(const MemBackdoorReq &req,
         MemBackdoorPtr &backdoor)
@@ -1102,7 +1265,7 @@ CoherentXBar::sinkPacket(const PacketPtr pkt) const
     //    flag) is providing writable and thus had a Modified block,
     //    and no further action is needed
     return (pointOfCoherency && pkt->cacheResponding()) ||
-        (pointOfCoherency && !(pkt->isRead() || pkt->isWrite() || pkt->isPUM() || pkt->isMAJ()) &&
+        (pointOfCoherency && !(pkt->isRead() || pkt->isWrite()) &&
          !pkt->needsResponse()) ||
         (pkt->isCleanEviction() && pkt->isBlockCached()) ||
         (pkt->cacheResponding() &&
@@ -1120,7 +1283,7 @@ CoherentXBar::forwardPacket(const PacketPtr pkt)
     if (pkt->isClean()) {
         return !isDestination(pkt);
     }
-    return pkt->isRead() || pkt->isWrite() || pkt->isPUM() || pkt->isMAJ() || !pointOfCoherency;
+    return pkt->isRead() || pkt->isWrite() || !pointOfCoherency;
 }
 
 
@@ -48,6 +48,7 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "mem/snoop_filter.hh"
 #include "mem/xbar.hh"
@@ -299,6 +300,15 @@ class CoherentXBar : public BaseXBar
     /** Is this crossbar the point of unification? **/
     const bool pointOfUnification;
 
+    /** Ranges whose uncacheable requests take the direct lane */
+    const std::vector<AddrRange> directRanges;
+
+    /**
+     * Per memory-side port, the CPU-side ports that had a direct lane
+     * request refused and are waiting for a retry.
+     */
+    std::vector<std::vector<PortID>> directWaiting;
+
     /**
      * Upstream caches need this packet until true is returned, so
      * hold it for deletion until a subsequent call
@@ -307,6 +317,23 @@ class CoherentXBar : public BaseXBar
 
     bool recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id);
     bool recvTimingResp(PacketPtr pkt, PortID mem_side_port_id);
+
+    /**
+     * Determine if a packet takes the direct lane. PUM and MAJ ops,
+     * and uncacheable accesses to one of the direct ranges, can never
+     * hit in a cache, so they are neither snooped nor seen by the
+     * snoop filter. They also bypass the layers, and only pay for the
+     * latency of the crossbar, which keeps memory-side operations
+     * from queueing behind the snoop traffic of the cores.
+     *
+     * @param pkt A request or its response
+     *
+     * @return True if the packet takes the direct lane
+     */
+    bool isDirect(const PacketPtr pkt) const;
+
+    /** Forward a timing request on the direct lane. */
+    bool recvTimingReqDirect(PacketPtr pkt, PortID cpu_side_port_id);
     void recvTimingSnoopReq(PacketPtr pkt, PortID mem_side_port_id);
     bool recvTimingSnoopResp(PacketPtr pkt, PortID cpu_side_port_id);
     void recvReqRetry(PortID mem_side_port_id);
@@ -377,6 +404,17 @@ class CoherentXBar : public BaseXBar
                                           const std::vector<QueuedResponsePort*>&
                                           dests);
 
+    /**
+     * Invalidate a line a finite snoop filter dropped in the caches that
+     * hold it, with a clean and invalidate snoop so that dirty copies are
+     * written back.
+     *
+     * @param eviction The line dropped and the ports holding it
+     * @param is_timing Whether to snoop in timing or atomic mode
+     */
+    void backInvalidate(const SnoopFilter::Eviction &eviction,
+                        bool is_timing);
+
     /** Function called by the port when the crossbar is receiving a Functional
         transaction.*/
     void recvFunctional(PacketPtr pkt, PortID cpu_side_port_id);
@@ -433,6 +471,7 @@ class CoherentXBar : public BaseXBar
     statistics::Scalar snoops;
     statistics::Scalar snoopTraffic;
     statistics::Distribution snoopFanout;
+    statistics::Scalar directReqs;
 
   public:
 
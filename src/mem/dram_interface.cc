@@ -46,6 +46,7 @@
 #include "debug/DRAM.hh"
 #include "debug/DRAMPower.hh"
 #include "debug/DRAMState.hh"
+#include "mem/pum_geometry.hh"
 #include "sim/system.hh"
 
 namespace gem5
@@ -104,8 +105,9 @@ DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
                         "%s bank %d - Rank %d available\n", __func__,
                         pkt->bank, pkt->rank);
 
-                // check if it is a row hit
-                if (bank.openRow == pkt->row) {
+                // check if it is a row hit, a PUM op always needs a
+                // precharged bank
+                if (bank.openRow == pkt->row && !pkt->isPUM()) {
                     // no additional rank-to-rank or same bank-group
                     // delays, or we switched read/write and might as well
                     // go for the row hit
@@ -171,7 +173,7 @@ DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
     return std::make_pair(selected_pkt_it, selected_col_at);
 }
 
-void
+Tick
 DRAMInterface::activateBank(Rank& rank_ref, Bank& bank_ref,
                        Tick act_tick, uint32_t row)
 {
@@ -278,6 +280,8 @@ DRAMInterface::activateBank(Rank& rank_ref, Bank& bank_ref,
     else if (rank_ref.activateEvent.when() > act_at)
         // move it sooner in time
         reschedule(rank_ref.activateEvent, act_at);
+
+    return act_at;
 }
 
 void
@@ -350,6 +354,9 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
     DPRINTF(DRAM, "Timing access to addr %#x, rank/bank/row %d %d %d\n",
             mem_pkt->addr, mem_pkt->rank, mem_pkt->bank, mem_pkt->row);
 
+    if (mem_pkt->isPUM())
+        return doPUMAccess(mem_pkt, next_burst_at);
+
     // get the rank
     Rank& rank_ref = *ranks[mem_pkt->rank];
 
@@ -616,6 +623,62 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
     return std::make_pair(cmd_at, cmd_at + burst_gap);
 }
 
+std::pair<Tick, Tick>
+DRAMInterface::doPUMAccess(MemPacket* mem_pkt, Tick next_burst_at)
+{
+    Rank& rank_ref = *ranks[mem_pkt->rank];
+
+    assert(rank_ref.inRefIdleState());
+
+    if (rank_ref.inLowPowerState) {
+        assert(rank_ref.pwrState != PWR_SREF);
+        rank_ref.scheduleWakeUpEvent(tXP);
+    }
+
+    Bank& bank_ref = rank_ref.banks[mem_pkt->bank];
+
+    // the op starts from a precharged bank
+    if (bank_ref.openRow != Bank::NO_ROW) {
+        prechargeBank(rank_ref, bank_ref, std::max(bank_ref.preAllowedAt,
+                                                   curTick()));
+    }
+
+    // the first activate deals with tRRD and tXAW, the rest of the op
+    // is internal to the bank
+    const Tick act_at = activateBank(rank_ref, bank_ref,
+        std::max(bank_ref.actAllowedAt, curTick()), mem_pkt->row);
+
+    const bool rowclone = mem_pkt->pumOp == MemPacket::PUMOp::RowClone;
+    bank_ref.preAllowedAt = std::max(bank_ref.preAllowedAt,
+                                     act_at + (rowclone ? tAAP : tTRA));
+
+    // nothing can use the row buffer until the op has precharged
+    prechargeBank(rank_ref, bank_ref, bank_ref.preAllowedAt);
+    mem_pkt->readyTime = bank_ref.actAllowedAt;
+
+    DPRINTF(DRAM, "%s at %#x from %lld done at %lld\n",
+            rowclone ? "RowClone" : "MAJ", mem_pkt->addr, act_at,
+            mem_pkt->readyTime);
+
+    // hold off power-down until the op is done, as for a write
+    if (!rank_ref.writeDoneEvent.scheduled()) {
+        schedule(rank_ref.writeDoneEvent, mem_pkt->readyTime);
+        ++rank_ref.outstandingEvents;
+    } else if (rank_ref.writeDoneEvent.when() < mem_pkt->readyTime) {
+        reschedule(rank_ref.writeDoneEvent, mem_pkt->readyTime);
+    }
+    --rank_ref.writeEntries;
+
+    if (rowclone)
+        stats.rowClones++;
+    else
+        stats.majorities++;
+    stats.totPUMLat += mem_pkt->readyTime - mem_pkt->entryTime;
+
+    // the data bus is left alone
+    return std::make_pair(act_at, next_burst_at);
+}
+
 void
 DRAMInterface::addRankToRankDelay(Tick cmd_at)
 {
@@ -645,7 +708,10 @@ DRAMInterface::DRAMInterface(const DRAMInterfaceParams &_p)
       tRP(_p.tRP), tRAS(_p.tRAS), tWR(_p.tWR), tRTP(_p.tRTP),
       tRFC(_p.tRFC), tREFI(_p.tREFI), tRRD(_p.tRRD), tRRD_L(_p.tRRD_L),
       tPPD(_p.tPPD), tAAD(_p.tAAD),
-      tXAW(_p.tXAW), tXP(_p.tXP), tXS(_p.tXS),
+      tXAW(_p.tXAW),
+      tAAP(_p.tAAP != 0 ? _p.tAAP : _p.tRCD + _p.tRAS),
+      tTRA(_p.tTRA != 0 ? _p.tTRA : _p.tRAS),
+      tXP(_p.tXP), tXS(_p.tXS),
       clkResyncDelay(_p.tBURST_MAX),
       dataClockSync(_p.data_clock_sync),
       burstInterleave(tBURST != tBURST_MIN),
@@ -917,6 +983,17 @@ DRAMInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
                    bank_id, pkt_addr, size);
 }
 
+MemPacket::PUMOp
+DRAMInterface::pumOp(const PacketPtr pkt, Addr addr) const
+{
+    // the same choice as the functional model makes, an op on one of
+    // the MAJ rows is a triple row activation
+    if (pkt->isMAJ() ||
+        (pumGeometry && pumGeometry->isMajority(range.getOffset(addr))))
+        return MemPacket::PUMOp::Majority;
+    return MemPacket::PUMOp::RowClone;
+}
+
 void DRAMInterface::setupRank(const uint8_t rank, const bool is_read)
 {
     // increment entry count of the rank based on packet type
@@ -1851,6 +1928,16 @@ DRAMInterface::DRAMStats::DRAMStats(DRAMInterface &_dram)
     ADD_STAT(writeBursts, statistics::units::Count::get(),
              "Number of DRAM write bursts"),
 
+    ADD_STAT(rowClones, statistics::units::Count::get(),
+             "Number of RowClone (AAP) ops"),
+    ADD_STAT(majorities, statistics::units::Count::get(),
+             "Number of MAJ (TRA) ops"),
+    ADD_STAT(totPUMLat, statistics::units::Tick::get(),
+             "Total ticks from queuing until PUM ops are done"),
+    ADD_STAT(avgPUMLat, statistics::units::Rate<
+                statistics::units::Tick, statistics::units::Count>::get(),
+             "Average latency per PUM op"),
+
     ADD_STAT(perBankRdBursts, statistics::units::Count::get(),
              "Per bank write bursts"),
     ADD_STAT(perBankWrBursts, statistics::units::Count::get(),
@@ -1935,6 +2022,9 @@ DRAMInterface::DRAMStats::regStats()
 
     peakBW.precision(2);
     busUtil.precision(2);
+
+    avgPUMLat.precision(2);
+    avgPUMLat = totPUMLat / (rowClones + majorities);
     busUtilWrite.precision(2);
     busUtilRead.precision(2);
 
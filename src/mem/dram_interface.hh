@@ -521,6 +521,8 @@ class DRAMInterface : public MemInterface
     const Tick tPPD;
     const Tick tAAD;
     const Tick tXAW;
+    const Tick tAAP;
+    const Tick tTRA;
     const Tick tXP;
     const Tick tXS;
     const Tick clkResyncDelay;
@@ -561,8 +563,9 @@ class DRAMInterface : public MemInterface
      * @param bank_ref Reference to the bank
      * @param act_tick Time when the activation takes place
      * @param row Index of the row
+     * @return Time the activate is issued at
      */
-    void activateBank(Rank& rank_ref, Bank& bank_ref, Tick act_tick,
+    Tick activateBank(Rank& rank_ref, Bank& bank_ref, Tick act_tick,
                       uint32_t row);
 
     /**
@@ -580,6 +583,21 @@ class DRAMInterface : public MemInterface
                        Tick pre_tick, bool auto_or_preall = false,
                        bool trace = true);
 
+    /**
+     * Perform a PUM op in the array. The bank is precharged if needed,
+     * and the op occupies it from its first activate until the final
+     * precharge is done, leaving the bank precharged. The data bus is
+     * not used, so the op only competes for its own bank and for the
+     * activate constraints (tRRD, tXAW) of its rank, where it counts
+     * as a single activate.
+     *
+     * @param mem_pkt The PUM op
+     * @param next_burst_at Minimum time for the next burst
+     * @return Time the op is issued at, and the next burst time
+     */
+    std::pair<Tick, Tick>
+    doPUMAccess(MemPacket* mem_pkt, Tick next_burst_at);
+
     struct DRAMStats : public statistics::Group
     {
         DRAMStats(DRAMInterface &dram);
@@ -593,6 +611,12 @@ class DRAMInterface : public MemInterface
         statistics::Scalar readBursts;
         statistics::Scalar writeBursts;
 
+        /** PUM ops performed, and their latency */
+        statistics::Scalar rowClones;
+        statistics::Scalar majorities;
+        statistics::Scalar totPUMLat;
+        statistics::Formula avgPUMLat;
+
         /** DRAM per bank stats */
         statistics::Vector perBankRdBursts;
         statistics::Vector perBankWrBursts;
@@ -681,6 +705,8 @@ class DRAMInterface : public MemInterface
      */
     void setupRank(const uint8_t rank, const bool is_read) override;
 
+    MemPacket::PUMOp pumOp(const PacketPtr pkt, Addr addr) const override;
+
     MemPacket* decodePacket(const PacketPtr pkt, Addr pkt_addr,
                            unsigned int size, bool is_read,
                            uint8_t pseudo_channel = 0) override;
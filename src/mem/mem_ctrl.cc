@@ -65,7 +65,7 @@ MemCtrl::MemCtrl(const MemCtrlParams &p) :
                          respondEvent, nextReqEvent, retryWrReq);}, name()),
     respondEvent([this] {processRespondEvent(dram, respQueue,
                          respondEvent, retryRdReq); }, name()),
-    dram(p.dram),
+    pumQueued(0), pumPending(nullptr), pumNext(0), dram(p.dram),
     readBufferSize(dram->readBufferSize),
     writeBufferSize(dram->writeBufferSize),
     writeHighThreshold(writeBufferSize * p.write_high_thresh_perc / 100.0),
@@ -226,7 +226,7 @@ MemCtrl::addToReadQueue(PacketPtr pkt,
                 for (const auto& p : vec) {
                     // check if the read is subsumed in the write queue
                     // packet we are looking at
-                    if (p->addr <= addr &&
+                    if (!p->isPUM() && p->addr <= addr &&
                        ((addr + size) <= (p->addr + p->size))) {
 
                         foundInWrQ = true;
@@ -352,7 +352,7 @@ MemCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pkt_count,
 
             mem_intr->writeQueueSize++;
 
-            assert(totalWriteQueueSize == isInWriteQueue.size());
+            assert(totalWriteQueueSize == isInWriteQueue.size() + pumQueued);
 
             // Update stats
             stats.avgWrQLen = totalWriteQueueSize;
@@ -378,6 +378,60 @@ MemCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pkt_count,
     accessAndRespond(pkt, frontendLatency, mem_intr);
 }
 
+void
+MemCtrl::addPUMToWriteQueue(PacketPtr pkt, unsigned int pkt_count,
+                            MemInterface* mem_intr)
+{
+    const unsigned size = mem_intr->bytesPerBurst();
+
+    for (; pumNext < pkt_count; ++pumNext) {
+        if (writeQueueFull(1)) {
+            DPRINTF(MemCtrl, "Write queue full after %d of %d PUM targets\n",
+                    pumNext, pkt_count);
+            pumPending = pkt;
+            return;
+        }
+
+        const Addr addr = pkt->isPUMBatch() ? pkt->pumBatchTarget(pumNext) :
+                                              pkt->getAddr();
+        panic_if(!mem_intr->getAddrRange().contains(addr),
+                 "Can't handle PUM target %#x of packet %s\n", addr,
+                 pkt->print());
+
+        const MemPacket::PUMOp op = mem_intr->pumOp(pkt, addr);
+        fatal_if(op == MemPacket::PUMOp::None, "%s: %s cannot perform PUM "
+                 "ops\n", name(), mem_intr->name());
+
+        MemPacket* mem_pkt = mem_intr->decodePacket(pkt, addr, size, false,
+                                                    mem_intr->pseudoChannel);
+        mem_pkt->pumOp = op;
+        mem_pkt->readyTime = MaxTick;
+
+        mem_intr->setupRank(mem_pkt->rank, false);
+
+        stats.wrQLenPdf[totalWriteQueueSize]++;
+
+        DPRINTF(MemCtrl, "Adding PUM op at %#x to write queue\n", addr);
+
+        writeQueue[mem_pkt->qosValue()].push_back(mem_pkt);
+        ++pumQueued;
+
+        logRequest(MemCtrl::WRITE, pkt->requestorId(), pkt->qosValue(),
+                   mem_pkt->addr, 1);
+
+        mem_intr->writeQueueSize++;
+
+        assert(totalWriteQueueSize == isInWriteQueue.size() + pumQueued);
+
+        stats.avgWrQLen = totalWriteQueueSize;
+        stats.pumOps++;
+    }
+
+    pumPending = nullptr;
+    pumNext = 0;
+    accessAndRespond(pkt, frontendLatency, mem_intr);
+}
+
 void
 MemCtrl::printQs() const
 {
@@ -413,8 +467,10 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
     panic_if(pkt->cacheResponding(), "Should not see packets where cache "
              "is responding");
 
-    panic_if(!(pkt->isRead() || pkt->isWrite()),
-             "Should only see read and writes at memory controller\n");
+    panic_if(!(pkt->isRead() || pkt->isWrite() || pkt->isPUM() ||
+               pkt->isMAJ()),
+             "Should only see read, writes and PUM ops at memory "
+             "controller\n");
 
     // Calc avg gap between requests
     if (prevArrival != 0) {
@@ -435,11 +491,34 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
     unsigned offset = pkt->getAddr() & (burst_size - 1);
     unsigned int pkt_count = divCeil(offset + size, burst_size);
 
+    // a PUM op turns into one in-DRAM op per target instead
+    if (pkt->isPUM() || pkt->isMAJ())
+        pkt_count = pkt->isPUMBatch() ? pkt->pumBatchCount() : 1;
+
     // run the QoS scheduler and assign a QoS priority value to the packet
     qosSchedule( { &readQueue, &writeQueue }, burst_size, pkt);
 
-    // check local buffers and do not accept if full
-    if (pkt->isWrite()) {
+    // check local buffers and do not accept if full, the rest of a
+    // batched PUM op goes before any other write or PUM op
+    if (pumPending && !pkt->isRead()) {
+        DPRINTF(MemCtrl, "PUM batch pending, not accepting\n");
+        retryWrReq = true;
+        stats.numWrRetry++;
+        return false;
+    } else if (pkt->isPUM() || pkt->isMAJ()) {
+        // a batch is accepted once its first target fits, the others
+        // are queued as the writes ahead of them leave
+        if (writeQueueFull(std::min(pkt_count, 1u))) {
+            DPRINTF(MemCtrl, "Write queue full, not accepting PUM op\n");
+            retryWrReq = true;
+            stats.numWrRetry++;
+            return false;
+        }
+        addPUMToWriteQueue(pkt, pkt_count, dram);
+        if (!nextReqEvent.scheduled())
+            schedule(nextReqEvent, curTick());
+        stats.pumReqs++;
+    } else if (pkt->isWrite()) {
         assert(size != 0);
         if (writeQueueFull(pkt_count)) {
             DPRINTF(MemCtrl, "Write queue full, not accepting\n");
@@ -824,6 +903,9 @@ MemCtrl::doBurstAccess(MemPacket* mem_pkt, MemInterface* mem_intr)
         stats.requestorReadTotalLat[mem_pkt->requestorId()] +=
             mem_pkt->readyTime - mem_pkt->entryTime;
         stats.requestorReadBytes[mem_pkt->requestorId()] += mem_pkt->size;
+    } else if (mem_pkt->isPUM()) {
+        // a PUM op moves no data over the bus
+        ++(mem_intr->writesThisTime);
     } else {
         ++(mem_intr->writesThisTime);
         stats.requestorWriteBytes[mem_pkt->requestorId()] += mem_pkt->size;
@@ -1100,7 +1182,10 @@ MemCtrl::processNextReqEvent(MemInterface* mem_intr,
         DPRINTF(MemCtrl,
         "Command for %#x, issued at %lld.\n", mem_pkt->addr, cmd_at);
 
-        isInWriteQueue.erase(burstAlign(mem_pkt->addr, mem_intr));
+        if (mem_pkt->isPUM())
+            --pumQueued;
+        else
+            isInWriteQueue.erase(burstAlign(mem_pkt->addr, mem_intr));
 
         // log the response
         logResponse(MemCtrl::WRITE, mem_pkt->requestorId(),
@@ -1137,12 +1222,20 @@ MemCtrl::processNextReqEvent(MemInterface* mem_intr,
             // nothing to do
         }
     }
+    // Queue more targets of a pending PUM batch in the room the writes
+    // left
+    if (pumPending && mem_intr == dram) {
+        addPUMToWriteQueue(pumPending, pumPending->pumBatchCount(),
+                           mem_intr);
+    }
+
     // It is possible that a refresh to another rank kicks things back into
     // action before reaching this point.
     if (!next_req_event.scheduled())
         schedule(next_req_event, std::max(mem_intr->nextReqTime, curTick()));
 
-    if (retry_wr_req && mem_intr->writeQueueSize < writeBufferSize) {
+    if (retry_wr_req && !pumPending &&
+        mem_intr->writeQueueSize < writeBufferSize) {
         retry_wr_req = false;
         port.sendRetryReq();
     }
@@ -1186,6 +1279,10 @@ MemCtrl::CtrlStats::CtrlStats(MemCtrl &_ctrl)
              "Number of read requests accepted"),
     ADD_STAT(writeReqs, statistics::units::Count::get(),
              "Number of write requests accepted"),
+    ADD_STAT(pumReqs, statistics::units::Count::get(),
+             "Number of PUM and MAJ requests accepted"),
+    ADD_STAT(pumOps, statistics::units::Count::get(),
+             "Number of PUM and MAJ ops queued, one per batch target"),
 
     ADD_STAT(readBursts, statistics::units::Count::get(),
              "Number of controller read bursts, including those serviced by "
@@ -99,6 +99,17 @@ class MemPacket
 {
   public:
 
+    /** The in-DRAM operation of a PUM or MAJ op */
+    enum class PUMOp : uint8_t
+    {
+        /** A read or write burst */
+        None,
+        /** RowClone the row into another one of its subarray (AAP) */
+        RowClone,
+        /** Triple row activation of the MAJ rows (TRA) */
+        Majority
+    };
+
     /** When did request enter the controller */
     const Tick entryTime;
 
@@ -156,6 +167,15 @@ class MemPacket
      */
     uint8_t _qosValue;
 
+    /**
+     * The PUM op this packet performs, if any. PUM ops are queued with
+     * the writes and, like them, answered as soon as they are queued.
+     */
+    PUMOp pumOp;
+
+    /** Return true if this packet is a PUM op rather than a burst */
+    inline bool isPUM() const { return pumOp != PUMOp::None; }
+
     /**
      * Set the packet QoS value
      * (interface compatibility with Packet)
@@ -210,7 +230,8 @@ class MemPacket
           _requestorId(pkt->requestorId()),
           read(is_read), dram(is_dram), pseudoChannel(_channel), rank(_rank),
           bank(_bank), row(_row), bankId(bank_id), addr(_addr), size(_size),
-          burstHelper(NULL), _qosValue(_pkt->qosValue())
+          burstHelper(NULL), _qosValue(_pkt->qosValue()),
+          pumOp(PUMOp::None)
     { }
 
 };
@@ -360,6 +381,23 @@ class MemCtrl : public qos::MemCtrl
     void addToWriteQueue(PacketPtr pkt, unsigned int pkt_count,
                          MemInterface* mem_intr);
 
+    /**
+     * Queue a PUM or MAJ op with the writes, as one entry per target
+     * of a batched op, and answer it once its last target is queued.
+     * A batch with more targets than the write queue has room for is
+     * kept in pumPending, and its remaining targets are queued as
+     * writes leave the queue. Like for writes, the functional effect is
+     * applied when the op is answered and the queued entries only carry
+     * the timing. PUM ops are never merged with writes, nor do they
+     * service reads.
+     *
+     * @param pkt The PUM or MAJ request from the outside world
+     * @param pkt_count The number of targets of the op
+     * @param mem_intr The memory interface to perform it
+     */
+    void addPUMToWriteQueue(PacketPtr pkt, unsigned int pkt_count,
+                            MemInterface* mem_intr);
+
     /**
      * Actually do the burst based on media specific access function.
      * Update bus statistics when complete.
@@ -481,6 +519,17 @@ class MemCtrl : public qos::MemCtrl
      */
     std::unordered_set<Addr> isInWriteQueue;
 
+    /** Number of PUM ops in the write queue, none in isInWriteQueue */
+    unsigned int pumQueued;
+
+    /**
+     * The batched PUM op whose targets do not all fit the write queue
+     * yet, if any, and the next of its targets to queue. Writes and PUM
+     * ops are refused until it is answered.
+     */
+    PacketPtr pumPending;
+    unsigned int pumNext;
+
     /**
      * Response queue where read packets wait after we're done working
      * with them, but it's not time to send the response yet. The
@@ -570,6 +619,8 @@ class MemCtrl : public qos::MemCtrl
         // All statistics that the model needs to capture
         statistics::Scalar readReqs;
         statistics::Scalar writeReqs;
+        statistics::Scalar pumReqs;
+        statistics::Scalar pumOps;
         statistics::Scalar readBursts;
         statistics::Scalar writeBursts;
         statistics::Scalar servicedByWrQ;
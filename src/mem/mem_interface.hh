@@ -308,6 +308,20 @@ class MemInterface : public AbstractMemory
      */
     Tick minWriteToReadDataGap() const { return std::min(tWTR, tCS); }
 
+    /**
+     * Determine the in-memory operation performing a PUM or MAJ op on
+     * an address, if the media supports any.
+     *
+     * @param pkt The PUM or MAJ packet from the outside world
+     * @param addr The address of the op, i.e. a target of a batch
+     * @return The operation, PUMOp::None if PUM ops are not supported
+     */
+    virtual MemPacket::PUMOp
+    pumOp(const PacketPtr pkt, Addr addr) const
+    {
+        return MemPacket::PUMOp::None;
+    }
+
     /**
      * Address decoder to figure out physical mapping onto ranks,
      * banks, and rows. This function is called multiple times on the same
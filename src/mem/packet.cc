@@ -239,6 +239,10 @@ MemCmd::commandInfo[] =
     { {IsRequest}, InvalidCmd, "TlbiExtSync" },
     { {IsPUM, IsRequest, NeedsResponse}, PUMResp, "PUM" },
     { {IsMAJ, IsRequest, NeedsResponse}, PUMResp, "MAJ" },
+    /* The batch descriptor travels in the data of the packet, but it
+     * is not memory contents, so the batch ops do not have HasData */
+    { {IsPUM, IsPUMBatch, IsRequest, NeedsResponse}, PUMResp, "PUMBatch" },
+    { {IsMAJ, IsPUMBatch, IsRequest, NeedsResponse}, PUMResp, "MAJBatch" },
     { {IsPUM, IsResponse}, InvalidCmd, "PUMResp"},
 };
 
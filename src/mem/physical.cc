@@ -39,22 +39,28 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
 #include "mem/abstract_mem.hh"
+#include "sim/byteswap.hh"
 #include "sim/serialize.hh"
 #include "sim/sim_exit.hh"
 
@@ -76,14 +82,69 @@ namespace gem5
 namespace memory
 {
 
+/**
+ * Memory images are stored in chunks that are compressed on their own,
+ * so that they are compressed and decompressed in parallel, and chunks
+ * that are all zero are not stored at all. An image is laid out as a
+ * header (magic, chunk size, number of chunks, offset of the index),
+ * the compressed chunks in order, and an index holding the compressed
+ * size of each chunk, zero for a chunk of zeros. All fields are 64-bit
+ * little endian.
+ *
+ * Images may also hold the chunks raw, each one starting at a multiple
+ * of StoreRawAlign in the file, so that a restore can map them
+ * copy-on-write straight into the backing store.
+ */
+static const char StoreMagic[8] = {'g', 'e', 'm', '5', 'p', 'm', 'c', '1'};
+static const char StoreRawMagic[8] = {'g', 'e', 'm', '5', 'p', 'm', 'r', '1'};
+static const uint64_t StoreChunkSize = 1 << 20;
+// covers the page sizes of the common hosts
+static const uint64_t StoreRawAlign = 1 << 16;
+
+static bool
+isZero(const uint8_t *data, uint64_t size)
+{
+    // chunks are page aligned, so go a word at a time
+    const uint64_t *words = reinterpret_cast<const uint64_t *>(data);
+    return std::all_of(words, words + size / sizeof(uint64_t),
+                       [](uint64_t w) { return w == 0; }) &&
+        std::all_of(data + size - size % sizeof(uint64_t), data + size,
+                    [](uint8_t b) { return b == 0; });
+}
+
+static bool
+preadAll(int fd, void *buf, uint64_t size, uint64_t offset)
+{
+    uint8_t *dst = static_cast<uint8_t *>(buf);
+    while (size) {
+        ssize_t bytes = pread(fd, dst, size, offset);
+        if (bytes < 0 && errno == EINTR)
+            continue;
+        if (bytes <= 0)
+            return false;
+        dst += bytes;
+        offset += bytes;
+        size -= bytes;
+    }
+    return true;
+}
+
 PhysicalMemory::PhysicalMemory(const std::string& _name,
                                const std::vector<AbstractMemory*>& _memories,
                                bool mmap_using_noreserve,
                                const std::string& shared_backstore,
-                               bool auto_unlink_shared_backstore) :
+                               bool auto_unlink_shared_backstore,
+                               unsigned checkpoint_threads,
+                               bool checkpoint_compress,
+                               bool lazy_restore,
+                               bool lazy_restore_check) :
     _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
     sharedBackstore(shared_backstore), sharedBackstoreSize(0),
-    pageSize(sysconf(_SC_PAGE_SIZE))
+    pageSize(sysconf(_SC_PAGE_SIZE)),
+    checkpointThreads(checkpoint_threads ? checkpoint_threads :
+                      std::max(std::thread::hardware_concurrency(), 1U)),
+    checkpointCompress(checkpoint_compress), lazyRestore(lazy_restore),
+    lazyRestoreCheck(lazy_restore_check)
 {
     // Register cleanup callback if requested.
     if (auto_unlink_shared_backstore && !sharedBackstore.empty()) {
@@ -267,6 +328,9 @@ PhysicalMemory::~PhysicalMemory()
     // unmap the backing store
     for (auto& s : backingStore)
         munmap((char*)s.pmem, s.range.size());
+
+    for (const auto &image : mappedImages)
+        close(image.fd);
 }
 
 bool
@@ -347,6 +411,8 @@ PhysicalMemory::serialize(CheckpointOut &cp) const
     SERIALIZE_CONTAINER(lal_addr);
     SERIALIZE_CONTAINER(lal_cid);
 
+    checkMappedImages();
+
     // serialize the backing stores
     unsigned int nbr_of_stores = backingStore.size();
     SERIALIZE_SCALAR(nbr_of_stores);
@@ -359,6 +425,27 @@ PhysicalMemory::serialize(CheckpointOut &cp) const
     }
 }
 
+void
+PhysicalMemory::forEachChunk(uint64_t first, uint64_t last,
+                             const std::function<void(uint64_t)> &job) const
+{
+    std::atomic<uint64_t> next(first);
+    auto worker = [&]() {
+        for (uint64_t i = next++; i < last; i = next++)
+            job(i);
+    };
+
+    // the calling thread takes part as well
+    const unsigned threads = std::min<uint64_t>(checkpointThreads,
+                                                last - first);
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++)
+        workers.emplace_back(worker);
+    worker();
+    for (auto &w : workers)
+        w.join();
+}
+
 void
 PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
                                AddrRange range, uint8_t* pmem) const
@@ -368,6 +455,7 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     std::string filename =
         name() + ".store" + std::to_string(store_id) + ".pmem";
     Addr range_size = range.size();
+    uint64_t chunk_size = StoreChunkSize;
 
     DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
             filename, range_size);
@@ -375,35 +463,120 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(store_id);
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
+    // only chunked images have a chunk size
+    SERIALIZE_SCALAR(chunk_size);
 
-    // write memory file
+    // write memory file, next to any image of the same name rather
+    // than over it, as the store may have pages of it mapped
     std::string filepath = CheckpointIn::dir() + "/" + filename.c_str();
-    gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
-    if (compressed_mem == NULL)
+    std::string tmppath = filepath + ".tmp";
+    std::FILE *file = std::fopen(tmppath.c_str(), "wb");
+    if (file == NULL)
         fatal("Can't open physical memory checkpoint file '%s'\n",
               filename);
 
-    uint64_t pass_size = 0;
-
-    // gzwrite fails if (int)len < 0 (gzwrite returns int)
-    for (uint64_t written = 0; written < range.size();
-         written += pass_size) {
-        pass_size = (uint64_t)INT_MAX < (range.size() - written) ?
-            (uint64_t)INT_MAX : (range.size() - written);
-
-        if (gzwrite(compressed_mem, pmem + written,
-                    (unsigned int) pass_size) != (int) pass_size) {
+    auto write = [&](const void *data, uint64_t size) {
+        if (size && std::fwrite(data, size, 1, file) != 1)
             fatal("Write failed on physical memory checkpoint file '%s'\n",
                   filename);
+    };
+
+    const uint64_t num_chunks = divCeil(range_size, chunk_size);
+    std::vector<uint64_t> index(num_chunks);
+
+    // the index offset is filled in once the chunks are written
+    uint64_t header[3] = { htole(chunk_size), htole(num_chunks), 0 };
+    write(checkpointCompress ? StoreMagic : StoreRawMagic,
+          sizeof(StoreMagic));
+    write(header, sizeof(header));
+    uint64_t offset = sizeof(StoreMagic) + sizeof(header);
+
+    // compress a batch of chunks at a time, which bounds the memory
+    // holding the compressed chunks that are not yet written
+    const uint64_t batch_size = checkpointThreads * 16;
+    std::vector<std::vector<uint8_t>> compressed(batch_size);
+    std::atomic<bool> failed(false);
+
+    for (uint64_t batch = 0; batch < num_chunks; batch += batch_size) {
+        const uint64_t batch_end = std::min(batch + batch_size, num_chunks);
+
+        forEachChunk(batch, batch_end, [&](uint64_t i) {
+            const uint8_t *data = pmem + i * chunk_size;
+            const uint64_t size = std::min(chunk_size,
+                                           range_size - i * chunk_size);
+            auto &buf = compressed[i - batch];
+            if (isZero(data, size)) {
+                buf.clear();
+                return;
+            }
+            if (!checkpointCompress) {
+                // only note that the chunk is to be written
+                buf.resize(1);
+                return;
+            }
+            uLongf buf_size = compressBound(size);
+            buf.resize(buf_size);
+            if (compress2(buf.data(), &buf_size, data, size,
+                          Z_BEST_SPEED) != Z_OK) {
+                failed = true;
+            }
+            buf.resize(buf_size);
+        });
+
+        if (failed)
+            fatal("Compression failed on physical memory checkpoint file "
+                  "'%s'\n", filename);
+
+        for (uint64_t i = batch; i < batch_end; i++) {
+            const auto &buf = compressed[i - batch];
+            if (checkpointCompress || buf.empty()) {
+                write(buf.data(), buf.size());
+                index[i] = htole<uint64_t>(buf.size());
+                offset += buf.size();
+                continue;
+            }
+
+            // skipping to the aligned offset leaves a hole in the file
+            const uint64_t size = std::min(chunk_size,
+                                           range_size - i * chunk_size);
+            offset = roundUp(offset, StoreRawAlign);
+            if (std::fseek(file, offset, SEEK_SET) != 0)
+                fatal("Seek failed on physical memory checkpoint file "
+                      "'%s'\n", filename);
+            write(pmem + i * chunk_size, size);
+            index[i] = htole(size);
+            offset += size;
         }
     }
 
-    // close the compressed stream and check that the exit status
-    // is zero
-    if (gzclose(compressed_mem))
+    write(index.data(), index.size() * sizeof(index[0]));
+
+    header[2] = htole(offset);
+    if (std::fseek(file, sizeof(StoreMagic), SEEK_SET) != 0)
+        fatal("Seek failed on physical memory checkpoint file '%s'\n",
+              filename);
+    write(header, sizeof(header));
+
+    if (std::fclose(file))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
               filename);
 
+    if (std::rename(tmppath.c_str(), filepath.c_str()))
+        fatal("Rename failed on physical memory checkpoint file '%s'\n",
+              filename);
+}
+
+void
+PhysicalMemory::checkMappedImages() const
+{
+    for (const auto &image : mappedImages) {
+        struct stat st;
+        fatal_if(fstat(image.fd, &st) || st.st_size != image.size ||
+                 st.st_mtime != image.mtime,
+                 "Physical memory checkpoint file '%s' changed while "
+                 "restored lazily, the memory no longer holds the "
+                 "checkpoint\n", image.filename);
+    }
 }
 
 void
@@ -434,8 +607,6 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
 void
 PhysicalMemory::unserializeStore(CheckpointIn &cp)
 {
-    const uint32_t chunk_size = 16384;
-
     unsigned int store_id;
     UNSERIALIZE_SCALAR(store_id);
 
@@ -443,11 +614,6 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     std::string filepath = cp.getCptDir() + "/" + filename;
 
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
-
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].pmem;
     AddrRange range = backingStore[store_id].range;
@@ -462,9 +628,28 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
+    uint64_t chunk_size = 0;
+    if (UNSERIALIZE_OPT_SCALAR(chunk_size))
+        unserializeChunked(filepath, filename, backingStore[store_id]);
+    else
+        unserializeStream(filepath, filename, pmem, range_size);
+}
+
+void
+PhysicalMemory::unserializeStream(const std::string &filepath,
+                                  const std::string &filename,
+                                  uint8_t *pmem, Addr range_size) const
+{
+    const uint32_t chunk_size = 16384;
+
+    // mmap memoryfile
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filename);
+
     uint64_t curr_size = 0;
     uint32_t bytes_read;
-    while (curr_size < range.size()) {
+    while (curr_size < range_size) {
         bytes_read = gzread(compressed_mem, pmem, chunk_size);
         if (bytes_read == 0)
             break;
@@ -477,5 +662,135 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
               filename);
 }
 
+void
+PhysicalMemory::unserializeChunked(const std::string &filepath,
+                                   const std::string &filename,
+                                   const BackingStoreEntry &store)
+{
+    uint8_t *pmem = store.pmem;
+    const Addr range_size = store.range.size();
+
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'", filename);
+
+    char magic[sizeof(StoreMagic)];
+    uint64_t header[3];
+    if (!preadAll(fd, magic, sizeof(magic), 0) ||
+        !preadAll(fd, header, sizeof(header), sizeof(magic)) ||
+        (std::memcmp(magic, StoreMagic, sizeof(magic)) != 0 &&
+         std::memcmp(magic, StoreRawMagic, sizeof(magic)) != 0)) {
+        fatal("Physical memory checkpoint file '%s' is not a chunked "
+              "memory image\n", filename);
+    }
+    const bool raw = std::memcmp(magic, StoreRawMagic, sizeof(magic)) == 0;
+
+    const uint64_t chunk_size = letoh(header[0]);
+    const uint64_t num_chunks = letoh(header[1]);
+    const uint64_t index_offset = letoh(header[2]);
+    fatal_if(chunk_size == 0 || num_chunks != divCeil(range_size, chunk_size),
+             "Physical memory checkpoint file '%s' has %d chunks of %d "
+             "bytes, which does not match its size\n", filename, num_chunks,
+             chunk_size);
+
+    std::vector<uint64_t> index(num_chunks);
+    if (!preadAll(fd, index.data(), num_chunks * sizeof(index[0]),
+                  index_offset)) {
+        fatal("Read failed on physical memory checkpoint file '%s'\n",
+              filename);
+    }
+
+    // the chunks are stored back to back, raw ones aligned
+    std::vector<uint64_t> offsets(num_chunks);
+    uint64_t offset = sizeof(StoreMagic) + sizeof(header);
+    for (uint64_t i = 0; i < num_chunks; i++) {
+        index[i] = letoh(index[i]);
+        if (raw && index[i])
+            offset = roundUp(offset, StoreRawAlign);
+        offsets[i] = offset;
+        offset += index[i];
+    }
+    // the index follows the chunks, so the file holds all of them, and
+    // no chunk mapped from it is past its end
+    fatal_if(offset > index_offset, "Physical memory checkpoint file '%s' "
+             "has chunks overlapping its index\n", filename);
+
+    // mapping the chunks over the backing store leaves the clean pages
+    // in the page cache, shared by all the simulations restoring the
+    // same checkpoint, and only reads the pages that are touched. This
+    // cannot be done to a shared backing store, which other processes
+    // map as well, nor with pages larger than the alignment of chunks.
+    const bool map_chunks = raw && lazyRestore && store.shmFd == -1 &&
+        StoreRawAlign % pageSize == 0 && chunk_size % pageSize == 0;
+    if (raw && lazyRestore && !map_chunks) {
+        warn("Reading rather than mapping physical memory checkpoint "
+             "file '%s'\n", filename);
+    }
+
+    std::atomic<bool> failed(false);
+    forEachChunk(0, num_chunks, [&](uint64_t i) {
+        uint8_t *data = pmem + i * chunk_size;
+        const uint64_t size = std::min(chunk_size,
+                                       range_size - i * chunk_size);
+        if (index[i] == 0 && map_chunks && size % pageSize == 0) {
+            // fresh anonymous pages are zero without touching them
+            void *map = mmap(data, size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANON | MAP_FIXED |
+                             (mmapUsingNoReserve ? MAP_NORESERVE : 0),
+                             -1, 0);
+            if (map == MAP_FAILED)
+                failed = true;
+            return;
+        } else if (index[i] == 0) {
+            // the store is normally fresh and thus zero already, so
+            // only write, and touch the pages, if it is not
+            if (!isZero(data, size))
+                std::memset(data, 0, size);
+            return;
+        }
+
+        if (raw && index[i] != size) {
+            failed = true;
+        } else if (map_chunks && size % pageSize == 0) {
+            void *map = mmap(data, size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_FIXED, fd, offsets[i]);
+            if (map == MAP_FAILED)
+                failed = true;
+        } else if (raw) {
+            if (!preadAll(fd, data, size, offsets[i]))
+                failed = true;
+        }
+        if (raw)
+            return;
+
+        std::vector<uint8_t> buf(index[i]);
+        uLongf data_size = size;
+        if (!preadAll(fd, buf.data(), buf.size(), offsets[i]) ||
+            uncompress(data, &data_size, buf.data(), buf.size()) != Z_OK ||
+            data_size != size) {
+            failed = true;
+        }
+    });
+
+    if (failed)
+        fatal("Read failed on physical memory checkpoint file '%s'\n",
+              filename);
+
+    // the mapped pages of the store are only read from the image once
+    // touched, so keep it open to check that it does not change
+    if (map_chunks && lazyRestoreCheck) {
+        struct stat st;
+        if (fstat(fd, &st))
+            fatal("Can't stat physical memory checkpoint file '%s'\n",
+                  filename);
+        mappedImages.push_back({filename, fd, st.st_size, st.st_mtime});
+        return;
+    }
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filename);
+}
+
 } // namespace memory
 } // namespace gem5
@@ -38,7 +38,11 @@
 #ifndef __MEM_PHYSICAL_HH__
 #define __MEM_PHYSICAL_HH__
 
+#include <sys/types.h>
+
 #include <cstdint>
+#include <ctime>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -135,6 +139,7 @@ class BackingStoreEntry
  */
 class PhysicalMemory : public Serializable
 {
+  friend class PhysicalMemoryTest;
 
   private:
 
@@ -158,6 +163,35 @@ class PhysicalMemory : public Serializable
 
     long pageSize;
 
+    // Host threads compressing and decompressing the memory images of
+    // checkpoints
+    const unsigned checkpointThreads;
+
+    // Store the chunks of memory images compressed rather than raw
+    const bool checkpointCompress;
+
+    // Map the raw chunks of memory images copy-on-write on restore,
+    // rather than reading them
+    const bool lazyRestore;
+
+    // Check that the memory images mapped on restore do not change
+    const bool lazyRestoreCheck;
+
+    /**
+     * A memory image mapped over a backing store, kept open to check
+     * that it is not changed. A change would show in the pages of the
+     * store not touched yet, and truncating the image would raise a
+     * SIGBUS on the next touch of one of its pages.
+     */
+    struct MappedImage
+    {
+        std::string filename;
+        int fd;
+        off_t size;
+        time_t mtime;
+    };
+    std::vector<MappedImage> mappedImages;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
@@ -191,7 +225,11 @@ class PhysicalMemory : public Serializable
                    const std::vector<AbstractMemory*>& _memories,
                    bool mmap_using_noreserve,
                    const std::string& shared_backstore,
-                   bool auto_unlink_shared_backstore);
+                   bool auto_unlink_shared_backstore,
+                   unsigned checkpoint_threads = 0,
+                   bool checkpoint_compress = true,
+                   bool lazy_restore = false,
+                   bool lazy_restore_check = true);
 
     /**
      * Unmap all the backing store we have used.
@@ -296,6 +334,43 @@ class PhysicalMemory : public Serializable
      */
     void unserializeStore(CheckpointIn &cp);
 
+  private:
+
+    /**
+     * Run a job on each of a range of chunks, spread over the
+     * checkpoint threads.
+     *
+     * @param first The first chunk
+     * @param last One past the last chunk
+     * @param job The job to run on a chunk
+     */
+    void forEachChunk(uint64_t first, uint64_t last,
+                      const std::function<void(uint64_t)> &job) const;
+
+    /**
+     * Read a memory image stored as a single gzip stream, the format
+     * of checkpoints taken before memory images were chunked.
+     */
+    void unserializeStream(const std::string &filepath,
+                           const std::string &filename, uint8_t *pmem,
+                           Addr range_size) const;
+
+    /**
+     * Read a chunked memory image, decompressing the chunks in
+     * parallel. Raw chunks are mapped from the file instead when
+     * restoring lazily.
+     */
+    void unserializeChunked(const std::string &filepath,
+                            const std::string &filename,
+                            const BackingStoreEntry &store);
+
+    /**
+     * Check that the memory images mapped on restore still have the
+     * size and modification time they had then, as a checkpoint taken
+     * from a store holding pages of a changed image would be wrong.
+     */
+    void checkMappedImages() const;
+
 };
 
 } // namespace memory
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "base/gtest/logging.hh"
+#include "base/gtest/serialization_fixture.hh"
+#include "mem/abstract_mem.hh"
+#include "mem/physical.hh"
+#include "sim/sim_exit.hh"
+
+using namespace gem5;
+using namespace gem5::memory;
+
+// Instantiate the fake class to have a valid curTick of 0
+GTestTickHandler tickHandler;
+
+namespace gem5
+{
+
+// Only a shared backing store registers a callback, no test uses one
+void
+registerExitCallback(const std::function<void()> &callback)
+{
+    panic("Not used by the tests");
+}
+
+namespace memory
+{
+
+// The physical memory only calls the memories it wraps, which would need
+// a whole system, and the tests have none.
+void
+AbstractMemory::setBackingStore(uint8_t *pmem_addr)
+{
+    panic("Not used by the tests");
+}
+
+void
+AbstractMemory::access(PacketPtr pkt)
+{
+    panic("Not used by the tests");
+}
+
+void
+AbstractMemory::functionalAccess(PacketPtr pkt)
+{
+    panic("Not used by the tests");
+}
+
+AddrRange
+AbstractMemory::getAddrRange() const
+{
+    panic("Not used by the tests");
+}
+
+/**
+ * A physical memory with a single backing store of three chunks and a
+ * page, so that the last chunk is a partial one. The memories are not
+ * needed to checkpoint the store, so there are none.
+ */
+class PhysicalMemoryTest : public SerializationFixture
+{
+  protected:
+    static const uint64_t chunkSize = 1 << 20;
+    const AddrRange range = AddrRange(0, 3 * chunkSize + 4096);
+
+    std::unique_ptr<PhysicalMemory>
+    create(bool compress, bool lazy_restore)
+    {
+        auto pmem = std::make_unique<PhysicalMemory>(
+            "pmem", std::vector<AbstractMemory *>(), false, "", false, 2,
+            compress, lazy_restore, true);
+        pmem->createBackingStore(range, {}, false, true, false);
+        return pmem;
+    }
+
+    static uint8_t *
+    store(const PhysicalMemory &pmem)
+    {
+        return pmem.backingStore[0].pmem;
+    }
+
+    static size_t
+    mappedImages(const PhysicalMemory &pmem)
+    {
+        return pmem.mappedImages.size();
+    }
+
+    std::string
+    imagePath() const
+    {
+        return getDirName() + "/pmem.store0.pmem";
+    }
+
+    /**
+     * Fill the store with a pattern, apart from the second chunk,
+     * which stays zero and is thus not stored.
+     */
+    void
+    fill(uint8_t *data)
+    {
+        for (uint64_t i = 0; i < range.size(); i++)
+            data[i] = i / chunkSize == 1 ? 0 : uint8_t(i * 7 + (i >> 12));
+    }
+
+    void
+    serialize(const PhysicalMemory &pmem)
+    {
+        CheckpointIn::setDir(getDirName());
+        std::ofstream cp(getCptPath());
+        pmem.serializeSection(cp, "pmem");
+    }
+
+    void
+    unserialize(PhysicalMemory &pmem)
+    {
+        CheckpointIn cp(getDirName());
+        pmem.unserializeSection(cp, "pmem");
+    }
+
+    /** Checkpoint a filled store and restore it into a dirty one. */
+    void
+    roundTrip(bool compress, bool lazy_restore)
+    {
+        auto saved = create(compress, false);
+        fill(store(*saved));
+        serialize(*saved);
+
+        // restoring must clear what the store held before
+        auto restored = create(compress, lazy_restore);
+        std::memset(store(*restored), 0xff, range.size());
+        unserialize(*restored);
+
+        ASSERT_EQ(std::memcmp(store(*saved), store(*restored),
+                              range.size()), 0);
+    }
+
+    void
+    TearDown() override
+    {
+        std::remove(imagePath().c_str());
+        SerializationFixture::TearDown();
+    }
+};
+
+} // namespace memory
+} // namespace gem5
+
+/** Compressed chunks restore to the memory they were taken from. */
+TEST_F(PhysicalMemoryTest, RoundTripCompressed)
+{
+    roundTrip(true, false);
+}
+
+/** Raw chunks read back restore to the memory they were taken from. */
+TEST_F(PhysicalMemoryTest, RoundTripRaw)
+{
+    roundTrip(false, false);
+}
+
+/** Raw chunks mapped lazily restore to the same memory. */
+TEST_F(PhysicalMemoryTest, RoundTripLazy)
+{
+    roundTrip(false, true);
+}
+
+/**
+ * The chunks are mapped copy-on-write, so writing the restored memory
+ * leaves the image untouched, and a second restore sees the original.
+ */
+TEST_F(PhysicalMemoryTest, LazyRestoreIsPrivate)
+{
+    auto saved = create(false, false);
+    fill(store(*saved));
+    serialize(*saved);
+
+    auto restored = create(false, true);
+    unserialize(*restored);
+    ASSERT_EQ(mappedImages(*restored), 1);
+    std::memset(store(*restored), 0x5a, range.size());
+
+    auto again = create(false, true);
+    unserialize(*again);
+    ASSERT_EQ(std::memcmp(store(*saved), store(*again), range.size()), 0);
+}
+
+/** A checkpoint of a store mapped from an image that changed fails. */
+TEST_F(PhysicalMemoryTest, ChangedImageIsDetected)
+{
+    auto saved = create(false, false);
+    fill(store(*saved));
+    serialize(*saved);
+
+    auto restored = create(false, true);
+    unserialize(*restored);
+    ASSERT_EQ(mappedImages(*restored), 1);
+
+    // growing the image leaves the mapped pages valid
+    std::FILE *image = std::fopen(imagePath().c_str(), "ab");
+    ASSERT_NE(image, nullptr);
+    std::fputc(0, image);
+    std::fclose(image);
+
+    gtestLogOutput.str("");
+    ASSERT_ANY_THROW(serialize(*restored));
+    ASSERT_NE(gtestLogOutput.str().find("changed while restored lazily"),
+              std::string::npos);
+}
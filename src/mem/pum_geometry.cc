@@ -0,0 +1,129 @@
+#include "mem/pum_geometry.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/pum_kernels.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+PUMGeometry::PUMGeometry(const Params &p) :
+    SimObject(p),
+    rows(p.rows_per_subarray),
+    rowBytes(p.row_bits / 8),
+    rowShift(rowBytes ? floorLog2(rowBytes) : 0),
+    rowMask(rows - 1),
+    checkMajInputs(p.check_maj_inputs),
+    majRows(p.maj_rows)
+{
+    fatal_if(p.row_bits % 8 || !isPowerOf2(rowBytes),
+             "%s: row_bits must be a power of two multiple of 8, got %d\n",
+             name(), p.row_bits);
+    fatal_if(!isPowerOf2(rows),
+             "%s: rows_per_subarray must be a power of two, got %d\n",
+             name(), rows);
+    fatal_if(majRows.size() != 3, "%s: need exactly three MAJ rows\n",
+             name());
+
+    std::vector<unsigned> reserved = {
+        p.zero_row, p.one_row, p.compare_row
+    };
+    reserved.insert(reserved.end(), majRows.begin(), majRows.end());
+    for (auto row : reserved) {
+        fatal_if(row >= rows, "%s: reserved row %d is outside a subarray "
+                 "of %d rows\n", name(), row, rows);
+        fatal_if(std::count(reserved.begin(), reserved.end(), row) != 1,
+                 "%s: row %d is reserved more than once\n", name(), row);
+    }
+
+    /**
+     * The constant rows are copied into the first MAJ row, the compare
+     * row into the second, and any data row into the third. A PUM op
+     * on one of the MAJ rows activates all three of them.
+     */
+    const auto dest = [this](unsigned maj) {
+        return RowAction{Op::Copy, Addr(majRows[maj]) << rowShift};
+    };
+    rowActions.assign(rows, dest(2));
+    rowActions[p.zero_row] = dest(0);
+    rowActions[p.one_row] = dest(0);
+    rowActions[p.compare_row] = dest(1);
+    for (auto row : majRows)
+        rowActions[row] = RowAction{Op::Majority, 0};
+}
+
+void
+PUMGeometry::checkRange(const AddrRange &range) const
+{
+    fatal_if(range.interleaved() && range.granularity() < rowBytes,
+             "%s: rows of %d bytes straddle the %d byte interleaving of "
+             "%s\n", name(), rowBytes, range.granularity(),
+             range.to_string());
+}
+
+uint8_t *
+PUMGeometry::hostAddr(const AddrRange &range, uint8_t *store,
+                      Addr offset) const
+{
+    // map an offset into the range back to where it lives in the store
+    if (!range.interleaved())
+        return store + offset;
+    const Addr start = range.start();
+    return store +
+        (range.addIntlvBits(offset + range.removeIntlvBits(start)) - start);
+}
+
+void
+PUMGeometry::executeAt(const Packet &pkt, Addr offset,
+                       const AddrRange &range, uint8_t *store) const
+{
+    const Addr base = subarrayBase(offset);
+    const RowAction &act = action(offset);
+    const int row_bits = rowBytes * 8;
+
+    const auto host = [this, &range, store](Addr row_offset) {
+        return hostAddr(range, store, row_offset);
+    };
+
+    if (act.op == Op::Majority) {
+        uint8_t *maj1 = host(base + (Addr(majRows[0]) << rowShift));
+        uint8_t *maj2 = host(base + (Addr(majRows[1]) << rowShift));
+        uint8_t *maj3 = host(base + (Addr(majRows[2]) << rowShift));
+        gem5_assert(!checkMajInputs ||
+                    (pum::isBitRow(maj1, rowBytes) &&
+                     pum::isBitRow(maj2, rowBytes) &&
+                     pum::isBitRow(maj3, rowBytes)),
+                    "MAJ inputs must be 0 or 1");
+        pkt.majority3PUM(maj1, maj2, maj3, row_bits);
+    } else {
+        pkt.rowclonePUM(host(base + act.destOffset),
+                        host(offset >> rowShift << rowShift), row_bits);
+    }
+}
+
+void
+PUMGeometry::execute(const Packet &pkt, const AddrRange &range,
+                     uint8_t *store) const
+{
+    if (!pkt.req->isPUMBatch()) {
+        executeAt(pkt, range.getOffset(pkt.getAddr()), range, store);
+        return;
+    }
+
+    const uint64_t count = pkt.pumBatchCount();
+    for (uint64_t i = 0; i < count; i++) {
+        const Addr addr = pkt.pumBatchTarget(i);
+        panic_if(!range.contains(addr), "%s: target %d (%#x) of a batched "
+                 "PUM op at %#x is outside %s\n", name(), i, addr,
+                 pkt.getAddr(), range.to_string());
+        executeAt(pkt, range.getOffset(addr), range, store);
+    }
+}
+
+} // namespace memory
+} // namespace gem5
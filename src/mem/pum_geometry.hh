@@ -0,0 +1,151 @@
+#ifndef __MEM_PUM_GEOMETRY_HH__
+#define __MEM_PUM_GEOMETRY_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/types.hh"
+#include "mem/packet.hh"
+#include "params/PUMGeometry.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * The subarray organisation seen by the processing-using-memory
+ * operations. It describes the size of a subarray, which of its rows
+ * are reserved for the constant, compare and MAJ inputs. The same
+ * object is handed to the functional model (AbstractMemory) and the
+ * timing model (Ramulator2) so that both agree on what an operation
+ * does. How the PUM space is spread over channels is up to the memory,
+ * e.g. the channels of a Ramulator2, which must hold whole subarrays.
+ *
+ * Subarrays are laid out over the offsets into the range of a memory,
+ * see AddrRange::getOffset(), i.e. with the interleaving bits of the
+ * range removed, which makes the mapping independent of where the
+ * backing store was placed in the host address space. A Ramulator2
+ * hands its channels the same offsets, split into per-channel slices.
+ */
+class PUMGeometry : public SimObject
+{
+  public:
+
+    /** The operation triggered by a PUM op on a row of a subarray. */
+    enum class Op : uint8_t
+    {
+        /** RowClone the row into one of the MAJ rows */
+        Copy,
+        /** Triple row activation of the three MAJ rows */
+        Majority
+    };
+
+    /** What a PUM op on a given row of a subarray turns into. */
+    struct RowAction
+    {
+        Op op;
+        /** Offset of the destination row from the subarray base */
+        Addr destOffset;
+    };
+
+  private:
+
+    /** Number of rows in a subarray */
+    const unsigned rows;
+
+    /**
+     * Number of bytes of a row. Every bit of the store is a bit cell,
+     * so a row of row_bits cells takes row_bits / 8 bytes, and a MAJ op
+     * computes the majority of each bit.
+     */
+    const unsigned rowBytes;
+
+    /** log2(rowBytes) */
+    const unsigned rowShift;
+
+    /** Mask selecting the row within a subarray from a row index */
+    const Addr rowMask;
+
+    /**
+     * Check that MAJ inputs hold a 0/1 per byte (not in fast builds),
+     * for workloads that only use the lowest cell of each byte.
+     */
+    const bool checkMajInputs;
+
+    /** Reserved rows holding the MAJ inputs */
+    std::vector<unsigned> majRows;
+
+    /** Per row of a subarray, the action a PUM op on it performs */
+    std::vector<RowAction> rowActions;
+
+    /** Host address of an offset into the range */
+    uint8_t *hostAddr(const AddrRange &range, uint8_t *store,
+                      Addr offset) const;
+
+    /** Perform the PUM op on the row holding an offset into the range */
+    void executeAt(const Packet &pkt, Addr offset, const AddrRange &range,
+                   uint8_t *store) const;
+
+  public:
+
+    PARAMS(PUMGeometry);
+    PUMGeometry(const Params &p);
+
+    /** Size of a row in bytes */
+    unsigned rowSize() const { return rowBytes; }
+
+    /** Size of a subarray in bytes */
+    Addr subarraySize() const { return Addr(rows) << rowShift; }
+
+    /** Offset of the first byte of the subarray holding the offset */
+    Addr
+    subarrayBase(Addr offset) const
+    {
+        return (offset >> rowShift & ~rowMask) << rowShift;
+    }
+
+    /**
+     * Look up what a PUM op on the row holding the given offset does.
+     * This is a single table lookup, the shifts and masks replace the
+     * divisions that would otherwise be needed.
+     */
+    const RowAction &
+    action(Addr offset) const
+    {
+        return rowActions[offset >> rowShift & rowMask];
+    }
+
+    /** True if a PUM op at the offset is a triple row activation */
+    bool
+    isMajority(Addr offset) const
+    {
+        return action(offset).op == Op::Majority;
+    }
+
+    /**
+     * Check that rows do not straddle the interleaving boundaries of a
+     * memory range, so that every row is contiguous in the store.
+     */
+    void checkRange(const AddrRange &range) const;
+
+    /**
+     * Functionally perform the PUM op of a packet on a backing store.
+     * A batched op is performed on each of its targets in turn, all of
+     * which must lie within the range.
+     *
+     * @param pkt The PUM or MAJ packet
+     * @param range The address range of the memory
+     * @param store Host address the start of the range is mapped to
+     */
+    void execute(const Packet &pkt, const AddrRange &range,
+                 uint8_t *store) const;
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_PUM_GEOMETRY_HH__
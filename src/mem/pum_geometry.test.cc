@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "base/gtest/logging.hh"
+#include "mem/packet.hh"
+#include "mem/pum_geometry.hh"
+#include "mem/request.hh"
+#include "params/PUMGeometry.hh"
+
+using namespace gem5;
+using namespace gem5::memory;
+
+namespace
+{
+
+// Instantiate the fake class to have a valid curTick of 0
+GTestTickHandler tickHandler;
+
+const unsigned rowBytes = 64;
+const unsigned rows = 16;
+
+/**
+ * A single subarray of 16 rows of 64 B, with the default reserved rows:
+ * 0 and 1 hold the constants, 2 the compare input and 3 to 5 are the
+ * MAJ rows.
+ */
+class PUMGeometryTest : public testing::Test
+{
+  protected:
+    std::vector<uint8_t> store;
+    const AddrRange range;
+
+    PUMGeometryTest()
+      : store(rows * rowBytes), range(0, rows * rowBytes)
+    {}
+
+    static PUMGeometryParams
+    params(bool check_maj_inputs)
+    {
+        PUMGeometryParams p;
+        p.name = "pum_geometry";
+        p.eventq_index = 0;
+        p.rows_per_subarray = rows;
+        p.row_bits = rowBytes * 8;
+        p.zero_row = 0;
+        p.one_row = 1;
+        p.compare_row = 2;
+        p.maj_rows = {3, 4, 5};
+        p.check_maj_inputs = check_maj_inputs;
+        return p;
+    }
+
+    uint8_t *row(unsigned r) { return store.data() + r * rowBytes; }
+
+    void
+    fillRow(unsigned r, uint8_t value)
+    {
+        std::fill(row(r), row(r) + rowBytes, value);
+    }
+
+    /** Perform a MAJ op, i.e. a PUM op on one of the MAJ rows. */
+    void
+    majority(const PUMGeometry &geometry)
+    {
+        RequestPtr req = std::make_shared<Request>(
+            3 * rowBytes, rowBytes, Request::PUM, 0);
+        Packet pkt(req, MemCmd::WriteReq);
+        geometry.execute(pkt, range, store.data());
+    }
+};
+
+} // anonymous namespace
+
+/** With the check on, rows of 0/1 bytes get their per-byte majority. */
+TEST_F(PUMGeometryTest, CheckedMajorityOfBits)
+{
+    const PUMGeometryParams p = params(true);
+    PUMGeometry geometry(p);
+    for (unsigned i = 0; i < rowBytes; i++) {
+        row(3)[i] = i & 1;
+        row(4)[i] = (i >> 1) & 1;
+        row(5)[i] = (i >> 2) & 1;
+    }
+
+    majority(geometry);
+
+    for (unsigned i = 0; i < rowBytes; i++) {
+        const uint8_t expected = ((i & 1) + ((i >> 1) & 1) +
+                                  ((i >> 2) & 1)) >> 1;
+        ASSERT_EQ(row(3)[i], expected) << "byte " << i;
+        ASSERT_EQ(row(4)[i], expected) << "byte " << i;
+        ASSERT_EQ(row(5)[i], expected) << "byte " << i;
+    }
+}
+
+/** With the check on, packed bits in the MAJ rows are an error. */
+TEST_F(PUMGeometryTest, CheckedMajorityRejectsPackedBits)
+{
+#ifdef NDEBUG
+    GTEST_SKIP() << "Skipping as assertions are stripped from fast builds.";
+#endif
+    const PUMGeometryParams p = params(true);
+    PUMGeometry geometry(p);
+    fillRow(3, 0xf0);
+    fillRow(4, 0xcc);
+    fillRow(5, 0xaa);
+
+    gtestLogOutput.str("");
+    ASSERT_ANY_THROW(majority(geometry));
+    ASSERT_NE(gtestLogOutput.str().find("MAJ inputs must be 0 or 1"),
+              std::string::npos);
+}
+
+/** With the check off, packed bits get the majority of each bit. */
+TEST_F(PUMGeometryTest, UncheckedMajorityIsBitwise)
+{
+    const PUMGeometryParams p = params(false);
+    PUMGeometry geometry(p);
+    fillRow(3, 0xf0);
+    fillRow(4, 0xcc);
+    fillRow(5, 0xaa);
+
+    majority(geometry);
+
+    // 0xe8 is the truth table of the three input majority function
+    for (unsigned r : {3, 4, 5}) {
+        for (unsigned i = 0; i < rowBytes; i++)
+            ASSERT_EQ(row(r)[i], 0xe8) << "row " << r << " byte " << i;
+    }
+}
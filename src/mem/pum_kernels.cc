@@ -0,0 +1,165 @@
+#include "mem/pum_kernels.hh"
+
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PUM_KERNELS_X86 1
+#include <immintrin.h>
+#else
+#define PUM_KERNELS_X86 0
+#endif
+
+namespace gem5
+{
+
+namespace memory
+{
+
+namespace pum
+{
+
+namespace
+{
+
+typedef void (*Majority3Fn)(uint8_t *, uint8_t *, uint8_t *, std::size_t);
+
+inline uint64_t
+majWord(uint64_t a, uint64_t b, uint64_t c)
+{
+    return (a & b) | (c & (a | b));
+}
+
+/**
+ * Portable kernel, 64 bits at a time. The loads and stores go through
+ * memcpy so the rows do not have to be word aligned.
+ */
+void
+majority3Scalar(uint8_t *row1, uint8_t *row2, uint8_t *row3,
+                std::size_t bytes)
+{
+    std::size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+        uint64_t a, b, c;
+        std::memcpy(&a, row1 + i, sizeof(a));
+        std::memcpy(&b, row2 + i, sizeof(b));
+        std::memcpy(&c, row3 + i, sizeof(c));
+        const uint64_t m = majWord(a, b, c);
+        std::memcpy(row1 + i, &m, sizeof(m));
+        std::memcpy(row2 + i, &m, sizeof(m));
+        std::memcpy(row3 + i, &m, sizeof(m));
+    }
+    for (; i < bytes; i++) {
+        const uint8_t m = majWord(row1[i], row2[i], row3[i]);
+        row1[i] = row2[i] = row3[i] = m;
+    }
+}
+
+#if PUM_KERNELS_X86
+
+__attribute__((target("avx2"))) void
+majority3AVX2(uint8_t *row1, uint8_t *row2, uint8_t *row3,
+              std::size_t bytes)
+{
+    std::size_t i = 0;
+    for (; i + sizeof(__m256i) <= bytes; i += sizeof(__m256i)) {
+        const __m256i a = _mm256_loadu_si256((const __m256i *)(row1 + i));
+        const __m256i b = _mm256_loadu_si256((const __m256i *)(row2 + i));
+        const __m256i c = _mm256_loadu_si256((const __m256i *)(row3 + i));
+        const __m256i m = _mm256_or_si256(_mm256_and_si256(a, b),
+            _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        _mm256_storeu_si256((__m256i *)(row1 + i), m);
+        _mm256_storeu_si256((__m256i *)(row2 + i), m);
+        _mm256_storeu_si256((__m256i *)(row3 + i), m);
+    }
+    majority3Scalar(row1 + i, row2 + i, row3 + i, bytes - i);
+}
+
+__attribute__((target("avx512f"))) void
+majority3AVX512(uint8_t *row1, uint8_t *row2, uint8_t *row3,
+                std::size_t bytes)
+{
+    std::size_t i = 0;
+    for (; i + sizeof(__m512i) <= bytes; i += sizeof(__m512i)) {
+        const __m512i a = _mm512_loadu_si512(row1 + i);
+        const __m512i b = _mm512_loadu_si512(row2 + i);
+        const __m512i c = _mm512_loadu_si512(row3 + i);
+        // 0xe8 is the truth table of the three input majority function
+        const __m512i m = _mm512_ternarylogic_epi64(a, b, c, 0xe8);
+        _mm512_storeu_si512(row1 + i, m);
+        _mm512_storeu_si512(row2 + i, m);
+        _mm512_storeu_si512(row3 + i, m);
+    }
+    majority3Scalar(row1 + i, row2 + i, row3 + i, bytes - i);
+}
+
+#endif // PUM_KERNELS_X86
+
+struct Kernel
+{
+    Majority3Fn majority3;
+    const char *name;
+};
+
+Kernel
+selectKernel()
+{
+#if PUM_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return { majority3AVX512, "avx512" };
+    if (__builtin_cpu_supports("avx2"))
+        return { majority3AVX2, "avx2" };
+#endif
+    return { majority3Scalar, "scalar" };
+}
+
+const Kernel &
+kernel()
+{
+    static const Kernel k = selectKernel();
+    return k;
+}
+
+} // anonymous namespace
+
+void
+rowCopy(uint8_t *dest, const uint8_t *src, std::size_t bytes)
+{
+    // copying a row onto itself is a no-op, and memcpy does not allow
+    // the two ranges to be the same
+    if (dest != src)
+        std::memcpy(dest, src, bytes);
+}
+
+void
+majority3(uint8_t *row1, uint8_t *row2, uint8_t *row3, std::size_t bytes)
+{
+    kernel().majority3(row1, row2, row3, bytes);
+}
+
+bool
+isBitRow(const uint8_t *row, std::size_t bytes)
+{
+    // OR all bytes together and look for anything above bit 0 once,
+    // rather than branching on every byte
+    uint64_t acc = 0;
+    std::size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+        uint64_t w;
+        std::memcpy(&w, row + i, sizeof(w));
+        acc |= w;
+    }
+    for (; i < bytes; i++)
+        acc |= row[i];
+    return (acc & ~0x0101010101010101ULL) == 0;
+}
+
+const char *
+kernelName()
+{
+    return kernel().name;
+}
+
+} // namespace pum
+} // namespace memory
+} // namespace gem5
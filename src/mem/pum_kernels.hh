@@ -0,0 +1,61 @@
+#ifndef __MEM_PUM_KERNELS_HH__
+#define __MEM_PUM_KERNELS_HH__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * Functional kernels for the processing-using-memory row operations.
+ * They work on whole rows a machine word (or vector register) at a
+ * time and contain no data dependent branches; the best implementation
+ * supported by the host is picked once at startup.
+ */
+namespace pum
+{
+
+/**
+ * Copy an entire row (RowClone).
+ *
+ * @param dest First byte of the destination row
+ * @param src First byte of the source row
+ * @param bytes Size of a row in bytes
+ */
+void rowCopy(uint8_t *dest, const uint8_t *src, std::size_t bytes);
+
+/**
+ * Compute the bitwise majority of three rows (triple row activation)
+ * and overwrite all three rows with the result. For rows holding one
+ * 0/1 value per byte this is the same as the per-byte majority.
+ *
+ * @param row1 First byte of the first row
+ * @param row2 First byte of the second row
+ * @param row3 First byte of the third row
+ * @param bytes Size of a row in bytes
+ */
+void majority3(uint8_t *row1, uint8_t *row2, uint8_t *row3,
+               std::size_t bytes);
+
+/**
+ * Check that every byte of a row is either 0 or 1. Meant for
+ * validating MAJ inputs in debug builds only.
+ *
+ * @param row First byte of the row
+ * @param bytes Size of a row in bytes
+ * @return true if the row only holds 0/1 bytes
+ */
+bool isBitRow(const uint8_t *row, std::size_t bytes);
+
+/** The name of the kernel implementation picked for this host. */
+const char *kernelName();
+
+} // namespace pum
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_PUM_KERNELS_HH__
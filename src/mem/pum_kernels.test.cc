@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mem/pum_kernels.hh"
+
+using namespace gem5::memory;
+
+namespace
+{
+
+/** The per-byte majority the kernels must reproduce for 0/1 rows. */
+uint8_t
+referenceMajority(uint8_t a, uint8_t b, uint8_t c)
+{
+    return (a + b + c) >> 1;
+}
+
+std::vector<uint8_t>
+randomBitRow(std::mt19937 &rng, std::size_t bytes)
+{
+    std::vector<uint8_t> row(bytes);
+    for (auto &b : row)
+        b = rng() & 1;
+    return row;
+}
+
+} // anonymous namespace
+
+/** Rows of 0/1 bytes get the same result as the per-byte majority. */
+TEST(PUMKernelsTest, MajorityMatchesPerByteReference)
+{
+    std::mt19937 rng(0);
+    // cover the vector bodies as well as odd sized tails
+    for (std::size_t bytes : {1, 7, 8, 31, 64, 100, 128, 1000}) {
+        auto a = randomBitRow(rng, bytes);
+        auto b = randomBitRow(rng, bytes);
+        auto c = randomBitRow(rng, bytes);
+
+        std::vector<uint8_t> expected(bytes);
+        for (std::size_t i = 0; i < bytes; i++)
+            expected[i] = referenceMajority(a[i], b[i], c[i]);
+
+        pum::majority3(a.data(), b.data(), c.data(), bytes);
+
+        EXPECT_EQ(expected, a) << "bytes=" << bytes;
+        EXPECT_EQ(expected, b) << "bytes=" << bytes;
+        EXPECT_EQ(expected, c) << "bytes=" << bytes;
+    }
+}
+
+/** Full bytes are treated as eight independent bit columns. */
+TEST(PUMKernelsTest, MajorityIsBitwise)
+{
+    std::vector<uint8_t> a(130, 0xf0), b(130, 0xcc), c(130, 0xaa);
+    pum::majority3(a.data(), b.data(), c.data(), a.size());
+
+    for (std::size_t i = 0; i < a.size(); i++) {
+        EXPECT_EQ(0xe8, a[i]);
+        EXPECT_EQ(0xe8, b[i]);
+        EXPECT_EQ(0xe8, c[i]);
+    }
+}
+
+/** Rows do not need to be word aligned. */
+TEST(PUMKernelsTest, MajorityUnaligned)
+{
+    std::vector<uint8_t> buf(3 * 200, 0);
+    uint8_t *a = buf.data() + 1;
+    uint8_t *b = buf.data() + 203;
+    uint8_t *c = buf.data() + 405;
+    for (int i = 0; i < 150; i++) {
+        a[i] = 1;
+        b[i] = i & 1;
+        c[i] = 0;
+    }
+
+    pum::majority3(a, b, c, 150);
+
+    for (int i = 0; i < 150; i++)
+        EXPECT_EQ(i & 1, a[i]);
+    // the bytes around the rows are left alone
+    EXPECT_EQ(0, buf[0]);
+    EXPECT_EQ(0, buf[151]);
+    EXPECT_EQ(0, buf[202]);
+}
+
+TEST(PUMKernelsTest, RowCopy)
+{
+    std::vector<uint8_t> src(128), dest(128, 0);
+    for (std::size_t i = 0; i < src.size(); i++)
+        src[i] = i;
+
+    pum::rowCopy(dest.data(), src.data(), src.size());
+    EXPECT_EQ(src, dest);
+
+    // copying a row onto itself keeps it intact
+    pum::rowCopy(dest.data(), dest.data(), dest.size());
+    EXPECT_EQ(src, dest);
+}
+
+TEST(PUMKernelsTest, IsBitRow)
+{
+    std::vector<uint8_t> row(67, 1);
+    row[3] = 0;
+    EXPECT_TRUE(pum::isBitRow(row.data(), row.size()));
+
+    // a stray bit in the word body
+    row[10] = 2;
+    EXPECT_FALSE(pum::isBitRow(row.data(), row.size()));
+
+    // and in the tail
+    row[10] = 1;
+    row[66] = 0x80;
+    EXPECT_FALSE(pum::isBitRow(row.data(), row.size()));
+}
+
+TEST(PUMKernelsTest, KernelName)
+{
+    EXPECT_NE(nullptr, pum::kernelName());
+}
@@ -1,9 +1,19 @@
 #include "mem/ramulator2.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
 #include "base/callback.hh"
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/Ramulator2.hh"
 #include "debug/Drain.hh"
+#include "mem/pum_geometry.hh"
 #include "sim/system.hh"
 
 // spdlog collides with gem5...
@@ -22,26 +32,214 @@ namespace gem5
 namespace memory
 {
 
+/**
+ * Give every output file a Ramulator2 config names, e.g. the path of a
+ * trace or command counter plugin, a place in the output directory and
+ * a suffix, so that channels created from the same config do not
+ * overwrite each other's files.
+ */
+static void
+channelOutputs(YAML::Node node, const std::string &dir,
+               const std::string &suffix)
+{
+    if (node.IsSequence()) {
+        for (auto child : node)
+            channelOutputs(child, dir, suffix);
+        return;
+    }
+    if (!node.IsMap())
+        return;
+
+    for (auto it = node.begin(); it != node.end(); ++it) {
+        if (it->first.as<std::string>() != "path" ||
+            !it->second.IsScalar()) {
+            channelOutputs(it->second, dir, suffix);
+            continue;
+        }
+
+        std::string path = it->second.as<std::string>();
+        if (!dir.empty() && !path.empty() && path[0] != '/') {
+            std::filesystem::create_directories(dir);
+            path = dir + "/" + path;
+        }
+        it->second = path + suffix;
+    }
+}
+
+/**
+ * A fixed set of worker threads that run one job per handoff of one or
+ * more DRAM cycles, with the simulation thread taking part as thread 0.
+ * A cycle is far too short to go through a mutex and condition variable
+ * each time, so the workers spin on a generation counter and only go to
+ * sleep once they have seen no work for a while, e.g. while the memory
+ * idles. Idle stretches and the cycles of a tick event before the next
+ * arrival are handed over in one go, but while requests arrive every
+ * cycle each cycle is still a handoff of its own, and the channels only
+ * tick in parallel between two of them.
+ */
+class Ramulator2::TickPool
+{
+  private:
+    /** Spins after which an idle worker goes to sleep */
+    static constexpr unsigned SpinLimit = 1 << 14;
+
+    const std::function<void(unsigned)> job;
+    std::vector<std::thread> workers;
+
+    /** Bumped to start a round of jobs */
+    std::atomic<uint64_t> generation{0};
+    /** Workers yet to finish the current round */
+    std::atomic<unsigned> pending{0};
+    /** Workers sleeping on the condition variable */
+    std::atomic<unsigned> sleepers{0};
+    std::atomic<bool> stopping{false};
+
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    void
+    wake()
+    {
+        // the generation is bumped before the sleepers are counted,
+        // and a worker counts itself before checking the generation,
+        // so either the worker sees the new round or it gets notified
+        if (sleepers.load()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            cond.notify_all();
+        }
+    }
+
+    void
+    loop(unsigned thread)
+    {
+        uint64_t seen = 0;
+        while (true) {
+            unsigned spins = 0;
+            while (generation.load() == seen) {
+                if (++spins < SpinLimit) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(mutex);
+                sleepers.fetch_add(1);
+                cond.wait(lock, [&] { return generation.load() != seen; });
+                sleepers.fetch_sub(1);
+            }
+            // no new round starts before this one is done, so no
+            // generation can be missed
+            seen = generation.load();
+            if (stopping.load())
+                return;
+
+            job(thread);
+            pending.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+  public:
+    TickPool(unsigned threads, std::function<void(unsigned)> _job)
+        : job(std::move(_job))
+    {
+        for (unsigned t = 1; t < threads; t++)
+            workers.emplace_back([this, t] { loop(t); });
+    }
+
+    ~TickPool()
+    {
+        stopping.store(true);
+        generation.fetch_add(1);
+        wake();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    /** Run the job on every thread and wait for all of them */
+    void
+    run()
+    {
+        pending.store(workers.size(), std::memory_order_relaxed);
+        generation.fetch_add(1);
+        wake();
+
+        job(0);
+
+        while (pending.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+};
+
 Ramulator2::Ramulator2(const Params &p) :
     AbstractMemory(p),
     port(name() + ".port", *this),
     config_path(p.config_path),
     output_dir(p.output_dir),
+    channels(p.channels),
+    channelInterleave(p.channel_interleave),
+    channelSize(0),
+    tickThreads(std::max(1u, std::min(p.tick_threads, p.channels))),
+    poolCycles(0),
     retryReq(false), retryResp(false), startTick(0),
-    nbrOutstandingReads(0), nbrOutstandingWrites(0),
+    slots(p.max_outstanding, nullptr),
+    batchPkt(nullptr), batchNext(0),
+    frontendLatency(p.static_frontend_latency),
+    backendLatency(p.static_backend_latency),
+    tickBatching(p.tick_batching),
+    cyclesPerEvent(1), cycleTick(0),
+    finishEvent([this]{ processFinishes(); }, name()),
     sendResponseEvent([this]{ sendResponse(); }, name()),
-    tickEvent([this]{ tick(); }, name())
+    tickEvent([this]{ tick(); }, name()),
+    skipIdleCycles(p.skip_idle_cycles),
+    tCKTicks(0), nextCycleTick(0), dumpedCycles(0),
+    ramStats(*this)
 {
     DPRINTF(Ramulator2, "Instantiated Ramulator2 \n");
+    fatal_if(channels.empty(), "%s: needs at least one channel\n", name());
+    fatal_if(channels.size() > 1 && channelInterleave &&
+             !isPowerOf2(channelInterleave),
+             "%s: channel_interleave must be a power of two\n", name());
+    fatal_if(channels.size() > 1 && !channelInterleave &&
+             range.size() % channels.size(),
+             "%s: %s does not split into %d channels\n", name(),
+             range.to_string(), channels.size());
+    channelSize = range.size() / channels.size();
+
+    // a subarray spread over several channels would make the PUM
+    // timing disagree with the functional model
+    if (pumGeometry && channels.size() > 1) {
+        const Addr subarray = pumGeometry->subarraySize();
+        fatal_if(channelInterleave ? channelInterleave < subarray :
+                 channelSize % subarray,
+                 "%s: channels must hold whole subarrays of %d bytes\n",
+                 name(), subarray);
+    }
+
+    fatal_if(slots.empty(), "%s: max_outstanding must be at least one\n",
+             name());
+
+    // hand out the lowest slots first
+    freeSlots.reserve(slots.size());
+    for (unsigned slot = slots.size(); slot > 0; --slot)
+        freeSlots.push_back(slot - 1);
+
     printf("[ramulator2.cc] config_path=%s\n",
             config_path.c_str());
 
     registerExitCallback([this]() {
-        ramulator2_frontend->finalize();
-        ramulator2_memorysystem->finalize();
+        // bring an idle memory system up to date so that the cycle
+        // counts Ramulator2 reports match the always-ticking mode
+        if (!tickEvent.scheduled())
+            fastForward(curTick() + 1);
+        for (auto &chan : channels) {
+            chan.frontend->finalize();
+            chan.memorySystem->finalize();
+        }
     });
 }
 
+Ramulator2::~Ramulator2()
+{
+}
+
 void
 Ramulator2::init()
 {
@@ -53,12 +251,28 @@ Ramulator2::init()
         port.sendRangeChange();
     }
 
-    YAML::Node config = Ramulator::Config::parse_config_file(config_path, {});
-    ramulator2_frontend = Ramulator::Factory::create_frontend(config);
-    ramulator2_memorysystem = Ramulator::Factory::create_memory_system(config);
+    // every channel is a complete memory system of its own, the config
+    // is expected to describe a single channel
+    for (unsigned c = 0; c < channels.size(); c++) {
+        Channel &chan = channels[c];
+        YAML::Node config =
+            Ramulator::Config::parse_config_file(config_path, {});
+        channelOutputs(config, output_dir,
+                       channels.size() > 1 ? csprintf(".ch%d", c) : "");
+        chan.frontend = Ramulator::Factory::create_frontend(config);
+        chan.memorySystem = Ramulator::Factory::create_memory_system(config);
+
+        chan.frontend->connect_memory_system(chan.memorySystem);
+        chan.memorySystem->connect_frontend(chan.frontend);
+    }
 
-    ramulator2_frontend->connect_memory_system(ramulator2_memorysystem);
-    ramulator2_memorysystem->connect_frontend(ramulator2_frontend);
+    if (tickThreads > 1) {
+        // thread t ticks channels t, t + tickThreads, ...
+        tickPool.reset(new TickPool(tickThreads, [this](unsigned thread) {
+            for (unsigned c = thread; c < channels.size(); c += tickThreads)
+                channels[c].tick(poolCycles);
+        }));
+    }
 
     // if (system()->cacheLineSize() != wrapper.burstSize())
     //     fatal("Ramulator2 burst size %d does not match cache line size %d\n",
@@ -69,12 +283,33 @@ void
 Ramulator2::startup()
 {
     startTick = curTick();
+    tCKTicks = channels[0].memorySystem->get_tCK() *
+        sim_clock::as_float::ns;
+    fatal_if(tCKTicks == 0, "Ramulator2 %s has a zero tCK\n", name());
+
+    // a request arriving at or after a tick event is not handed to
+    // Ramulator2 before the frontend latency has passed, so the cycles
+    // up to then can all be simulated by that event
+    if (tickBatching)
+        cyclesPerEvent = std::max<Tick>(1, frontendLatency / tCKTicks);
+    DPRINTF(Ramulator2, "Simulating %d DRAM cycles per tick event\n",
+            cyclesPerEvent);
+
     DPRINTF(Ramulator2, "startup and schedule tickEvent\n");
     //kick off the clock ticks
-    schedule(tickEvent, clockEdge());}
+    nextCycleTick = clockEdge();
+    schedule(tickEvent, nextCycleTick);
+}
+
+void
+Ramulator2::regProbePoints()
+{
+    ppRequest.reset(new probing::Packet(getProbeManager(), "PktRequest"));
+}
 
 void
 Ramulator2::resetStats() {
+    AbstractMemory::resetStats();
     // wrapper.resetStats();
 }
 
@@ -86,16 +321,16 @@ Ramulator2::sendResponse()
 
     DPRINTF(Ramulator2, "Attempting to send response\n");
 
-    bool success = port.sendTimingResp(responseQueue.front());
+    bool success = port.sendTimingResp(responseQueue.front().second);
     if (success) {
         responseQueue.pop_front();
 
-        DPRINTF(Ramulator2, "Have %d read, %d write, %d responses outstanding\n",
-                nbrOutstandingReads, nbrOutstandingWrites, nbrOutstandingPUMs,
-                responseQueue.size());
+        DPRINTF(Ramulator2, "Have %d requests, %d responses outstanding\n",
+                nbrInFlight(), responseQueue.size());
 
         if (!responseQueue.empty() && !sendResponseEvent.scheduled())
-            schedule(sendResponseEvent, curTick());
+            schedule(sendResponseEvent,
+                     std::max(curTick(), responseQueue.front().first));
 
         if (nbrOutstanding() == 0)
             signalDrainDone();
@@ -111,26 +346,254 @@ Ramulator2::sendResponse()
 unsigned int
 Ramulator2::nbrOutstanding() const
 {
-    return nbrOutstandingReads + nbrOutstandingWrites + nbrOutstandingPUMs + responseQueue.size();
+    return nbrInFlight() + (batchPkt ? 1 : 0) + arrivals.size() +
+        finishes.size() + responseQueue.size();
+}
+
+bool
+Ramulator2::memorySystemIdle() const
+{
+    return nbrInFlight() == 0 && !batchPkt && arrivals.empty();
 }
 
 void
 Ramulator2::tick()
 {
+    Tick last_cycle = curTick();
+
     // Only tick when it's timing mode
     if (system()->isTimingMode()) {
-        ramulator2_memorysystem->tick();
+        ++ramStats.tickEvents;
+
+        for (unsigned cycle = 0; cycle < cyclesPerEvent;) {
+            cycleTick = curTick() + cycle * tCKTicks;
+
+            injectArrivals();
+
+            // the channels get the cycles up to the next arrival in one
+            // go, the cycles of a batch one by one
+            uint64_t cycles = cyclesPerEvent - cycle;
+            if (batchPkt) {
+                cycles = 1;
+            } else if (!arrivals.empty()) {
+                const Tick due = arrivals.front().first;
+                cycles = std::min<uint64_t>(cycles, due > cycleTick ?
+                    divCeil(due - cycleTick, tCKTicks) : 1);
+            }
+
+            tickChannels(cycles);
+            ramStats.cycles += cycles;
+            cycle += cycles;
+            last_cycle = cycleTick;
+
+            // carry on with a batch Ramulator2 could not take in one go
+            if (batchPkt)
+                issueBatch();
+
+            // nothing for the rest of the cycles to do, leave them to
+            // the idle skipping
+            if (skipIdleCycles && memorySystemIdle())
+                break;
+        }
 
         // is the connected port waiting for a retry, if so check the
         // state and send a retry if conditions have changed
-        if (retryReq) {
-            retryReq = false;
-            port.sendRetryReq();
+        trySendRetry();
+    }
+
+    nextCycleTick = last_cycle + tCKTicks;
+
+    // with nothing in flight there is nothing a DRAM cycle can
+    // complete, so stop the clock until the next request arrives
+    if (skipIdleCycles && memorySystemIdle() && !retryReq) {
+        DPRINTF(Ramulator2, "Idle, descheduling tickEvent\n");
+        return;
+    }
+
+    schedule(tickEvent, nextCycleTick);
+}
+
+void
+Ramulator2::trySendRetry()
+{
+    if (!retryReq || batchPkt)
+        return;
+
+    if (frontendLatency && nbrInFlight() + arrivals.size() >= slots.size())
+        return;
+
+    retryReq = false;
+    port.sendRetryReq();
+}
+
+void
+Ramulator2::injectArrivals()
+{
+    while (!arrivals.empty() && arrivals.front().first <= cycleTick) {
+        if (!admit(arrivals.front().second))
+            return;
+        arrivals.pop_front();
+    }
+}
+
+void
+Ramulator2::finish(unsigned slot, PacketPtr posted)
+{
+    // everything before this cycle was either done already or is
+    // queued, so doing it now keeps the order
+    if (cycleTick <= curTick()) {
+        if (posted)
+            accessAndRespond(posted);
+        else
+            complete(slot);
+        return;
+    }
+
+    finishes.push_back(Finish{cycleTick, slot, posted});
+    if (!finishEvent.scheduled())
+        schedule(finishEvent, cycleTick);
+}
+
+void
+Ramulator2::processFinishes()
+{
+    while (!finishes.empty() && finishes.front().when <= curTick()) {
+        const Finish f = finishes.front();
+        finishes.pop_front();
+        if (f.posted)
+            accessAndRespond(f.posted);
+        else
+            complete(f.slot);
+    }
+
+    // the slots freed by a cycle ahead of the tick event take a
+    // retried request now, as they would have when always ticking
+    trySendRetry();
+
+    if (!finishes.empty())
+        schedule(finishEvent, finishes.front().when);
+    else if (nbrOutstanding() == 0)
+        signalDrainDone();
+}
+
+void
+Ramulator2::Channel::tick(uint64_t cycles)
+{
+    for (cycle = 0; cycle < cycles; cycle++)
+        memorySystem->tick();
+}
+
+void
+Ramulator2::tickChannels(uint64_t cycles)
+{
+    assert(cycles);
+
+    if (tickPool) {
+        poolCycles = cycles;
+        tickPool->run();
+    } else {
+        for (auto &chan : channels)
+            chan.tick(cycles);
+    }
+
+    // finish the completions cycle by cycle, as if the channels had
+    // been ticked one cycle at a time
+    const Tick first = cycleTick;
+    while (true) {
+        uint64_t cycle = cycles;
+        for (auto &chan : channels) {
+            if (chan.nextCompleted < chan.completed.size()) {
+                cycle = std::min(cycle,
+                                 chan.completed[chan.nextCompleted].first);
+            }
         }
+        if (cycle == cycles)
+            break;
+
+        cycleTick = first + cycle * tCKTicks;
+        for (auto &chan : channels) {
+            while (chan.nextCompleted < chan.completed.size() &&
+                   chan.completed[chan.nextCompleted].first == cycle) {
+                finish(chan.completed[chan.nextCompleted++].second,
+                       nullptr);
+            }
+        }
+    }
+
+    for (auto &chan : channels) {
+        chan.completed.clear();
+        chan.nextCompleted = 0;
+    }
+    cycleTick = first + (cycles - 1) * tCKTicks;
+}
+
+unsigned
+Ramulator2::channelOf(Addr addr, Addr &local) const
+{
+    const Addr offset = range.getOffset(addr);
+    if (channels.size() == 1) {
+        local = offset;
+        return 0;
+    }
+
+    const Addr nbr_channels = channels.size();
+    if (!channelInterleave) {
+        local = offset % channelSize;
+        return offset / channelSize;
     }
 
-    schedule(tickEvent,
-        curTick() + ramulator2_memorysystem->get_tCK() * sim_clock::as_float::ns);
+    // drop the channel select from the offset
+    const Addr chunk = offset / channelInterleave;
+    local = chunk / nbr_channels * channelInterleave +
+        offset % channelInterleave;
+    return chunk % nbr_channels;
+}
+
+uint64_t
+Ramulator2::skippedCyclesBefore(Tick until) const
+{
+    return nextCycleTick < until ?
+        divCeil(until - nextCycleTick, tCKTicks) : 0;
+}
+
+void
+Ramulator2::fastForward(Tick until)
+{
+    assert(!tickEvent.scheduled());
+
+    const uint64_t cycles = skippedCyclesBefore(until);
+    if (!cycles)
+        return;
+
+    if (system()->isTimingMode()) {
+        // nothing is in flight, so the channels can be handed all the
+        // cycles at once
+        cycleTick = nextCycleTick;
+        tickChannels(cycles);
+
+        const uint64_t dumped = std::min(cycles, dumpedCycles);
+        dumpedCycles -= dumped;
+        ramStats.cycles += cycles - dumped;
+        ramStats.skippedCycles += cycles - dumped;
+    }
+    nextCycleTick += cycles * tCKTicks;
+}
+
+void
+Ramulator2::wakeUp()
+{
+    if (tickEvent.scheduled())
+        return;
+
+    DPRINTF(Ramulator2, "Waking up, replaying cycles from %llu\n",
+            nextCycleTick);
+
+    // nothing was in flight while we slept, so the skipped cycles
+    // cannot produce any callbacks and are safe to replay here
+    fastForward(curTick());
+    ++ramStats.idleWakeups;
+
+    schedule(tickEvent, nextCycleTick);
 }
 
 Tick
@@ -150,7 +613,7 @@ Ramulator2::recvFunctional(PacketPtr pkt)
     functionalAccess(pkt);
 
     for (auto i = responseQueue.begin(); i != responseQueue.end(); ++i)
-        pkt->trySatisfyFunctional(*i);
+        pkt->trySatisfyFunctional(i->second);
 
     pkt->popLabel();
 }
@@ -174,116 +637,202 @@ Ramulator2::recvTimingReq(PacketPtr pkt)
     if (retryReq)
         return false;
 
-    bool enqueue_success = false;
-    if (pkt->isRead())
-    {
-        // Generate ramulator READ request and try to send to ramulator's memory system
-        enqueue_success = ramulator2_frontend->
-            receive_external_requests(0, pkt->getAddr(), 0,
-            [this](Ramulator::Request& req) {
-                DPRINTF(Ramulator2, "Read to %ld completed.\n", req.addr);
-                auto& pkt_q = outstandingReads.find(req.addr)->second;
-                PacketPtr pkt = pkt_q.front();
-                pkt_q.pop_front();
-                if (!pkt_q.size())
-                    outstandingReads.erase(req.addr);
-
-                // added counter to track requests in flight
-                --nbrOutstandingReads;
-
-                accessAndRespond(pkt);
-            });
-
-        if (enqueue_success)
-        {
-            outstandingReads[pkt->getAddr()].push_back(pkt);
-
-            // we count a transaction as outstanding until it has left the
-            // queue in the controller, and the response has been sent
-            // back, note that this will differ for reads and writes
-            ++nbrOutstandingReads;
-        }
-        else
-        {
+    // restart the clock before Ramulator2 sees the request, so that
+    // it is enqueued at the same DRAM cycle as when always ticking
+    wakeUp();
+
+    if (frontendLatency) {
+        // the request is handed to Ramulator2 by the tick event once
+        // its frontend latency has passed
+        if (nbrInFlight() + arrivals.size() >= slots.size()) {
+            ++ramStats.slotsFull;
             retryReq = true;
+            return false;
         }
+        notifyRequest(probing::PacketInfo(pkt), pkt);
+        arrivals.emplace_back(curTick() + frontendLatency, pkt);
+        return true;
+    }
+
+    // a posted request is already turned into a response, or even
+    // gone, once admitted
+    const probing::PacketInfo info(pkt);
+
+    // the rest of a batch goes first, see issueBatch
+    cycleTick = curTick();
+    if (batchPkt) {
+        retryReq = true;
+        return false;
+    }
+
+    // a batch is always admitted, but may be answered, or even gone,
+    // once admit returns, so its targets are reported first
+    if (info.cmd.isPUMBatch())
+        notifyRequest(info, pkt);
+
+    if (!admit(pkt)) {
+        retryReq = true;
+        return false;
+    }
+
+    if (!info.cmd.isPUMBatch())
+        notifyRequest(info, pkt);
+
+    return true;
+}
+
+void
+Ramulator2::notifyRequest(probing::PacketInfo info, const PacketPtr pkt)
+{
+    if (!ppRequest->hasListeners())
+        return;
+
+    if (!info.cmd.isPUMBatch()) {
+        ppRequest->notify(info);
+        return;
+    }
+
+    // the batch is not admitted yet, so the packet still holds the
+    // descriptor
+    info.cmd = info.cmd.isMAJ() ? MemCmd::MAJ : MemCmd::PUM;
+    info.flags &= ~Request::PUM_BATCH;
+    const uint64_t count = pkt->pumBatchCount();
+    for (uint64_t i = 0; i < count; i++) {
+        info.addr = pkt->pumBatchTarget(i);
+        ppRequest->notify(info);
+    }
+}
+
+bool
+Ramulator2::admit(PacketPtr pkt)
+{
+    if (pkt->isRead())
+    {
+        // Generate ramulator READ request and try to send to ramulator's
+        // memory system, the read is performed once it completes
+        return enqueue(0, pkt->getAddr(), 0, pkt);
     } else if (pkt->isWrite()) {
-        // Generate ramulator WRITE request and try to send to ramulator's memory system
-        enqueue_success = ramulator2_frontend->
-            receive_external_requests(1, pkt->getAddr(), 0,
-            [this](Ramulator::Request& req) {
-                DPRINTF(Ramulator2, "Write to %ld completed.\n", req.addr);
-                auto& pkt_q = outstandingWrites.find(req.addr)->second;
-                PacketPtr pkt = pkt_q.front();
-                pkt_q.pop_front();
-                if (!pkt_q.size())
-                    outstandingWrites.erase(req.addr);
-
-                // added counter to track requests in flight
-                --nbrOutstandingWrites;
-
-                accessAndRespond(pkt);
-            });
-
-        if (enqueue_success)
-        {
-            outstandingWrites[pkt->getAddr()].push_back(pkt);
-
-            ++nbrOutstandingWrites;
-
-            // perform the access for writes
-            accessAndRespond(pkt);
-        }
-        else
-        {
-            retryReq = true;
-        }
+        // Generate ramulator WRITE request and try to send to ramulator's
+        // memory system
+        if (!enqueue(1, pkt->getAddr(), 0, nullptr))
+            return false;
+
+        // perform the access for writes
+        finish(NoSlot, pkt);
+        return true;
+    } else if (pkt->isPUMBatch()) {
+        if (batchPkt)
+            return false;
+
+        // the packet is accepted right away, its targets are issued
+        // over as many DRAM cycles as Ramulator2 needs to take them
+        ++ramStats.batchedPUMs;
+        batchPkt = pkt;
+        batchNext = 0;
+        issueBatch();
+        return true;
     } else if (pkt->isPUM() || pkt->isMAJ()) {
-        // We need to differantiate the rc and maj commands and change the requests cmd
-        int pum_cmd_id = 5;
-        if (pkt->isMAJ())
-            pum_cmd_id = 6;
-        // Generate ramulator PUM request and try to send to ramulator's memory system
-        enqueue_success = ramulator2_frontend->
-            receive_external_requests(pum_cmd_id, pkt->getAddr(), pkt->req->requestorId(),
-            [this](Ramulator::Request& req) {
-                DPRINTF(Ramulator2, "Pum to %ld completed.\n", req.addr);
-                auto& pkt_q = outstandingPUMs.find(req.addr)->second;
-                PacketPtr pkt = pkt_q.front();
-                pkt_q.pop_front();
-                if (!pkt_q.size())
-                    outstandingPUMs.erase(req.addr);
-
-                // added counter to track requests in flight
-                --nbrOutstandingPUMs;
-
-                accessAndRespond(pkt);
-            });
-
-        if (enqueue_success)
-        {
-            outstandingPUMs[pkt->getAddr()].push_back(pkt);
-
-            ++nbrOutstandingPUMs;
-
-            // perform the access for writes
-            accessAndRespond(pkt);
-        }
-        else
-        {
-            retryReq = true;
-        }
+        // like writes, a PUM op is performed and answered as soon as
+        // Ramulator2 accepted it, see issueBatch for a batched one
+        if (!enqueue(pumCommand(pkt, pkt->getAddr()), pkt->getAddr(),
+                     pkt->req->requestorId(), nullptr))
+            return false;
 
-    }
-    else {
-        // keep it simple and just respond if necessary
-        accessAndRespond(pkt);
+        finish(NoSlot, pkt);
         return true;
     }
 
+    // keep it simple and just respond if necessary
+    finish(NoSlot, pkt);
+    return true;
+}
+
+int
+Ramulator2::pumCommand(PacketPtr pkt, Addr addr) const
+{
+    // We need to differantiate the rc and maj commands and change the requests cmd
+    // With a geometry, a PUM op on one of the MAJ rows is a triple row
+    // activation, the same as in the functional model
+    if (pkt->isMAJ() || (pumGeometry &&
+            pumGeometry->isMajority(range.getOffset(addr))))
+        return 6;
+    return 5;
+}
+
+bool
+Ramulator2::enqueue(int type_id, Addr addr, int source_id, PacketPtr pkt)
+{
+    if (freeSlots.empty()) {
+        ++ramStats.slotsFull;
+        return false;
+    }
+
+    Addr local;
+    Channel &chan = channels[channelOf(addr, local)];
+
+    // the slot rides along in the callback, so a completion finds its
+    // packet without searching for it, the packet itself is finished
+    // by tickChannels as the callback may run on a worker thread
+    const unsigned slot = freeSlots.back();
+    Channel *completed = &chan;
+    const bool enqueue_success = chan.frontend->
+        receive_external_requests(type_id, local, source_id,
+        [completed, slot](Ramulator::Request& req) {
+            completed->completed.emplace_back(completed->cycle, slot);
+        });
+
+    if (enqueue_success) {
+        freeSlots.pop_back();
+        slots[slot] = pkt;
+    }
+
     return enqueue_success;
 }
 
+void
+Ramulator2::complete(unsigned slot)
+{
+    DPRINTF(Ramulator2, "Request in slot %d completed.\n", slot);
+
+    PacketPtr pkt = slots[slot];
+    slots[slot] = nullptr;
+    freeSlots.push_back(slot);
+
+    if (pkt) {
+        accessAndRespond(pkt);
+    } else if (nbrOutstanding() == 0) {
+        // the last posted write or PUM op has left Ramulator2
+        signalDrainDone();
+    }
+}
+
+void
+Ramulator2::issueBatch()
+{
+    assert(batchPkt);
+
+    const uint64_t count = batchPkt->pumBatchCount();
+    for (; batchNext < count; ++batchNext) {
+        const Addr addr = batchPkt->pumBatchTarget(batchNext);
+        panic_if(!range.contains(addr), "%s: target %d (%#x) of a batched "
+                 "PUM op at %#x is outside %s\n", name(), batchNext, addr,
+                 batchPkt->getAddr(), range.to_string());
+        if (!enqueue(pumCommand(batchPkt, addr), addr,
+                     batchPkt->req->requestorId(), nullptr)) {
+            DPRINTF(Ramulator2, "Batch at %#x stalled after %d of %d "
+                    "targets\n", batchPkt->getAddr(), batchNext, count);
+            return;
+        }
+        ++ramStats.batchTargets;
+    }
+
+    // like a single PUM op, the batch is performed and answered once
+    // Ramulator2 accepted all of its targets
+    PacketPtr pkt = batchPkt;
+    batchPkt = nullptr;
+    finish(NoSlot, pkt);
+}
+
 void
 Ramulator2::recvRespRetry()
 {
@@ -308,8 +857,8 @@ Ramulator2::accessAndRespond(PacketPtr pkt)
         // access already turned the packet into a response
         assert(pkt->isResponse());
 
-        // Assume frontend latency = 0
-        Tick time = curTick() + pkt->headerDelay + pkt->payloadDelay;
+        Tick time = curTick() + backendLatency + pkt->headerDelay +
+            pkt->payloadDelay;
         // Here we reset the timing of the packet before sending it out.
         pkt->headerDelay = pkt->payloadDelay = 0;
 
@@ -317,7 +866,7 @@ Ramulator2::accessAndRespond(PacketPtr pkt)
                 pkt->getAddr());
 
         // queue it to be sent back
-        responseQueue.push_back(pkt);
+        responseQueue.emplace_back(time, pkt);
 
         // if we are not already waiting for a retry, or are scheduled
         // to send a response, schedule an event
@@ -344,6 +893,44 @@ Ramulator2::getPort(const std::string &if_name, PortID idx)
     }
 }
 
+Ramulator2::Ramulator2Stats::Ramulator2Stats(Ramulator2 &_ram)
+    : statistics::Group(&_ram), ram(_ram),
+    ADD_STAT(cycles, statistics::units::Cycle::get(),
+             "Number of DRAM cycles the memory system was advanced by"),
+    ADD_STAT(skippedCycles, statistics::units::Cycle::get(),
+             "Number of idle DRAM cycles replayed without a tick event"),
+    ADD_STAT(idleWakeups, statistics::units::Count::get(),
+             "Number of times the DRAM clock was restarted after idling"),
+    ADD_STAT(batchedPUMs, statistics::units::Count::get(),
+             "Number of batched PUM ops received"),
+    ADD_STAT(batchTargets, statistics::units::Count::get(),
+             "Number of PUM requests the batched ops were expanded into"),
+    ADD_STAT(slotsFull, statistics::units::Count::get(),
+             "Number of requests refused for lack of a free slot"),
+    ADD_STAT(tickEvents, statistics::units::Count::get(),
+             "Number of tick events that advanced the memory system")
+{
+}
+
+void
+Ramulator2::Ramulator2Stats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    // account for the cycles an always-ticking clock would already
+    // have executed, including one due right now, but leave replaying
+    // them to the next request, so that a dump does not change what
+    // the memory system does
+    if (ram.tCKTicks && !ram.tickEvent.scheduled() &&
+        ram.system()->isTimingMode()) {
+        const uint64_t pending =
+            ram.skippedCyclesBefore(curTick() + 1) - ram.dumpedCycles;
+        cycles += pending;
+        skippedCycles += pending;
+        ram.dumpedCycles += pending;
+    }
+}
+
 DrainState
 Ramulator2::drain()
 {
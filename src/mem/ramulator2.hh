@@ -3,10 +3,13 @@
 
 #include <functional>
 #include <deque>
-#include <unordered_map>
+#include <memory>
+#include <vector>
 
+#include "base/statistics.hh"
 #include "mem/abstract_mem.hh"
 #include "params/Ramulator2.hh"
+#include "sim/probe/mem.hh"
 
 // Forward declare Ramulator2 top-level components
 namespace Ramulator
@@ -53,33 +56,219 @@ class Ramulator2 : public AbstractMemory
 
     std::string config_path;
     std::string output_dir;
-    Ramulator::IFrontEnd* ramulator2_frontend;
-    Ramulator::IMemorySystem* ramulator2_memorysystem;
+
+    /**
+     * A channel is a Ramulator2 memory system with its own front end,
+     * all created from the same config. Requests are spread over the
+     * channels by address, and each channel sees the offset into its
+     * slice of the range, see channelOf(). As the channels share no
+     * state, they are ticked in parallel when tick_threads allows it.
+     */
+    struct Channel
+    {
+        Ramulator::IFrontEnd* frontend;
+        Ramulator::IMemorySystem* memorySystem;
+
+        /** Cycle of the current tickChannels() the channel is in */
+        uint64_t cycle = 0;
+
+        /**
+         * Slots completed during the current tickChannels(), with the
+         * cycle they completed in, in the order Ramulator2 completed
+         * them. Only the thread ticking the channel appends to it, and
+         * the completions are processed once all channels are done,
+         * cycle by cycle and channel by channel, which keeps the
+         * results independent of the number of threads.
+         */
+        std::vector<std::pair<uint64_t, unsigned>> completed;
+
+        /** Index of the first completion not finished yet */
+        size_t nextCompleted = 0;
+
+        /** Advance the channel by a number of DRAM cycles */
+        void tick(uint64_t cycles);
+    };
+
+    std::vector<Channel> channels;
+
+    /** Channel interleaving granularity, zero for contiguous slices */
+    const Addr channelInterleave;
+
+    /** Size of a channel slice if not interleaved */
+    Addr channelSize;
+
+    /**
+     * Find the channel of an address and the address the channel sees,
+     * which is the offset of the address into the slice of the range
+     * the channel holds. With a single channel, that is the offset
+     * into the range, the same offsets PUMGeometry lays subarrays out
+     * over.
+     *
+     * @param addr The address of the request
+     * @param local Set to the address to hand to the channel
+     * @return The channel index
+     */
+    unsigned channelOf(Addr addr, Addr &local) const;
+
+    /** Threads ticking the channels, including the simulation thread */
+    const unsigned tickThreads;
+
+    class TickPool;
+
+    /** Worker threads, only there if more than one thread ticks */
+    std::unique_ptr<TickPool> tickPool;
+
+    /** DRAM cycles the tick pool advances the channels by */
+    uint64_t poolCycles;
+
+    /**
+     * Advance every channel by a number of DRAM cycles in one go, the
+     * first at cycleTick, then finish the requests that completed
+     * during them, in order. Nothing is handed to Ramulator2 in
+     * between, so the cycles must be free of arrivals and batch
+     * targets. Each call is one handoff to the tick threads, so the
+     * more cycles per call, the better the channels tick in parallel.
+     * cycleTick is left at the last cycle.
+     *
+     * @param cycles The number of cycles, at least one
+     */
+    void tickChannels(uint64_t cycles);
 
     // std::function<void(Ramulator::Request&)> read_callback;
     // std::function<void(Ramulator::Request&)> write_callback;
     bool retryReq;
     bool retryResp;
     Tick startTick;
-    std::unordered_map<Addr, std::deque<PacketPtr>> outstandingReads;
-    std::unordered_map<Addr, std::deque<PacketPtr>> outstandingWrites;
-    std::unordered_map<Addr, std::deque<PacketPtr>> outstandingPUMs;
 
     /**
-     * Count the number of outstanding transactions so that we can
-     * block any further requests until there is space in Ramulator2 and
-     * the sending queue we need to buffer the response packets.
+     * Every request in flight in Ramulator2 holds a slot, and its
+     * completion callback carries the slot index, so the packet is
+     * found without any lookup. A slot holds the packet to perform
+     * and respond to on completion, or nullptr for writes and PUM ops
+     * that were already answered when they were enqueued. The table
+     * is allocated once, and a request that finds no free slot is
+     * refused until one is.
+     */
+    std::vector<PacketPtr> slots;
+
+    /** Indices of the free slots, used as a stack */
+    std::vector<unsigned> freeSlots;
+
+    /** Number of requests in flight in Ramulator2 */
+    unsigned int
+    nbrInFlight() const
+    {
+        return slots.size() - freeSlots.size();
+    }
+
+    /**
+     * Try to enqueue a request in Ramulator2.
+     *
+     * @param type_id Ramulator2 request type
+     * @param addr Address of the request
+     * @param source_id Ramulator2 source of the request
+     * @param pkt Packet to perform on completion, if any
+     * @return true if Ramulator2 accepted the request
+     */
+    bool enqueue(int type_id, Addr addr, int source_id, PacketPtr pkt);
+
+    /** Free a slot when its request completes, and finish its packet */
+    void complete(unsigned slot);
+
+    /**
+     * A batched PUM op is a single packet that is expanded into one
+     * Ramulator2 PUM request per target, so that the DRAM scheduler
+     * sees the whole batch at once. Whenever Ramulator2 cannot take
+     * all targets, the rest are issued on the following DRAM cycles
+     * and any other request is held off until the batch is complete.
+     * PUM ops are posted like writes: a single op is answered once
+     * Ramulator2 accepted it, and a batch once it accepted the last
+     * target, while the targets still take their DRAM time.
+     */
+    PacketPtr batchPkt;
+
+    /** Index of the next target of batchPkt to issue */
+    uint64_t batchNext;
+
+    /** Ramulator2 request type of a PUM op on the given address */
+    int pumCommand(PacketPtr pkt, Addr addr) const;
+
+    /** Issue as many of the remaining targets of batchPkt as possible */
+    void issueBatch();
+
+    /**
+     * Hand a request to Ramulator2 at the DRAM cycle being simulated.
+     *
+     * @param pkt The request
+     * @return false if Ramulator2 cannot take it yet
+     */
+    bool admit(PacketPtr pkt);
+
+    /**
+     * Static latency from the requestors to Ramulator2, e.g. of a
+     * bridge in front of the controller. Requests are only handed to
+     * Ramulator2 once it has passed, so every request that reaches
+     * Ramulator2 within that time is already known, and the
+     * controller can simulate that many DRAM cycles per tick event.
      */
-    unsigned int nbrOutstandingReads;
-    unsigned int nbrOutstandingWrites;
-    unsigned int nbrOutstandingPUMs;
+    const Tick frontendLatency;
+
+    /** Static latency from Ramulator2 back to the requestors */
+    const Tick backendLatency;
+
+    /** Simulate several DRAM cycles per tick event when possible */
+    const bool tickBatching;
+
+    /** DRAM cycles simulated per tick event */
+    unsigned cyclesPerEvent;
 
     /**
-     * Queue to hold response packets until we can send them
-     * back. This is needed as Ramulator2 unconditionally passes
-     * responses back without any flow control.
+     * Tick of the DRAM cycle being simulated. When running ahead this
+     * is later than the current tick.
      */
-    std::deque<PacketPtr> responseQueue;
+    Tick cycleTick;
+
+    /** Requests waiting out the frontend latency, with their due tick */
+    std::deque<std::pair<Tick, PacketPtr>> arrivals;
+
+    /** Hand the arrivals that are due at cycleTick to Ramulator2 */
+    void injectArrivals();
+
+    /**
+     * What happened in a DRAM cycle simulated ahead of time, to be
+     * done once the simulation reaches the tick of that cycle.
+     */
+    struct Finish
+    {
+        Tick when;
+        /** The slot that completed, if any */
+        unsigned slot;
+        /** The write or PUM op to answer, if any */
+        PacketPtr posted;
+    };
+
+    static constexpr unsigned NoSlot = -1;
+
+    /** Finishes in the order of their cycles */
+    std::deque<Finish> finishes;
+
+    /**
+     * Complete a slot or answer a posted request at cycleTick, right
+     * away if the simulation is there, or else at the right tick.
+     */
+    void finish(unsigned slot, PacketPtr posted);
+
+    /** Do the finishes that are due */
+    void processFinishes();
+
+    EventFunctionWrapper finishEvent;
+
+    /**
+     * Queue to hold response packets, with the tick they can leave,
+     * until we can send them back. This is needed as Ramulator2
+     * unconditionally passes responses back without any flow control.
+     */
+    std::deque<std::pair<Tick, PacketPtr>> responseQueue;
 
 
     unsigned int nbrOutstanding() const;
@@ -101,7 +290,8 @@ class Ramulator2 : public AbstractMemory
     EventFunctionWrapper sendResponseEvent;
 
     /**
-     * Progress the controller one clock cycle.
+     * Progress the controller by one or, when batching, several clock
+     * cycles.
      */
     void tick();
 
@@ -110,16 +300,116 @@ class Ramulator2 : public AbstractMemory
      */
     EventFunctionWrapper tickEvent;
 
+    /**
+     * If set, the tick event is descheduled whenever Ramulator2 has
+     * no reads, writes or PUM operations in flight. The skipped DRAM
+     * cycles are replayed back-to-back on the next request, so that
+     * refresh and the other internal DRAM state advance exactly as if
+     * the controller had been ticking all along. Ramulator2 has no way
+     * to jump its clock, so each replayed cycle still ticks every
+     * channel, only the tick events are saved.
+     */
+    const bool skipIdleCycles;
+
+    /** The DRAM clock period (tCK) in ticks. */
+    Tick tCKTicks;
+
+    /**
+     * The tick at which the next DRAM cycle is due, whether or not
+     * the tick event is currently scheduled.
+     */
+    Tick nextCycleTick;
+
+    /** True if Ramulator2 itself has no requests in flight. */
+    bool memorySystemIdle() const;
+
+    /**
+     * Send the retry the port is waiting for, if a request would now
+     * be accepted. With a frontend latency, that only takes a free
+     * slot, so the retry is sent at the tick of the cycle that freed
+     * one, batched or not. Without, Ramulator2 may refuse it anyway,
+     * and the retry is sent every cycle.
+     */
+    void trySendRetry();
+
+    /**
+     * Number of the skipped DRAM cycles due strictly before the given
+     * tick, which the next fastForward() would replay.
+     */
+    uint64_t skippedCyclesBefore(Tick until) const;
+
+    /**
+     * Skipped DRAM cycles that a stats dump already counted without
+     * replaying them, which fastForward() does not count again.
+     */
+    uint64_t dumpedCycles;
+
+    /**
+     * Advance the Ramulator2 memory system by every DRAM cycle that
+     * is due strictly before the given tick, without going through
+     * the event queue.
+     *
+     * @param until The tick to fast-forward up to
+     */
+    void fastForward(Tick until);
+
+    /**
+     * Restart the clock after an idle period, replaying the DRAM
+     * cycles that were skipped while the tick event was descheduled.
+     */
+    void wakeUp();
+
+    struct Ramulator2Stats : public statistics::Group
+    {
+        Ramulator2Stats(Ramulator2 &ram);
+
+        void preDumpStats() override;
+
+        Ramulator2 &ram;
+
+        /** Number of DRAM cycles the memory system was advanced by */
+        statistics::Scalar cycles;
+        /** Number of DRAM cycles replayed without a tick event */
+        statistics::Scalar skippedCycles;
+        /** Number of times the clock was restarted after idling */
+        statistics::Scalar idleWakeups;
+        /** Number of batched PUM ops received */
+        statistics::Scalar batchedPUMs;
+        /** Number of PUM requests the batched ops were expanded into */
+        statistics::Scalar batchTargets;
+        /** Number of requests refused for lack of a free slot */
+        statistics::Scalar slotsFull;
+        /** Number of tick events that advanced the memory system */
+        statistics::Scalar tickEvents;
+    } ramStats;
+
     /**
      * Upstream caches need this packet until true is returned, so
      * hold it for deletion until a subsequent call
      */
     std::unique_ptr<Packet> pendingDelete;
 
+    /**
+     * Probe point notified of every request accepted from the outside
+     * world, e.g. to record it with a MemTraceProbe. Each target of a
+     * batched PUM op is notified as a PUM or MAJ op of its own, so a
+     * recorded trace can be replayed without the batch descriptors.
+     */
+    probing::PacketUPtr ppRequest;
+
+    /**
+     * Notify ppRequest of an accepted request.
+     *
+     * @param info The request as it was received
+     * @param pkt The packet, only looked at for the targets of a batch
+     */
+    void notifyRequest(probing::PacketInfo info, const PacketPtr pkt);
+
   public:
 
     typedef Ramulator2Params Params;
     Ramulator2(const Params &p);
+    ~Ramulator2();
 
     DrainState drain() override;
 
@@ -129,6 +419,8 @@ class Ramulator2 : public AbstractMemory
     void init() override;
     void startup() override;
 
+    void regProbePoints() override;
+
     void resetStats() override;
 
   protected:
@@ -60,6 +60,7 @@
 #include "base/compiler.hh"
 #include "base/extensible.hh"
 #include "base/flags.hh"
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 #include "mem/htm.hh"
@@ -261,6 +262,8 @@ class Request : public Extensible<Request>
         HAS_NO_ADDR                = 0x0001000000000000,
         /** The request is a PUM request */
         PUM                        = 0x0100000000000000,
+        /** The PUM or MAJ op is repeated over a batch of targets */
+        PUM_BATCH                  = 0x0200000000000000,
         MAJ                        = 0x1000000000000000,
     };
     static const FlagsType STORE_NO_DATA = CACHE_BLOCK_ZERO |
@@ -533,6 +536,35 @@ class Request : public Extensible<Request>
 
     ~Request() {}
 
+    /**
+     * Requests are created and destroyed for every memory access, so
+     * they come from a thread-local free list rather than the heap.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        return PoolAlloc<Request>::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        PoolAlloc<Request>::deallocate(p, size);
+    }
+
+    /**
+     * Factory method for creating a request, with the request and the
+     * control block of its shared pointer in a single pooled block.
+     * Prefer this over std::make_shared on hot paths.
+     */
+    template <typename... Args>
+    static RequestPtr
+    create(Args&&... args)
+    {
+        return std::allocate_shared<Request>(PoolAllocator<Request>(),
+                                             std::forward<Args>(args)...);
+    }
+
     /**
      * Factory method for creating memory management requests, with
      * unspecified addr and size.
@@ -1035,6 +1067,7 @@ class Request : public Extensible<Request>
     bool isLockedRMW() const { return _flags.isSet(LOCKED_RMW); }
     bool isPUM() const {return _flags.isSet(PUM);}
     bool isMAJ() const {return _flags.isSet(MAJ);}
+    bool isPUMBatch() const {return _flags.isSet(PUM_BATCH);}
     bool isSwap() const { return _flags.isSet(MEM_SWAP | MEM_SWAP_COND); }
     bool isCondSwap() const { return _flags.isSet(MEM_SWAP_COND); }
     bool
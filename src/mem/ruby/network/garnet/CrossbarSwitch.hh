@@ -63,8 +63,12 @@ class CrossbarSwitch : public Consumer
     update_sw_winner(int inport, flit *t_flit)
     {
         switchBuffers[inport].insert(t_flit);
+        m_num_flits++;
     }
 
+    // Number of flits waiting for switch traversal
+    inline int get_num_flits() const { return m_num_flits; }
+
     inline double get_crossbar_activity() { return m_crossbar_activity; }
 
     bool functionalRead(Packet *pkt, WriteMask &mask);
@@ -75,6 +79,7 @@ class CrossbarSwitch : public Consumer
     Router *m_router;
     int m_num_vcs;
     double m_crossbar_activity;
+    int m_num_flits;
     std::vector<flitBuffer> switchBuffers;
 };
 
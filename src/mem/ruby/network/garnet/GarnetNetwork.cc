@@ -31,14 +31,17 @@
 
 #include "mem/ruby/network/garnet/GarnetNetwork.hh"
 
+#include <algorithm>
 #include <cassert>
 
 #include "base/cast.hh"
 #include "base/compiler.hh"
+#include "base/pool_alloc.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
+#include "mem/ruby/network/garnet/Credit.hh"
 #include "mem/ruby/network/garnet/CreditLink.hh"
 #include "mem/ruby/network/garnet/GarnetLink.hh"
 #include "mem/ruby/network/garnet/NetworkInterface.hh"
@@ -72,6 +75,7 @@ GarnetNetwork::GarnetNetwork(const Params &p)
     m_routing_algorithm = p.routing_algorithm;
     m_next_packet_id = 0;
 
+    m_activity_tracking = p.activity_tracking;
     m_enable_fault_model = p.enable_fault_model;
     if (m_enable_fault_model)
         fault_model = p.fault_model;
@@ -134,6 +138,17 @@ GarnetNetwork::init()
         m_num_cols = -1;
     }
 
+    // Fill the flit and credit pools for a full network: every input VC
+    // holding a full buffer of flits and returning a credit for each
+    std::size_t input_vc_buffers = 0;
+    for (auto *router : m_routers) {
+        input_vc_buffers += router->get_num_inports() *
+            router->get_num_vcs() *
+            std::max(getBuffersPerDataVC(), getBuffersPerCtrlVC());
+    }
+    PoolAlloc<flit>::reserve(sizeof(flit), input_vc_buffers);
+    PoolAlloc<flit>::reserve(sizeof(Credit), input_vc_buffers);
+
     // FaultModel: declare each router to the fault model
     if (isFaultModelEnabled()) {
         for (std::vector<Router*>::const_iterator i= m_routers.begin();
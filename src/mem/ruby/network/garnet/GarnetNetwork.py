@@ -52,6 +52,12 @@ class GarnetNetwork(RubyNetwork):
     garnet_deadlock_threshold = Param.UInt32(
         50000, "network-level deadlock threshold"
     )
+    activity_tracking = Param.Bool(
+        True,
+        "Only evaluate the switch allocation and traversal of routers, "
+        "and the inputs of their switch allocators, with flits to move. "
+        "Timing is the same either way.",
+    )
 
 
 class GarnetNetworkInterface(ClockedObject):
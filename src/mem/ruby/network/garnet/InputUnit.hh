@@ -116,9 +116,13 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
+        m_num_flits--;
         return virtualChannels[vc].getTopFlit();
     }
 
+    // Number of flits buffered across all VCs of this input
+    inline int get_num_flits() const { return m_num_flits; }
+
     inline bool
     need_stage(int vc, flit_stage stage, Tick time)
     {
@@ -168,6 +172,7 @@ class InputUnit : public Consumer
 
     // Input Virtual channels
     std::vector<VirtualChannel> virtualChannels;
+    int m_num_flits;
 
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
@@ -33,6 +33,7 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET_0_NETWORKINTERFACE_HH__
 #define __MEM_RUBY_NETWORK_GARNET_0_NETWORKINTERFACE_HH__
 
+#include <deque>
 #include <iostream>
 #include <vector>
 
@@ -32,6 +32,8 @@
 
 #include "mem/ruby/network/garnet/NetworkLink.hh"
 
+#include <algorithm>
+
 #include "base/trace.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet/CreditLink.hh"
@@ -52,8 +52,8 @@ Router::Router(const Params &p)
   : BasicRouter(p), Consumer(this), m_latency(p.latency),
     m_virtual_networks(p.virt_nets), m_vc_per_vnet(p.vcs_per_vnet),
     m_num_vcs(m_virtual_networks * m_vc_per_vnet), m_bit_width(p.width),
-    m_network_ptr(nullptr), routingUnit(this), switchAllocator(this),
-    crossbarSwitch(this)
+    m_network_ptr(nullptr), m_activity_tracking(false), routingUnit(this),
+    switchAllocator(this), crossbarSwitch(this)
 {
     m_input_unit.clear();
     m_output_unit.clear();
@@ -64,6 +64,7 @@ Router::init()
 {
     BasicRouter::init();
 
+    m_activity_tracking = m_network_ptr->isActivityTracking();
     switchAllocator.init();
     crossbarSwitch.init();
 }
@@ -89,11 +90,37 @@ Router::wakeup()
         m_output_unit[outport]->wakeup();
     }
 
+    m_wakeups++;
+
+    // Routers, like links, are only scheduled by the flits and credits
+    // sent to them and by their own stages while flits wait, so an idle
+    // router is never woken. With activity tracking, the stages without
+    // flits to move in a woken router are skipped too, as evaluating them
+    // would not change any state
+
     // Switch Allocation
-    switchAllocator.wakeup();
+    if (!m_activity_tracking || hasBufferedFlits()) {
+        switchAllocator.wakeup();
+    } else {
+        m_idle_stage_skips++;
+    }
 
     // Switch Traversal
-    crossbarSwitch.wakeup();
+    if (!m_activity_tracking || crossbarSwitch.get_num_flits() > 0) {
+        crossbarSwitch.wakeup();
+    } else {
+        m_idle_stage_skips++;
+    }
+}
+
+bool
+Router::hasBufferedFlits()
+{
+    for (auto &input_unit : m_input_unit) {
+        if (input_unit->get_num_flits() > 0)
+            return true;
+    }
+    return false;
 }
 
 void
@@ -216,6 +243,16 @@ Router::regStats()
         .name(name() + ".sw_output_arbiter_activity")
         .flags(statistics::nozero)
     ;
+
+    m_wakeups
+        .name(name() + ".wakeups")
+        .flags(statistics::nozero)
+    ;
+
+    m_idle_stage_skips
+        .name(name() + ".idle_stage_skips")
+        .flags(statistics::nozero)
+    ;
 }
 
 void
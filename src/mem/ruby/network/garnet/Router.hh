@@ -120,6 +120,9 @@ class Router : public BasicRouter, public Consumer
     void grant_switch(int inport, flit *t_flit);
     void schedule_wakeup(Cycles time);
 
+    // Whether any input VC holds a flit
+    bool hasBufferedFlits();
+
     std::string getPortDirectionName(PortDirection direction);
     void printFaultVector(std::ostream& out);
     void printAggregateFaultProbability(std::ostream& out);
@@ -147,6 +150,7 @@ class Router : public BasicRouter, public Consumer
     uint32_t m_virtual_networks, m_vc_per_vnet, m_num_vcs;
     uint32_t m_bit_width;
     GarnetNetwork *m_network_ptr;
+    bool m_activity_tracking;
 
     RoutingUnit routingUnit;
     SwitchAllocator switchAllocator;
@@ -163,6 +167,10 @@ class Router : public BasicRouter, public Consumer
     statistics::Scalar m_sw_output_arbiter_activity;
 
     statistics::Scalar m_crossbar_activity;
+
+    // Statistical variables for the activity tracking
+    statistics::Scalar m_wakeups;
+    statistics::Scalar m_idle_stage_skips;
 };
 
 } // namespace garnet
@@ -62,6 +62,7 @@ SwitchAllocator::init()
 {
     m_num_inports = m_router->get_num_inports();
     m_num_outports = m_router->get_num_outports();
+    m_activity_tracking = m_router->get_net_ptr()->isActivityTracking();
     m_round_robin_inport.resize(m_num_outports);
     m_round_robin_invc.resize(m_num_inports);
     m_port_requests.resize(m_num_inports);
@@ -113,6 +114,11 @@ SwitchAllocator::arbitrate_inports()
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
     for (int inport = 0; inport < m_num_inports; inport++) {
+        // no VC of an empty input can request
+        if (m_activity_tracking &&
+            m_router->getInputUnit(inport)->get_num_flits() == 0)
+            continue;
+
         int invc = m_round_robin_invc[inport];
 
         for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
@@ -363,6 +369,10 @@ SwitchAllocator::check_for_wakeup()
     }
 
     for (int i = 0; i < m_num_inports; i++) {
+        if (m_activity_tracking &&
+            m_router->getInputUnit(i)->get_num_flits() == 0)
+            continue;
+
         for (int j = 0; j < m_num_vcs; j++) {
             if (m_router->getInputUnit(i)->need_stage(j, SA_, nextCycle)) {
                 m_router->schedule_wakeup(Cycles(1));
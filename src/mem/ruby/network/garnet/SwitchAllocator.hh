@@ -82,6 +82,8 @@ class SwitchAllocator : public Consumer
   private:
     int m_num_inports, m_num_outports;
     int m_num_vcs, m_vc_per_vnet;
+    // Skip the inputs without buffered flits
+    bool m_activity_tracking;
 
     double m_input_arbiter_activity, m_output_arbiter_activity;
 
@@ -34,6 +34,7 @@
 #include <cassert>
 #include <iostream>
 
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
@@ -56,6 +57,23 @@ class flit
 
     virtual ~flit(){};
 
+    /**
+     * A flit is created for every hop of a message and a credit for every
+     * flit consumed, so both come from a free list rather than the heap.
+     * Credits derive from flits and share the lists, under their own size.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        return PoolAlloc<flit>::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        PoolAlloc<flit>::deallocate(p, size);
+    }
+
     int get_outport() {return m_outport; }
     int get_size() { return m_size; }
     Tick get_enqueue_time() { return m_enqueue_time; }
@@ -31,7 +31,8 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET_0_FLITBUFFER_HH__
 #define __MEM_RUBY_NETWORK_GARNET_0_FLITBUFFER_HH__
 
-#include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <iostream>
 #include <vector>
 
@@ -47,6 +48,11 @@ namespace ruby
 namespace garnet
 {
 
+/**
+ * A FIFO of flits, kept in a ring so that moving flits through it does
+ * not allocate. The ring starts small and doubles whenever it fills up,
+ * so it settles at the largest occupancy the buffer sees and stays there.
+ */
 class flitBuffer
 {
   public:
@@ -58,33 +64,56 @@ class flitBuffer
     void print(std::ostream& out) const;
     bool isFull();
     void setMaxSize(int maximum);
-    int getSize() const { return m_buffer.size(); }
+    int getSize() const { return m_count; }
 
     flit *
     getTopFlit()
     {
-        flit *f = m_buffer.front();
-        m_buffer.pop_front();
+        flit *f = peekTopFlit();
+        m_head = (m_head + 1) & (m_ring.size() - 1);
+        m_count--;
         return f;
     }
 
     flit *
     peekTopFlit()
     {
-        return m_buffer.front();
+        assert(m_count > 0);
+        return m_ring[m_head];
     }
 
     void
     insert(flit *flt)
     {
-        m_buffer.push_back(flt);
+        if (m_count == m_ring.size())
+            grow();
+        m_ring[(m_head + m_count) & (m_ring.size() - 1)] = flt;
+        m_count++;
     }
 
     bool functionalRead(Packet *pkt, WriteMask &mask);
     uint32_t functionalWrite(Packet *pkt);
 
   private:
-    std::deque<flit *> m_buffer;
+    /** Initial number of slots, enough for most buffers. */
+    static constexpr std::size_t InitialCapacity = 8;
+
+    /** The i-th flit from the top of the buffer. */
+    flit *
+    at(std::size_t i) const
+    {
+        return m_ring[(m_head + i) & (m_ring.size() - 1)];
+    }
+
+    /** Double the slots of the ring, keeping the order of the flits. */
+    void grow();
+
+    /** Slots of the ring, a power of two of them. */
+    std::vector<flit *> m_ring;
+    /** Slot of the top flit. */
+    std::size_t m_head;
+    /** Number of flits in the buffer. */
+    std::size_t m_count;
     int max_size;
 };
 
@@ -0,0 +1,293 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/ruby/protocol/AccessPermission.hh"
+#include "mem/ruby/protocol/RubyRequestType.hh"
+#include "mem/ruby/slicc_interface/AbstractCacheEntry.hh"
+#include "mem/ruby/structures/CacheMemory.hh"
+#include "mem/ruby/system/CacheRecorder.hh"
+#include "params/LRURP.hh"
+#include "params/RubyCache.hh"
+#include "sim/root.hh"
+
+using namespace gem5;
+using namespace gem5::ruby;
+
+namespace gem5
+{
+
+// The statistics resolve names they do not know through the root, which
+// needs a whole simulation. No test looks a statistic up by name.
+Root *Root::_root = nullptr;
+
+namespace ruby
+{
+
+// CacheMemory records its contents through the recorder when taking a
+// checkpoint, which needs a whole Ruby system. No test takes one.
+void
+CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
+                         RubyRequestType type, Tick time, DataBlock& data)
+{
+    panic("Not used by the tests");
+}
+
+} // namespace ruby
+} // namespace gem5
+
+namespace
+{
+
+// Instantiate the fake class to have a valid curTick of 0
+GTestTickHandler tickHandler;
+
+const int assoc = 4;
+const int blkSize = 64;
+const int numSets = 16;
+
+/** An entry of a protocol, holding only its data. */
+class Entry : public AbstractCacheEntry
+{
+  public:
+    DataBlock dataBlk;
+
+    void
+    initBlockSize(int block_size) override
+    {
+        dataBlk.setBlockSize(block_size);
+    }
+
+    DataBlock &getDataBlk() override { return dataBlk; }
+
+    void print(std::ostream& out) const override { out << m_Address; }
+};
+
+/** A 4 KiB, 4-way cache of 64 B lines with LRU replacement. */
+class CacheMemoryTest : public testing::Test
+{
+  protected:
+    LRURPParams rpParams;
+    RubyCacheParams params;
+    std::unique_ptr<CacheMemory> cache;
+    Tick tick = 0;
+
+    CacheMemoryTest()
+    {
+        rpParams.name = "replacement_policy";
+        rpParams.eventq_index = 0;
+
+        params.name = "cache";
+        params.eventq_index = 0;
+        params.size = assoc * numSets * blkSize;
+        params.assoc = assoc;
+        // The cache deletes its replacement policy
+        params.replacement_policy = new replacement_policy::LRU(rpParams);
+        params.start_index_bit = floorLog2(blkSize);
+        params.is_icache = false;
+        params.block_size = blkSize;
+        params.atomicLatency = Cycles(1);
+        params.atomicALUs = 1;
+        params.dataArrayBanks = 1;
+        params.tagArrayBanks = 1;
+        params.dataAccessLatency = Cycles(1);
+        params.tagAccessLatency = Cycles(1);
+        params.resourceStalls = false;
+
+        cache = std::make_unique<CacheMemory>(params);
+        cache->init();
+        tickHandler.setCurTick(0);
+    }
+
+    /** The address of the given line of the given set. */
+    static Addr
+    lineAddr(int set, int line)
+    {
+        return (line * numSets + set) * blkSize;
+    }
+
+    /** Allocate a line, as a protocol does on a fill. */
+    AbstractCacheEntry *
+    allocate(Addr addr, AccessPermission perm=AccessPermission_Read_Write)
+    {
+        tickHandler.setCurTick(++tick);
+        AbstractCacheEntry *entry = cache->allocate(addr, new Entry);
+        entry->changePermission(perm);
+        return entry;
+    }
+
+    /** Touch a line, as a protocol does on a hit. */
+    void
+    touch(Addr addr)
+    {
+        tickHandler.setCurTick(++tick);
+        cache->setMRU(addr);
+    }
+};
+
+} // anonymous namespace
+
+/** An empty cache misses everywhere, and has room everywhere. */
+TEST_F(CacheMemoryTest, EmptyMisses)
+{
+    for (int set = 0; set < numSets; set++) {
+        for (int line = 0; line < 2 * assoc; line++) {
+            const Addr addr = lineAddr(set, line);
+            ASSERT_EQ(cache->lookup(addr), nullptr);
+            ASSERT_FALSE(cache->isTagPresent(addr));
+            ASSERT_TRUE(cache->cacheAvail(addr));
+        }
+    }
+}
+
+/** An allocated line is found, in its set, and no other line is. */
+TEST_F(CacheMemoryTest, AllocateThenLookup)
+{
+    const Addr addr = lineAddr(5, 3);
+    AbstractCacheEntry *entry = cache->allocate(addr, new Entry);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_EQ(entry->m_Address, addr);
+    ASSERT_EQ(entry->getPermission(), AccessPermission_Invalid);
+    ASSERT_EQ(entry->getSet(), 5);
+
+    ASSERT_EQ(cache->lookup(addr), entry);
+    ASSERT_TRUE(cache->isTagPresent(addr));
+    ASSERT_FALSE(cache->isTagPresent(lineAddr(5, 4)));
+    ASSERT_FALSE(cache->isTagPresent(lineAddr(6, 3)));
+    ASSERT_FALSE(cache->isTagPresent(addr + blkSize));
+}
+
+/** Hits need a permission that allows the access. */
+TEST_F(CacheMemoryTest, AccessPermissions)
+{
+    const Addr addr = lineAddr(1, 0);
+    AbstractCacheEntry *entry = allocate(addr, AccessPermission_Read_Only);
+    DataBlock *data = nullptr;
+    ASSERT_TRUE(cache->tryCacheAccess(addr, RubyRequestType_LD, data));
+    ASSERT_FALSE(cache->tryCacheAccess(addr, RubyRequestType_ST, data));
+    ASSERT_EQ(data, nullptr);
+
+    entry->changePermission(AccessPermission_Read_Write);
+    ASSERT_TRUE(cache->tryCacheAccess(addr, RubyRequestType_ST, data));
+    ASSERT_EQ(data, &entry->getDataBlk());
+    ASSERT_TRUE(cache->testCacheAccess(addr, RubyRequestType_ST, data));
+
+    ASSERT_FALSE(cache->tryCacheAccess(lineAddr(1, 1), RubyRequestType_LD,
+                                       data));
+    ASSERT_EQ(cache->getAddressAtIdx(entry->getSet() * assoc +
+                                     entry->getWay()), addr);
+}
+
+/**
+ * A full set has no room for another line, and the victim it offers is
+ * its least recently used line. The other sets are not affected.
+ */
+TEST_F(CacheMemoryTest, FullSetProbesLRU)
+{
+    const int set = 9;
+    for (int line = 0; line < assoc; line++) {
+        ASSERT_TRUE(cache->cacheAvail(lineAddr(set, line)));
+        allocate(lineAddr(set, line));
+    }
+    ASSERT_FALSE(cache->cacheAvail(lineAddr(set, assoc)));
+    ASSERT_TRUE(cache->cacheAvail(lineAddr(set + 1, assoc)));
+    ASSERT_EQ(cache->cacheProbe(lineAddr(set, assoc)), lineAddr(set, 0));
+
+    touch(lineAddr(set, 0));
+    touch(lineAddr(set, 1));
+    ASSERT_EQ(cache->cacheProbe(lineAddr(set, assoc)), lineAddr(set, 2));
+
+    for (int line = 0; line < assoc; line++) {
+        ASSERT_TRUE(cache->isTagPresent(lineAddr(set, line)));
+    }
+}
+
+/** Deallocating a line frees its way for the next line of the set. */
+TEST_F(CacheMemoryTest, Deallocate)
+{
+    const int set = 2;
+    for (int line = 0; line < assoc; line++) {
+        allocate(lineAddr(set, line));
+    }
+    const uint32_t way = cache->lookup(lineAddr(set, 1))->getWay();
+
+    cache->deallocate(lineAddr(set, 1));
+    ASSERT_EQ(cache->lookup(lineAddr(set, 1)), nullptr);
+    ASSERT_FALSE(cache->isTagPresent(lineAddr(set, 1)));
+    ASSERT_TRUE(cache->cacheAvail(lineAddr(set, assoc)));
+
+    AbstractCacheEntry *entry = allocate(lineAddr(set, assoc));
+    ASSERT_EQ(entry->getWay(), way);
+    ASSERT_FALSE(cache->isTagPresent(lineAddr(set, 1)));
+    for (int line : {0, 2, 3, assoc}) {
+        ASSERT_TRUE(cache->isTagPresent(lineAddr(set, line)));
+    }
+}
+
+/**
+ * A NotPresent line is not found, and its way can be reused. Reusing
+ * the way with the same entry for another line also moves the tag, so
+ * the old line stays absent once the entry is valid again.
+ */
+TEST_F(CacheMemoryTest, NotPresentWayIsReused)
+{
+    const int set = 7;
+    for (int line = 0; line < assoc; line++) {
+        allocate(lineAddr(set, line));
+    }
+    AbstractCacheEntry *entry = cache->lookup(lineAddr(set, 2));
+    entry->changePermission(AccessPermission_NotPresent);
+    ASSERT_EQ(cache->lookup(lineAddr(set, 2)), nullptr);
+    ASSERT_FALSE(cache->isTagPresent(lineAddr(set, 2)));
+    ASSERT_TRUE(cache->cacheAvail(lineAddr(set, assoc)));
+
+    ASSERT_EQ(cache->allocate(lineAddr(set, assoc), entry), entry);
+    ASSERT_EQ(cache->lookup(lineAddr(set, assoc)), entry);
+    ASSERT_EQ(cache->lookup(lineAddr(set, 2)), nullptr);
+    ASSERT_FALSE(cache->cacheAvail(lineAddr(set, 2)));
+}
+
+/**
+ * Random allocations and deallocations over a few sets find the same
+ * lines as a map of the lines allocated.
+ */
+TEST_F(CacheMemoryTest, MatchesReference)
+{
+    std::map<Addr, AbstractCacheEntry *> lines;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> set_dist(0, 3);
+    std::uniform_int_distribution<int> line_dist(0, 2 * assoc - 1);
+
+    for (int i = 0; i < 20000; i++) {
+        const Addr addr = lineAddr(set_dist(gen), line_dist(gen));
+        auto it = lines.find(addr);
+        ASSERT_EQ(cache->lookup(addr),
+                  it == lines.end() ? nullptr : it->second);
+        if (it != lines.end()) {
+            if (gen() % 2) {
+                cache->deallocate(addr);
+                lines.erase(it);
+            } else {
+                touch(addr);
+            }
+        } else if (cache->cacheAvail(addr)) {
+            lines[addr] = allocate(addr);
+        } else {
+            const Addr victim = cache->cacheProbe(addr);
+            ASSERT_EQ(lines.count(victim), 1);
+            cache->deallocate(victim);
+            lines.erase(victim);
+            lines[addr] = allocate(addr);
+        }
+    }
+
+    for (int set = 0; set < numSets; set++) {
+        for (int line = 0; line < 2 * assoc; line++) {
+            const Addr addr = lineAddr(set, line);
+            ASSERT_EQ(cache->isTagPresent(addr), lines.count(addr) == 1);
+        }
+    }
+}
@@ -42,6 +42,9 @@
 
 #include "mem/snoop_filter.hh"
 
+#include <algorithm>
+
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
@@ -52,17 +55,195 @@ namespace gem5
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
+SnoopFilter::LineTable::LineTable(std::size_t max_lines)
+{
+    // Keep the table at most half full, in whole buckets
+    const std::size_t slots = std::size_t(1) <<
+        ceilLog2(std::max<std::size_t>(2 * max_lines, SlotsPerBucket));
+    slotMask = slots - 1;
+    hashShift = 64 - floorLog2(slots);
+
+    buckets.resize(slots / SlotsPerBucket);
+    items.reserve(max_lines);
+    for (auto &bucket : buckets) {
+        for (auto &s : bucket.slots) {
+            s = {EmptyLine, NotFound};
+        }
+    }
+}
+
+uint32_t
+SnoopFilter::LineTable::find(Addr line_addr) const
+{
+    for (std::size_t i = home(line_addr); ; i = (i + 1) & slotMask) {
+        const Slot &s = slot(i);
+        if (s.line == line_addr)
+            return s.item;
+        if (s.line == EmptyLine)
+            return NotFound;
+    }
+}
+
+uint32_t
+SnoopFilter::LineTable::insert(Addr line_addr)
+{
+    // probes end on an empty slot, so there must always be one
+    panic_if(size() == slotMask, "Snoop filter table is full\n");
+
+    uint32_t item;
+    if (freeItems.empty()) {
+        item = items.size();
+        items.emplace_back();
+    } else {
+        item = freeItems.back();
+        freeItems.pop_back();
+        items[item] = SnoopItem();
+    }
+
+    std::size_t i = home(line_addr);
+    while (slot(i).line != EmptyLine) {
+        assert(slot(i).line != line_addr);
+        i = (i + 1) & slotMask;
+    }
+    slot(i) = {line_addr, item};
+
+    return item;
+}
+
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::LineTable::erase(Addr line_addr)
+{
+    std::size_t hole = home(line_addr);
+    while (slot(hole).line != line_addr) {
+        assert(slot(hole).line != EmptyLine);
+        hole = (hole + 1) & slotMask;
+    }
+    freeItems.push_back(slot(hole).item);
+
+    // Move back the rest of the probe sequence, each line that the hole
+    // lies between its home slot and its current slot
+    for (std::size_t i = (hole + 1) & slotMask; slot(i).line != EmptyLine;
+         i = (i + 1) & slotMask) {
+        const std::size_t distance = (i - home(slot(i).line)) & slotMask;
+        if (distance >= ((i - hole) & slotMask)) {
+            slot(hole) = slot(i);
+            hole = i;
+        }
+    }
+    slot(hole).line = EmptyLine;
+}
+
+SnoopFilter::SnoopFilter(const SnoopFilterParams &p)
+    : SimObject(p), linesize(p.system->cacheLineSize()),
+      lookupLatency(p.lookup_latency),
+      maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
+      assoc(p.assoc), numSets(assoc ? maxEntryCount / assoc : 0),
+      cachedLocations(maxEntryCount),
+      ways(numSets * assoc, MaxAddr), wayTouched(numSets * assoc, 0),
+      stats(this)
 {
-    SnoopItem& sf_item = sf_it->second;
+    fatal_if(assoc && (!isPowerOf2(numSets) ||
+                       numSets * assoc != maxEntryCount),
+             "A finite snoop filter of %d lines must have a power of 2 "
+             "number of sets of %d ways\n", maxEntryCount, assoc);
+}
+
+void
+SnoopFilter::eraseIfNullEntry(Addr line_addr, uint32_t item)
+{
+    SnoopItem& sf_item = cachedLocations[item];
     if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
+        releaseLine(line_addr);
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
     }
 }
 
+uint32_t
+SnoopFilter::allocateLine(Addr line_addr)
+{
+    if (assoc) {
+        // Take a free way, or else the least recently used way without an
+        // outstanding request, which will be back-invalidated
+        const std::size_t base = setBase(line_addr);
+        std::size_t victim = ways.size();
+        for (std::size_t way = base; way < base + assoc; way++) {
+            if (ways[way] == MaxAddr) {
+                victim = way;
+                break;
+            }
+            const SnoopItem &item =
+                cachedLocations[cachedLocations.find(ways[way])];
+            if (item.requested.none() && (victim == ways.size() ||
+                                          wayTouched[way] < wayTouched[victim])) {
+                victim = way;
+            }
+        }
+        panic_if(victim == ways.size(), "All %d ways of snoop filter set "
+                 "%d have outstanding requests\n", assoc, base / assoc);
+
+        if (ways[victim] != MaxAddr) {
+            const Addr victim_line = ways[victim];
+            const SnoopItem &item =
+                cachedLocations[cachedLocations.find(victim_line)];
+
+            assert(!evicted);
+            evicted = true;
+            eviction.addr = victim_line & ~Addr(LineSecure);
+            eviction.secure = victim_line & LineSecure;
+            eviction.holders = maskToPortList(item.holder);
+            stats.backInvalidations++;
+
+            DPRINTF(SnoopFilter, "%s:   Dropped SF entry %#x, SF value "
+                    "%x.%x\n", __func__, victim_line, item.requested,
+                    item.holder);
+            cachedLocations.erase(victim_line);
+        }
+
+        ways[victim] = line_addr;
+        wayTouched[victim] = ++useCount;
+    }
+
+    return cachedLocations.insert(line_addr);
+}
+
+void
+SnoopFilter::releaseLine(Addr line_addr)
+{
+    if (assoc) {
+        const std::size_t base = setBase(line_addr);
+        auto way = std::find(ways.begin() + base,
+                             ways.begin() + base + assoc, line_addr);
+        assert(way != ways.begin() + base + assoc);
+        *way = MaxAddr;
+    }
+
+    cachedLocations.erase(line_addr);
+}
+
+void
+SnoopFilter::touchLine(Addr line_addr)
+{
+    if (assoc) {
+        const std::size_t base = setBase(line_addr);
+        auto way = std::find(ways.begin() + base,
+                             ways.begin() + base + assoc, line_addr);
+        assert(way != ways.begin() + base + assoc);
+        wayTouched[way - ways.begin()] = ++useCount;
+    }
+}
+
+bool
+SnoopFilter::takeEviction(Eviction &dropped)
+{
+    if (!evicted)
+        return false;
+
+    dropped = std::move(eviction);
+    evicted = false;
+    return true;
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
                            cpu_side_port)
@@ -78,8 +259,14 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(cpu_side_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    reqLookupResult.lineAddr = line_addr;
+    reqLookupResult.item = cachedLocations.find(line_addr);
+    bool is_hit = (reqLookupResult.item != LineTable::NotFound);
+
+    // A finite filter may already have dropped the line of an eviction
+    // with a back-invalidation, so do not track it again
+    if (assoc && cpkt->isEviction())
+        allocate = false;
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
@@ -87,12 +274,13 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
     if (!is_hit && !allocate)
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
+    // If no hit in snoop filter create a new element and update the item
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        reqLookupResult.item = allocateLine(line_addr);
+    } else {
+        touchLine(line_addr);
     }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    SnoopItem& sf_item = cachedLocations[reqLookupResult.item];
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -140,10 +328,11 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         }
     } else { // if (!cpkt->needsResponse())
         assert(cpkt->isEviction());
-        // make sure that the sender actually had the line
-        panic_if((sf_item.holder & req_port).none(), "requestor %x is not a " \
-                 "holder :( SF value %x.%x\n", req_port,
-                 sf_item.requested, sf_item.holder);
+        // make sure that the sender actually had the line, unless a finite
+        // filter back-invalidated it while the eviction was on its way
+        panic_if(!assoc && (sf_item.holder & req_port).none(),
+                 "requestor %x is not a holder :( SF value %x.%x\n",
+                 req_port, sf_item.requested, sf_item.holder);
         // CleanEvicts and Writebacks -> the sender and all caches above
         // it may not have the line anymore.
         if (!cpkt->isBlockCached()) {
@@ -159,10 +348,10 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.item != LineTable::NotFound) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
-        assert(reqLookupResult.it->first == \
+        assert(reqLookupResult.lineAddr == \
                 (is_secure ? ((addr & ~(Addr(linesize - 1))) | LineSecure) : \
                  (addr & ~(Addr(linesize - 1)))));
         if (will_retry) {
@@ -170,13 +359,14 @@ SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            cachedLocations[reqLookupResult.item] = retry_item;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        eraseIfNullEntry(reqLookupResult.lineAddr, reqLookupResult.item);
+        reqLookupResult.item = LineTable::NotFound;
     }
 }
 
@@ -191,10 +381,10 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    const uint32_t sf_it = cachedLocations.find(line_addr);
+    bool is_hit = (sf_it != LineTable::NotFound);
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
+    panic_if(!assoc && !is_hit && (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
              maxEntryCount);
 
@@ -204,7 +394,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (!is_hit)
         return snoopDown(lookupLatency);
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = cachedLocations[sf_it];
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
@@ -234,7 +424,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         sf_item.holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_it);
     }
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
@@ -264,7 +454,11 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    // The destination has a request in, so the line is tracked
+    const uint32_t sf_it = cachedLocations.find(line_addr);
+    panic_if(sf_it == LineTable::NotFound, "SF missing the original "
+             "request for %#x\n", line_addr);
+    SnoopItem& sf_item = cachedLocations[sf_it];
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -311,8 +505,8 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    const uint32_t sf_it = cachedLocations.find(line_addr);
+    bool is_hit = sf_it != LineTable::NotFound;
 
     // Nothing to do if it is not a hit
     if (!is_hit)
@@ -322,7 +516,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
+        SnoopItem& sf_item = cachedLocations[sf_it];
 
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
@@ -330,7 +524,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_it);
     }
 }
 
@@ -353,12 +547,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    const uint32_t sf_it = cachedLocations.find(line_addr);
+    if (sf_it == LineTable::NotFound)
         return;
 
     SnoopMask response_mask = portToMask(cpu_side_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = cachedLocations[sf_it];
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -377,7 +571,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~response_mask;
         }
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_it);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -405,7 +599,10 @@ SnoopFilter::SnoopFilterStats::SnoopFilterStats(statistics::Group *parent)
                "holder of the requested data."),
       ADD_STAT(hitMultiSnoops, statistics::units::Count::get(),
                "Number of snoops hitting in the snoop filter with multiple "
-               "(>1) holders of the requested data.")
+               "(>1) holders of the requested data."),
+      ADD_STAT(backInvalidations, statistics::units::Count::get(),
+               "Number of lines a finite snoop filter dropped and "
+               "back-invalidated.")
 {}
 
 void
@@ -44,8 +44,9 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
-#include <unordered_map>
+#include <cstdint>
 #include <utility>
+#include <vector>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
@@ -85,6 +86,12 @@ namespace gem5
  *     upper cache dropped a line, making the snoop filter pessimistic for now
  * (4) ordering: there is no single point of order in the system.  Instead,
  *     requesting MSHRs track order between local requests and remote snoops
+ *
+ * By default the filter tracks any number of lines, up to a sanity limit.
+ * With a non-zero associativity it instead models a real, finite snoop
+ * filter: lines live in sets, and making room for a new line drops the
+ * least recently used one without an outstanding request. The crossbar
+ * then back-invalidates the caches holding the dropped line.
  */
 class SnoopFilter : public SimObject
 {
@@ -95,13 +102,18 @@ class SnoopFilter : public SimObject
 
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
-        linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
-        maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
-        stats(this)
+    SnoopFilter(const SnoopFilterParams &p);
+
+    /** A line dropped from a finite snoop filter, to back-invalidate. */
+    struct Eviction
     {
-    }
+        /** Address of the line. */
+        Addr addr;
+        /** Whether the line is in the secure space. */
+        bool secure;
+        /** Ports holding the line. */
+        SnoopList holders;
+    };
 
     /**
      * Init a new snoop filter and tell it about all the cpu_sideports
@@ -153,6 +165,16 @@ class SnoopFilter : public SimObject
      */
     void finishRequest(bool will_retry, Addr addr, bool is_secure);
 
+    /**
+     * Take the line a finite snoop filter dropped to make room for the
+     * last request lookup. The filter no longer forwards snoops for the
+     * line, so the caller must back-invalidate its holders.
+     *
+     * @param eviction Filled in with the dropped line, if any.
+     * @return Whether a line was dropped.
+     */
+    bool takeEviction(Eviction &eviction);
+
     /**
      * Handle an incoming snoop from below (the memory-side port). These
      * can upgrade the tracking logic and may also benefit from
@@ -221,9 +243,88 @@ class SnoopFilter : public SimObject
         SnoopMask holder;
     };
     /**
-     * HashMap of SnoopItems indexed by line address
+     * SnoopItems indexed by line address, in an open-addressing hash
+     * table with linear probing. The table is allocated once, for the
+     * largest number of lines the filter tracks, and kept at most half
+     * full so that probes stay short. Slots are 16 bytes, four to a cache
+     * line, and a probe walks them in address order. Deleting shifts the
+     * following slots of the probe sequence back, so that no tombstones
+     * accumulate. The items themselves live in a pool and keep their
+     * index for as long as their line is tracked.
      */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+    class LineTable
+    {
+      public:
+        /** Item index of a line that is not in the table. */
+        static constexpr uint32_t NotFound = UINT32_MAX;
+
+        /** @param max_lines The largest number of lines tracked. */
+        LineTable(std::size_t max_lines);
+
+        /** @return The item of the line, or NotFound. */
+        uint32_t find(Addr line_addr) const;
+
+        /**
+         * Add a line that is not in the table yet.
+         *
+         * @return The item of the line, cleared.
+         */
+        uint32_t insert(Addr line_addr);
+
+        /** Remove a line and free its item. */
+        void erase(Addr line_addr);
+
+        SnoopItem &operator[](uint32_t item) { return items[item]; }
+
+        /** @return The number of lines in the table. */
+        std::size_t size() const { return items.size() - freeItems.size(); }
+
+      private:
+        /** Line address of an empty slot. Lines are aligned. */
+        static constexpr Addr EmptyLine = MaxAddr;
+
+        struct Slot
+        {
+            Addr line;
+            uint32_t item;
+        };
+
+        static constexpr unsigned SlotsPerBucket = 4;
+
+        /** The slots sharing a cache line. */
+        struct alignas(64) Bucket
+        {
+            Slot slots[SlotsPerBucket];
+        };
+
+        Slot &
+        slot(std::size_t i)
+        {
+            return buckets[i / SlotsPerBucket].slots[i % SlotsPerBucket];
+        }
+
+        const Slot &
+        slot(std::size_t i) const
+        {
+            return buckets[i / SlotsPerBucket].slots[i % SlotsPerBucket];
+        }
+
+        /** Home slot of a line, from the upper bits of a product hash. */
+        std::size_t
+        home(Addr line_addr) const
+        {
+            return (line_addr * 0x9e3779b97f4a7c15ULL) >> hashShift;
+        }
+
+        std::vector<Bucket> buckets;
+        /** Number of slots minus one, for wrapping probes. */
+        std::size_t slotMask;
+        /** Shift of the hash to the number of slots. */
+        int hashShift;
+
+        std::vector<SnoopItem> items;
+        std::vector<uint32_t> freeItems;
+    };
 
     /**
      * Simple factory methods for standard return values.
@@ -261,10 +362,28 @@ class SnoopFilter : public SimObject
     /**
      * Removes snoop filter items which have no requestors and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(Addr line_addr, uint32_t item);
 
-    /** Simple hash set of cached addresses. */
-    SnoopFilterCache cachedLocations;
+    /**
+     * Start tracking a line. A finite filter may have to drop another line
+     * of the set, which is then left for takeEviction().
+     *
+     * @return The item of the line.
+     */
+    uint32_t allocateLine(Addr line_addr);
+
+    /** Stop tracking a line. */
+    void releaseLine(Addr line_addr);
+
+    /** Mark a line as the most recently used of its set. */
+    void touchLine(Addr line_addr);
+
+    /** @return The first way of the set of a line. */
+    std::size_t
+    setBase(Addr line_addr) const
+    {
+        return ((line_addr / linesize) & (numSets - 1)) * assoc;
+    }
 
     /**
      * A request lookup must be followed by a call to finishRequest to inform
@@ -274,27 +393,18 @@ class SnoopFilter : public SimObject
      */
     struct ReqLookupResult
     {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /** Line of the item found or allocated by lookupRequest. */
+        Addr lineAddr = 0;
+
+        /** Item found or allocated by lookupRequest, if any. */
+        uint32_t item = LineTable::NotFound;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
          * in case finishRequest needs to undo changes made in lookupRequest
          * (because of crossbar retry)
          */
-        SnoopItem retryItem;
-
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
-        {
-        }
-        ReqLookupResult() = delete;
+        SnoopItem retryItem{0, 0};
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
@@ -305,8 +415,29 @@ class SnoopFilter : public SimObject
     const Addr linesize;
     /** Latency for doing a lookup in the filter */
     const Cycles lookupLatency;
-    /** Max capacity in terms of cache blocks tracked, for sanity checking */
+    /**
+     * Max capacity in terms of cache blocks tracked, for sanity checking,
+     * or the capacity of a finite filter.
+     */
     const unsigned maxEntryCount;
+    /** Associativity of a finite filter, 0 if unbounded. */
+    const unsigned assoc;
+    /** Number of sets of a finite filter. */
+    const unsigned numSets;
+
+    /** Cached addresses, and who requested or holds them. */
+    LineTable cachedLocations;
+
+    /** Line in each way of a finite filter, in set-major order. */
+    std::vector<Addr> ways;
+    /** When each way was last used, for LRU replacement. */
+    std::vector<uint64_t> wayTouched;
+    /** Use counter stamping wayTouched. */
+    uint64_t useCount = 0;
+
+    /** Line dropped by the last request lookup, if any. */
+    bool evicted = false;
+    Eviction eviction;
 
     /**
      * Use the lower bits of the address to keep track of the line status
@@ -329,6 +460,8 @@ class SnoopFilter : public SimObject
         statistics::Scalar totSnoops;
         statistics::Scalar hitSingleSnoops;
         statistics::Scalar hitMultiSnoops;
+
+        statistics::Scalar backInvalidations;
     } stats;
 };
 
@@ -27,6 +27,7 @@
 
 #include "mem/thread_bridge.hh"
 
+#include "base/logging.hh"
 #include "base/trace.hh"
 #include "sim/eventq.hh"
 
@@ -34,10 +35,84 @@ namespace gem5
 {
 
 ThreadBridge::ThreadBridge(const ThreadBridgeParams &p)
-    : SimObject(p), in_port_("in_port", *this), out_port_("out_port", *this)
+    : SimObject(p), in_port_("in_port", *this), out_port_("out_port", *this),
+      inQueue(getEventQueue(p.in_eventq_index)), delay(p.delay),
+      requests(*this, eventQueue(),
+               [this](PacketPtr pkt) { return out_port_.sendTimingReq(pkt); }),
+      snoopResponses(*this, eventQueue(),
+                     [this](PacketPtr pkt)
+                     { return out_port_.sendTimingSnoopResp(pkt); }),
+      responses(*this, inQueue,
+                [this](PacketPtr pkt) { return in_port_.sendTimingResp(pkt); })
 {
 }
 
+ThreadBridge::Crossing::Crossing(ThreadBridge &_bridge, EventQueue *_eq,
+                                 std::function<bool(PacketPtr)> _send)
+    : bridge(_bridge), eq(_eq), send(std::move(_send)),
+      eventName(_bridge.name() + ".crossing"), waitingRetry(false),
+      pending(0)
+{
+}
+
+void
+ThreadBridge::Crossing::push(PacketPtr pkt)
+{
+    // the other side runs up to a quantum ahead, anything sooner could
+    // arrive in its past
+    fatal_if(eq != curEventQueue() && bridge.delay < simQuantum,
+             "%s: delay %d is below the simulation quantum %d\n",
+             bridge.name(), bridge.delay, simQuantum);
+
+    const Tick when = curTick() + bridge.delay;
+    ++pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        inFlight.emplace_back(when, pkt);
+    }
+
+    // the queue of the other side takes events from this thread as
+    // asynchronous insertions
+    eq->schedule(new EventFunctionWrapper([this]{ arrive(); }, eventName,
+                                          true),
+                 when);
+}
+
+void
+ThreadBridge::Crossing::arrive()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!inFlight.empty() && inFlight.front().first <= curTick()) {
+            ready.push_back(inFlight.front().second);
+            inFlight.pop_front();
+        }
+    }
+    trySend();
+}
+
+void
+ThreadBridge::Crossing::retry()
+{
+    assert(waitingRetry);
+    waitingRetry = false;
+    trySend();
+}
+
+void
+ThreadBridge::Crossing::trySend()
+{
+    while (!waitingRetry && !ready.empty()) {
+        if (!send(ready.front())) {
+            waitingRetry = true;
+            return;
+        }
+        ready.pop_front();
+        if (--pending == 0)
+            bridge.checkDrained();
+    }
+}
+
 ThreadBridge::IncomingPort::IncomingPort(const std::string &name,
                                          ThreadBridge &device)
     : ResponsePort(name), device_(device)
@@ -54,12 +129,19 @@ ThreadBridge::IncomingPort::getAddrRanges() const
 bool
 ThreadBridge::IncomingPort::recvTimingReq(PacketPtr pkt)
 {
-    panic("ThreadBridge only supports atomic/functional access.");
+    device_.requests.push(pkt);
+    return true;
+}
+bool
+ThreadBridge::IncomingPort::recvTimingSnoopResp(PacketPtr pkt)
+{
+    device_.snoopResponses.push(pkt);
+    return true;
 }
 void
 ThreadBridge::IncomingPort::recvRespRetry()
 {
-    panic("ThreadBridge only supports atomic/functional access.");
+    device_.responses.retry();
 }
 
 // AtomicResponseProtocol
@@ -90,16 +172,72 @@ ThreadBridge::OutgoingPort::recvRangeChange()
     device_.in_port_.sendRangeChange();
 }
 
+bool
+ThreadBridge::OutgoingPort::isSnooping() const
+{
+    return device_.in_port_.isSnooping();
+}
+
 // TimingRequestProtocol
 bool
 ThreadBridge::OutgoingPort::recvTimingResp(PacketPtr pkt)
 {
-    panic("ThreadBridge only supports atomic/functional access.");
+    device_.responses.push(pkt);
+    return true;
+}
+void
+ThreadBridge::OutgoingPort::recvTimingSnoopReq(PacketPtr pkt)
+{
+    // snoops are answered in place, the responder expects to know
+    // right away whether a cache takes on the response
+    EventQueue::ScopedMigration migrate(device_.inQueue);
+    device_.in_port_.sendTimingSnoopReq(pkt);
 }
 void
 ThreadBridge::OutgoingPort::recvReqRetry()
 {
-    panic("ThreadBridge only supports atomic/functional access.");
+    device_.requests.retry();
+}
+void
+ThreadBridge::OutgoingPort::recvRetrySnoopResp()
+{
+    device_.snoopResponses.retry();
+}
+
+// AtomicRequestProtocol
+Tick
+ThreadBridge::OutgoingPort::recvAtomicSnoop(PacketPtr pkt)
+{
+    EventQueue::ScopedMigration migrate(device_.inQueue);
+    return device_.in_port_.sendAtomicSnoop(pkt);
+}
+
+// FunctionalRequestProtocol
+void
+ThreadBridge::OutgoingPort::recvFunctionalSnoop(PacketPtr pkt)
+{
+    EventQueue::ScopedMigration migrate(device_.inQueue);
+    device_.in_port_.sendFunctionalSnoop(pkt);
+}
+
+DrainState
+ThreadBridge::drain()
+{
+    if (requests.empty() && snoopResponses.empty() && responses.empty())
+        return DrainState::Drained;
+    return DrainState::Draining;
+}
+
+void
+ThreadBridge::checkDrained()
+{
+    // the crossings may empty on both sides at once, and only the first
+    // to see them all empty signals
+    std::lock_guard<std::mutex> lock(drainMutex);
+    if (drainState() == DrainState::Draining && requests.empty() &&
+        snoopResponses.empty() && responses.empty()) {
+        signalDrainDone();
+    }
 }
 
 Port &
@@ -28,8 +28,15 @@
 #ifndef __MEM_THREAD_BRIDGE_HH__
 #define __MEM_THREAD_BRIDGE_HH__
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
 #include "mem/port.hh"
 #include "params/ThreadBridge.hh"
+#include "sim/eventq.hh"
 #include "sim/sim_object.hh"
 
 namespace gem5
@@ -43,7 +50,55 @@ class ThreadBridge : public SimObject
     Port &getPort(const std::string &if_name,
                   PortID idx = InvalidPortID) override;
 
+    DrainState drain() override;
+
   private:
+    /**
+     * Timing packets crossing the bridge in one direction. The thread of
+     * the sending side hands them over under a lock, and they are sent
+     * on from the event queue of the receiving side after the delay, in
+     * the order they were handed over.
+     */
+    class Crossing
+    {
+      public:
+        Crossing(ThreadBridge &bridge, EventQueue *eq,
+                 std::function<bool(PacketPtr)> send);
+
+        /** Hand a packet over, on the thread of the sending side */
+        void push(PacketPtr pkt);
+
+        /** Send the packets refused before, on a retry */
+        void retry();
+
+        /** True if no packet is handed over but not yet taken */
+        bool empty() const { return pending == 0; }
+
+      private:
+        /** Take the packets that arrived by now and send them */
+        void arrive();
+
+        void trySend();
+
+        ThreadBridge &bridge;
+        EventQueue *eq;
+        std::function<bool(PacketPtr)> send;
+        const std::string eventName;
+
+        //! Packets handed over and their arrival tick, guarded by mutex
+        std::mutex mutex;
+        std::deque<std::pair<Tick, PacketPtr>> inFlight;
+
+        //! Packets that arrived and wait for the receiver to take them
+        std::deque<PacketPtr> ready;
+
+        //! True while the receiver refused a packet and owes a retry
+        bool waitingRetry;
+
+        //! Packets handed over but not yet taken, read by either side
+        std::atomic<unsigned> pending;
+    };
+
     class IncomingPort : public ResponsePort
     {
       public:
@@ -52,6 +107,7 @@ class ThreadBridge : public SimObject
 
         // TimingResponseProtocol
         bool recvTimingReq(PacketPtr pkt) override;
+        bool recvTimingSnoopResp(PacketPtr pkt) override;
         void recvRespRetry() override;
 
         // AtomicResponseProtocol
@@ -69,10 +125,19 @@ class ThreadBridge : public SimObject
       public:
         OutgoingPort(const std::string &name, ThreadBridge &device);
         void recvRangeChange() override;
+        bool isSnooping() const override;
 
         // TimingRequestProtocol
         bool recvTimingResp(PacketPtr pkt) override;
+        void recvTimingSnoopReq(PacketPtr pkt) override;
         void recvReqRetry() override;
+        void recvRetrySnoopResp() override;
+
+        // AtomicRequestProtocol
+        Tick recvAtomicSnoop(PacketPtr pkt) override;
+
+        // FunctionalRequestProtocol
+        void recvFunctionalSnoop(PacketPtr pkt) override;
 
       private:
         ThreadBridge &device_;
@@ -80,6 +145,29 @@ class ThreadBridge : public SimObject
 
     IncomingPort in_port_;
     OutgoingPort out_port_;
+
+    //! Event queue of the requestor side, the responder side is ours
+    EventQueue *inQueue;
+
+    const Tick delay;
+
+    //! Requests towards the responder side
+    Crossing requests;
+
+    //! Snoop responses towards the responder side
+    Crossing snoopResponses;
+
+    //! Responses towards the requestor side
+    Crossing responses;
+
+    //! Only one side may signal the end of a drain
+    std::mutex drainMutex;
+
+    /**
+     * Signal the end of a drain once no packet is crossing, called by
+     * a crossing, on the thread of its receiving side, when it empties.
+     */
+    void checkDrained();
 };
 
 }  // namespace gem5
@@ -164,6 +164,9 @@ class BaseXBar : public ClockedObject
          */
         void recvRetry();
 
+        /** True if a refused packet is waiting for a retry of the peer */
+        bool waitingForRetry() const { return waitingForPeer != NULL; }
+
       protected:
 
         /**
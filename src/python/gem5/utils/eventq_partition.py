@@ -0,0 +1,161 @@
+"""
+Partition a simulation over several event queues, so that it runs on as
+many host threads.
+
+Every domain, typically a core and its private caches, gets an event
+queue of its own, and everything else stays on queue 0. The memory ports
+that connect objects of different queues are spliced with a ThreadBridge,
+which hands the timing packets over to the other queue after a crossing
+latency. The simulation quantum, the time the queues may run apart, is
+set to the smallest crossing latency, so that no packet ever arrives in
+the past of its receiver. As nothing crosses faster, the queues only
+synchronize a quantum after the earliest event pending on any of them,
+see Root.adaptive_quantum.
+
+Example, with the L1s of each core on the queue of the core and the L2
+and the memory system on queue 0:
+
+.. code-block:: python
+
+    root = Root(full_system=False, system=system)
+    partition_event_queues(
+        root,
+        [
+            [system.cpu[i], system.icaches[i], system.dcaches[i]]
+            for i in range(len(system.cpu))
+        ],
+        crossing_latency="2ns",
+    )
+    m5.instantiate()
+
+The crossing latency is added to every packet that crosses, on top of
+the latency of the objects it crosses to, so it is best taken off those
+objects, e.g. the frontend latency of the crossbar behind the crossing.
+"""
+
+from typing import (
+    Callable,
+    List,
+    Union,
+)
+
+import m5
+from m5.objects import (
+    Root,
+    SimObject,
+    ThreadBridge,
+)
+from m5.params import PortRef
+from m5.proxy import isproxy
+from m5.util import (
+    fatal,
+    warn,
+)
+from m5.util.convert import toLatency
+
+
+def _eventq_index(obj: SimObject) -> int:
+    # objects inherit the queue of their parent unless they set one
+    while obj is not None:
+        index = obj.eventq_index
+        if not isproxy(index):
+            return int(index)
+        obj = obj._parent
+    return 0
+
+
+def _crossings(root: Root) -> List[PortRef]:
+    # the requestor end of every memory port connection between queues
+    crossings = []
+    for obj in root.descendants():
+        for ref in obj._port_refs.values():
+            elements = getattr(ref, "elements", [ref])
+            for el in elements:
+                peer = el.peer
+                if peer is None or isproxy(peer):
+                    continue
+                if _eventq_index(obj) == _eventq_index(peer.simobj):
+                    continue
+                if el.role == "GEM5 REQUESTOR":
+                    crossings.append(el)
+                elif el.role != "GEM5 RESPONDER":
+                    warn(
+                        f"{el} and {peer} run on different event queues "
+                        "but cannot be bridged"
+                    )
+    return crossings
+
+
+def partition_event_queues(
+    root: Root,
+    domains: List[List[SimObject]],
+    crossing_latency: Union[str, Callable[[PortRef, PortRef], str]],
+) -> List[ThreadBridge]:
+    """
+    Give every domain an event queue of its own and bridge the memory
+    ports that cross between queues. Call it once the system is
+    connected, before it is instantiated.
+
+    :param root: The root of the simulation.
+    :param domains: The objects of each domain. Domain ``i`` runs on event
+        queue ``i + 1`` with the children of its objects, everything else
+        runs on queue 0.
+    :param crossing_latency: The latency of the timing packets crossing
+        between queues, or a function returning it for the requestor and
+        the responder port of a crossing.
+
+    :returns: The bridges spliced into the crossings.
+    """
+    assigned = {}
+    for i, domain in enumerate(domains):
+        for obj in domain:
+            for child in obj.descendants():
+                if assigned.get(child, i + 1) != i + 1:
+                    fatal(f"{child} is part of two event queue domains")
+                assigned[child] = i + 1
+                child.eventq_index = i + 1
+
+    # decoders only share decoded instructions within an event queue
+    shared_queues = {
+        queue
+        for child, queue in assigned.items()
+        if "shared_cache" in child._params and child.shared_cache
+    }
+    if len(shared_queues) > 1:
+        warn(
+            "Decoders with shared_cache set run on "
+            f"{len(shared_queues)} event queues, and only share decoded "
+            "instructions within each queue"
+        )
+
+    bridges = []
+    quantum = None
+    for requestor in _crossings(root):
+        responder = requestor.peer
+        if callable(crossing_latency):
+            latency = crossing_latency(requestor, responder)
+        else:
+            latency = crossing_latency
+        if toLatency(latency) <= 0:
+            fatal(f"{requestor} to {responder} needs a crossing latency")
+        if quantum is None or toLatency(latency) < toLatency(quantum):
+            quantum = latency
+
+        bridge = ThreadBridge(
+            eventq_index=_eventq_index(responder.simobj),
+            in_eventq_index=_eventq_index(requestor.simobj),
+            delay=latency,
+        )
+        name = requestor.name
+        if requestor.index >= 0:
+            name += str(requestor.index)
+        setattr(requestor.simobj, f"{name}_bridge", bridge)
+        requestor.splice(bridge.in_port, bridge.out_port)
+        bridges.append(bridge)
+
+    if quantum is not None:
+        m5.ticks.fixGlobalFrequency()
+        root.sim_quantum = m5.ticks.fromSeconds(toLatency(quantum))
+        root.adaptive_quantum = True
+
+    return bridges
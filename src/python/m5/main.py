@@ -301,6 +301,14 @@ def parse_options():
         help="Sets the output file for debug. Append '.gz' to the name for it"
         " to be compressed automatically [Default: %default]",
     )
+    option(
+        "--debug-binary",
+        action="store_true",
+        default=False,
+        help="Record the debug output unformatted into --debug-file, "
+        "trace.bin by default, which is much faster. Decode it with "
+        "util/decode_binary_trace.py",
+    )
     option(
         "--debug-activate",
         metavar="EXPR[,EXPR]",
@@ -623,7 +631,14 @@ def main():
         e = event.create(trace.disable, event.Event.Debug_Enable_Pri)
         event.mainq.schedule(e, options.debug_end)
 
-    trace.output(options.debug_file)
+    if options.debug_binary:
+        _check_tracing()
+        if options.debug_file in ("cout", "cerr"):
+            trace.outputBinary("trace.bin")
+        else:
+            trace.outputBinary(options.debug_file)
+    else:
+        trace.output(options.debug_file)
 
     for activate in options.debug_activate:
         _check_tracing()
@@ -190,6 +190,30 @@ def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
     return _m5.stats.initHDF5(fn, chunking, desc, formulas)
 
 
+@_url_factory(["bin"])
+def _binaryFactory(fn, desc=True):
+    """Output stats as raw values in a binary file.
+
+    The names, units and descriptions of the stats are written once,
+    every dump then appends the raw values of all stats as one frame
+    of doubles. Dumps are much faster and the file much smaller than
+    with the text format, which matters with frequent periodic dumps.
+    util/read_binary_stats.py reads the frames back as arrays.
+
+    Known limitations:
+      * Sparse histograms currently unsupported.
+
+    Parameters:
+      * desc (bool): Output stat descriptions (default: True)
+
+    Example:
+      bin://stats.bin?desc=False
+
+    """
+
+    return _m5.stats.initBinary(fn, desc)
+
+
 @_url_factory(["json"])
 def _jsonFactory(fn):
     """Output stats in JSON format.
@@ -67,6 +67,13 @@ output(const char *filename)
     trace::setDebugLogger(new trace::OstreamLogger(*file_stream->stream()));
 }
 
+static void
+outputBinary(const char *filename)
+{
+    trace::setDebugLogger(
+        new trace::BinaryLogger(simout.resolve(filename)));
+}
+
 static void
 activate(const char *expr)
 {
@@ -129,6 +136,7 @@ pybind_init_debug(py::module_ &m_native)
     py::module_ m_trace = m_native.def_submodule("trace");
     m_trace
         .def("output", &output)
+        .def("outputBinary", &outputBinary)
         .def("activate", &activate)
         .def("ignore", &ignore)
         .def("enable", &trace::enable)
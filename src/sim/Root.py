@@ -68,6 +68,21 @@ class Root(SimObject):
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # Synchronize the queues a quantum after the earliest pending event
+    # rather than every quantum, which skips the barriers while the
+    # queues are idle. Only safe if everything crossing between queues
+    # takes at least a quantum, as with a ThreadBridge.
+    adaptive_quantum = Param.Bool(
+        False, "Grow the quantum to the earliest pending event"
+    )
+
+    # Index the pending events of the main event queues by time rather
+    # than walking the queues to insert and remove them, which pays off
+    # once hundreds of events are pending. Events run in the same order.
+    calendar_event_queues = Param.Bool(
+        False, "Index the event queues with a calendar"
+    )
+
     full_system = Param.Bool("if this is a full system simulation")
 
     # Time syncing prevents the simulation from running faster than real time.
@@ -113,6 +113,30 @@ class System(SimObject):
         "shared_backstore is non-empty.",
     )
 
+    checkpoint_threads = Param.Unsigned(
+        0,
+        "Host threads compressing and decompressing the memory of "
+        "checkpoints, 0 uses one per host core",
+    )
+    checkpoint_compress = Param.Bool(
+        True,
+        "Compress the memory of checkpoints, rather than storing it raw "
+        "so that it can be restored lazily",
+    )
+    lazy_restore = Param.Bool(
+        False,
+        "Map the raw memory of checkpoints copy-on-write on restore, so "
+        "pages are only read when touched and shared with other runs "
+        "restoring the same checkpoint",
+    )
+    lazy_restore_check = Param.Bool(
+        True,
+        "Check, whenever a checkpoint is taken, that the memory images "
+        "mapped by lazy_restore kept their size and modification time, "
+        "as a change shows in the simulated memory, or crashes it with a "
+        "SIGBUS",
+    )
+
     cache_line_size = Param.Unsigned(64, "Cache line size in bytes")
 
     redirect_paths = VectorParam.RedirectPath([], "Path redirections")
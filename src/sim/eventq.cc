@@ -37,6 +37,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "cpu/smt.hh"
@@ -46,6 +47,8 @@ namespace gem5
 {
 
 Tick simQuantum = 0;
+bool adaptiveQuantum = false;
+bool calendarEventQueues = false;
 
 //
 // Main Event Queues
@@ -57,6 +60,7 @@ uint32_t numMainEventQueues = 0;
 std::vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
+uint64_t asyncEpoch = 0;
 
 EventQueue *
 getEventQueue(uint32_t index)
@@ -64,7 +68,9 @@ getEventQueue(uint32_t index)
     while (numMainEventQueues <= index) {
         numMainEventQueues++;
         mainEventQueue.push_back(
-            new EventQueue(csprintf("MainEventQueue-%d", index)));
+            new EventQueue(csprintf("MainEventQueue-%d", index),
+                           numMainEventQueues - 1));
+        mainEventQueue.back()->useCalendar(calendarEventQueues);
     }
 
     return mainEventQueue[index];
@@ -134,9 +140,281 @@ Event::releaseImpl()
         delete this;
 }
 
+/**
+ * A calendar of the bins of an event queue. It covers a window of
+ * NumSlots slots of SlotTicks ticks each, starting at or before the
+ * current tick, and points to the first and last bin of each slot so
+ * that finding the place of an event only walks the bins of its own
+ * slot. Bins past the window are only found on the list, and are
+ * added to the calendar as the window moves over them. The calendar
+ * never changes the list, so events run in the same order, by time,
+ * priority and then the reverse order of insertion, as without one.
+ */
+class EventQueue::Calendar
+{
+  private:
+    static constexpr unsigned SlotShift = 8;
+    static constexpr Tick SlotTicks = Tick(1) << SlotShift;
+    static constexpr unsigned NumSlots = 4096;
+    static constexpr Tick Span = Tick(NumSlots) << SlotShift;
+
+    //! The top events of the first and last bins of each slot
+    Event *first[NumSlots];
+    Event *last[NumSlots];
+
+    //! One bit per slot that has bins, and one per word of those
+    //! that is not zero
+    uint64_t used[NumSlots / 64];
+    uint64_t usedWords;
+    static_assert(NumSlots / 64 <= 64, "Too many slots for usedWords");
+
+    //! Start of the window, aligned to a slot
+    Tick base;
+
+    static unsigned slot(Tick when) { return (when >> SlotShift) % NumSlots; }
+
+    //! Position of a slot in the window
+    unsigned
+    offset(unsigned s) const
+    {
+        return (s - slot(base)) % NumSlots;
+    }
+
+    void
+    clear()
+    {
+        std::fill(std::begin(first), std::end(first), nullptr);
+        std::fill(std::begin(last), std::end(last), nullptr);
+        std::fill(std::begin(used), std::end(used), 0);
+        usedWords = 0;
+    }
+
+    void
+    setUsed(unsigned s)
+    {
+        used[s / 64] |= uint64_t(1) << (s % 64);
+        usedWords |= uint64_t(1) << (s / 64);
+    }
+
+    void
+    clearUsed(unsigned s)
+    {
+        used[s / 64] &= ~(uint64_t(1) << (s % 64));
+        if (!used[s / 64])
+            usedWords &= ~(uint64_t(1) << (s / 64));
+    }
+
+    //! The last used slot of [lo, hi), or -1
+    int
+    lastUsed(unsigned lo, unsigned hi) const
+    {
+        while (hi > lo) {
+            const unsigned w = (hi - 1) / 64;
+            uint64_t bits = used[w];
+            if (hi - w * 64 < 64)
+                bits &= mask(hi - w * 64);
+            if (lo > w * 64)
+                bits &= ~mask(lo - w * 64);
+            if (bits)
+                return w * 64 + findMsbSet(bits);
+
+            // skip to the last word below with any slot used
+            const uint64_t words = usedWords & mask(w);
+            if (!words)
+                return -1;
+            hi = (findMsbSet(words) + 1) * 64;
+        }
+        return -1;
+    }
+
+    //! Add a bin that comes after all the bins of its slot
+    void
+    append(Event *bin)
+    {
+        const unsigned s = slot(bin->when());
+        if (!first[s]) {
+            first[s] = bin;
+            setUsed(s);
+        }
+        last[s] = bin;
+    }
+
+  public:
+    Calendar(Event *head, Tick tick) { reset(head, tick); }
+
+    Tick start() const { return base; }
+
+    bool
+    inWindow(Tick when) const
+    {
+        return when >= base && when - base < Span;
+    }
+
+    /**
+     * Move the window to start at a tick, or at the head if that is
+     * earlier, and index the bins in it again.
+     */
+    void
+    reset(Event *head, Tick tick)
+    {
+        clear();
+        if (head)
+            tick = std::min(tick, head->when());
+        base = tick & ~(SlotTicks - 1);
+        for (Event *bin = head; bin && inWindow(bin->when());
+             bin = bin->nextBin) {
+            append(bin);
+        }
+    }
+
+    /**
+     * The last bin of the window in slots before the position of a
+     * slot in the window, nullptr if there is none.
+     */
+    Event *
+    lastBinBefore(unsigned pos) const
+    {
+        const unsigned lo = slot(base);
+        int s;
+        if (lo + pos > NumSlots) {
+            s = lastUsed(0, lo + pos - NumSlots);
+            if (s < 0)
+                s = lastUsed(lo, NumSlots);
+        } else {
+            s = lastUsed(lo, lo + pos);
+        }
+        return s < 0 ? nullptr : last[s];
+    }
+
+    /**
+     * The last bin that goes before an event, nullptr if the event
+     * goes first.
+     */
+    Event *
+    binBefore(const Event &event, Event *head) const
+    {
+        if (!head || event <= *head)
+            return nullptr;
+
+        Event *bin;
+        if (inWindow(event.when())) {
+            const unsigned s = slot(event.when());
+            bin = first[s];
+            if (!bin || event <= *bin)
+                return lastBinBefore(offset(s));
+        } else {
+            // the bins past the window are only on the list
+            bin = lastBinBefore(NumSlots);
+            if (!bin)
+                bin = head;
+        }
+
+        while (bin->nextBin && *bin->nextBin < event)
+            bin = bin->nextBin;
+        return bin;
+    }
+
+    /**
+     * Account for an event that has become the top of its bin, in a
+     * new bin or on top of one.
+     */
+    void
+    inserted(Event *event)
+    {
+        if (!inWindow(event->when()))
+            return;
+
+        const unsigned s = slot(event->when());
+        if (!first[s]) {
+            first[s] = last[s] = event;
+            setUsed(s);
+            return;
+        }
+        if (*event <= *first[s])
+            first[s] = event;
+        if (*event >= *last[s])
+            last[s] = event;
+    }
+
+    /**
+     * Account for the removal of an event from a bin.
+     *
+     * @param top The former top of the bin
+     * @param next The new top of the bin, or the next bin if it is gone
+     * @param prev The bin before, nullptr if it was the first
+     */
+    void
+    removed(Event *top, Event *next, Event *prev)
+    {
+        if (!inWindow(top->when()))
+            return;
+
+        const unsigned s = slot(top->when());
+        if (next && *next == *top) {
+            // the bin is still there with a new top
+            if (first[s] == top)
+                first[s] = next;
+            if (last[s] == top)
+                last[s] = next;
+        } else if (first[s] == top && last[s] == top) {
+            first[s] = last[s] = nullptr;
+            clearUsed(s);
+        } else if (first[s] == top) {
+            first[s] = next;
+        } else if (last[s] == top) {
+            last[s] = prev;
+        }
+    }
+
+    /**
+     * Move the window forward to the current tick, or to the head if
+     * that is earlier. The slots left behind hold no bins, and the
+     * bins that enter the window are indexed.
+     */
+    void
+    advance(Event *head, Tick tick)
+    {
+        if (head)
+            tick = std::min(tick, head->when());
+        const Tick new_base = tick & ~(SlotTicks - 1);
+        if (new_base <= base)
+            return;
+
+        Event *bin = lastBinBefore(NumSlots);
+        bin = bin ? bin->nextBin : head;
+        base = new_base;
+        for (; bin && inWindow(bin->when()); bin = bin->nextBin)
+            append(bin);
+    }
+};
+
+void
+EventQueue::useCalendar(bool enable)
+{
+    if (!enable)
+        calendar.reset();
+    else if (!calendar)
+        calendar.reset(new Calendar(head, getCurTick()));
+}
+
 void
 EventQueue::insert(Event *event)
 {
+    if (calendar) {
+        // events are not scheduled in the past, but curTick may be
+        // moved back, e.g. when Ruby flushes its caches
+        if (event->when() < calendar->start())
+            calendar->reset(head, event->when());
+
+        Event *prev = calendar->binBefore(*event, head);
+        if (prev)
+            prev->nextBin = Event::insertBefore(event, prev->nextBin);
+        else
+            head = Event::insertBefore(event, head);
+        calendar->inserted(event);
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -196,6 +474,21 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    if (calendar) {
+        Event *prev = calendar->binBefore(*event, head);
+        Event *top = prev ? prev->nextBin : head;
+        if (!top || *top != *event)
+            panic("event not found!");
+
+        Event *next = Event::removeItem(event, top);
+        if (prev)
+            prev->nextBin = next;
+        else
+            head = next;
+        calendar->removed(top, next, prev);
+        return;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -240,10 +533,15 @@ EventQueue::serviceOne()
         head = head->nextBin;
     }
 
+    if (calendar)
+        calendar->removed(event, head, nullptr);
+
     // handle action
     if (!event->squashed()) {
         // forward current cycle to the time when this event occurs.
         setCurTick(event->when());
+        if (calendar)
+            calendar->advance(head, getCurTick());
         if (debug::Event)
             event->trace("executed");
         event->process();
@@ -383,6 +681,8 @@ EventQueue::replaceHead(Event* s)
 {
     Event* t = head;
     head = s;
+    if (calendar)
+        calendar->reset(head, getCurTick());
     return t;
 }
 
@@ -441,28 +741,67 @@ Event::dump() const
     }
 }
 
-EventQueue::EventQueue(const std::string &n)
-    : objName(n), head(NULL), _curTick(0)
+EventQueue::EventQueue(const std::string &n, uint32_t index)
+    : objName(n), head(NULL), _curTick(0), index(index), barrierWait(0),
+      barriers(0)
 {
 }
 
+EventQueue::~EventQueue()
+{
+    while (!empty())
+        deschedule(getHead());
+}
+
 void
 EventQueue::asyncInsert(Event *event)
 {
+    const EventQueue *source = curEventQueue();
     async_queue_mutex.lock();
-    async_queue.push_back(event);
+    async_queue.push_back({asyncEpoch, source ? source->index : 0, event});
     async_queue_mutex.unlock();
 }
 
+Tick
+EventQueue::nextSendTick()
+{
+    Tick tick = empty() ? MaxTick : nextTick();
+
+    async_queue_mutex.lock();
+    for (const auto &async : async_queue)
+        tick = std::min(tick, async.event->when());
+    async_queue_mutex.unlock();
+
+    return tick;
+}
+
 void
 EventQueue::handleAsyncInsertions()
 {
     assert(this == curEventQueue());
     async_queue_mutex.lock();
 
-    while (!async_queue.empty()) {
-        insert(async_queue.front());
-        async_queue.pop_front();
+    // The threads add their events in whatever order they run in, so
+    // insert them by the queue that sent them, which keeps the order
+    // each queue sent its own events in, to service the events of the
+    // same time and priority in the same order in every run. The events
+    // of the current epoch were sent by threads that already left the
+    // barrier, they wait for the next one.
+    async_queue.sort([](const auto &a, const auto &b) {
+        return a.source < b.source;
+    });
+
+    for (auto it = async_queue.begin(); it != async_queue.end();) {
+        if (it->epoch == asyncEpoch) {
+            ++it;
+            continue;
+        }
+        panic_if(it->event->when() < getCurTick(),
+                 "%s sent by event queue %d for %d, in the past of %s "
+                 "at %d.", it->event->name(), it->source, it->event->when(),
+                 name(), getCurTick());
+        insert(it->event);
+        it = async_queue.erase(it);
     }
 
     async_queue_mutex.unlock();
@@ -68,6 +68,16 @@ class BaseGlobalEvent;
 //! Queue B should be at least simQuantum ticks away in future.
 extern Tick simQuantum;
 
+//! Whether the queues synchronize a quantum after the earliest event
+//! pending on any of them, rather than every quantum. No queue sends an
+//! event to another before it services its next one, so the queues can
+//! run apart up to there without breaking the rule above.
+extern bool adaptiveQuantum;
+
+//! Whether new main event queues index their events with a calendar,
+//! see EventQueue::useCalendar().
+extern bool calendarEventQueues;
+
 //! Current number of allocated main event queues.
 extern uint32_t numMainEventQueues;
 
@@ -82,6 +92,11 @@ extern __thread EventQueue *_curEventQueue;
 //! Current mode of execution: parallel / serial
 extern bool inParallelMode;
 
+//! Number of times the threads synchronized since gem5 started. Only
+//! changes while every thread waits, see
+//! EventQueue::handleAsyncInsertions().
+extern uint64_t asyncEpoch;
+
 //! Function for returning eventq queue for the provided
 //! index. The function allocates a new queue in case one
 //! does not exist for the index, provided that the index
@@ -607,10 +622,11 @@ operator!=(const Event &l, const Event &r)
  * deterministic. This causes the event to be inserted in a separate
  * queue of asynchronous events (async_queue), which is merged main
  * event queue at the end of each simulation quantum (by calling the
- * handleAsyncInsertions() method). Note that this implies that such
- * events must happen at least one simulation quantum into the future,
- * otherwise they risk being scheduled in the past by
- * handleAsyncInsertions().
+ * handleAsyncInsertions() method), ordered by the queue that sent
+ * them rather than by the order the threads ran in. Note that this
+ * implies that such events must happen at least one simulation
+ * quantum into the future, handleAsyncInsertions() panics on events
+ * that would be scheduled in the past.
  */
 class EventQueue
 {
@@ -621,11 +637,35 @@ class EventQueue
     Event *head;
     Tick _curTick;
 
+    //! Index of this queue, orders the events it sends to other queues
+    uint32_t index;
+
+    class Calendar;
+
+    //! Index of the near-future bins, nullptr if the list is walked
+    std::unique_ptr<Calendar> calendar;
+
     //! Mutex to protect async queue.
     UncontendedMutex async_queue_mutex;
 
+    //! An event added by another thread to this event queue
+    struct AsyncInsertion
+    {
+        //! asyncEpoch when the event was added
+        uint64_t epoch;
+        //! Index of the queue that added it
+        uint32_t source;
+        Event *event;
+    };
+
     //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    std::list<AsyncInsertion> async_queue;
+
+    //! Host seconds spent waiting for other queues at global barriers
+    double barrierWait;
+
+    //! Number of global barriers waited at
+    Counter barriers;
 
     /**
      * Lock protecting event handling.
@@ -738,7 +778,7 @@ class EventQueue
     /**
      * @ingroup api_eventq
      */
-    EventQueue(const std::string &n);
+    EventQueue(const std::string &n, uint32_t index=0);
 
     /**
      * @ingroup api_eventq
@@ -804,6 +844,18 @@ class EventQueue
         event->release();
     }
 
+    /**
+     * Find where events go in the queue with a calendar of the near
+     * future rather than by walking the queue, which takes long once
+     * hundreds of events are pending. The events and their order are
+     * the same either way, so this can be switched at any time.
+     *
+     * @param enable Whether to use a calendar
+     */
+    void useCalendar(bool enable);
+
+    bool usesCalendar() const { return calendar != nullptr; }
+
     /**
      * Reschedule the specified event. Should be called only from the owning
      * thread.
@@ -836,6 +888,27 @@ class EventQueue
     Tick nextTick() const { return head->when(); }
     void setCurTick(Tick newVal) { _curTick = newVal; }
 
+    /**
+     * The earliest tick this queue could send an event to another queue
+     * at, which is the tick of its next event, including the events
+     * other threads inserted into it. Only meaningful while the queue is
+     * not being serviced, e.g. while its thread waits at a barrier.
+     *
+     * @return MaxTick if no event is pending
+     */
+    Tick nextSendTick();
+
+    /** Account for a wait of the given host seconds at a barrier */
+    void
+    addBarrierWait(double seconds)
+    {
+        barrierWait += seconds;
+        ++barriers;
+    }
+
+    double barrierWaitSeconds() const { return barrierWait; }
+    Counter barrierCount() const { return barriers; }
+
     /**
      * While curTick() is useful for any object assigned to this event queue,
      * if an object that is assigned to another event queue (or a non-event
@@ -902,6 +975,9 @@ class EventQueue
 
     /**
      * Function for moving events from the async_queue to the main queue.
+     * Only moves the events added before the current asyncEpoch, as the
+     * other threads may already be servicing the next quantum and adding
+     * events for the next merge.
      */
     void handleAsyncInsertions();
 
@@ -961,11 +1037,7 @@ class EventQueue
      */
     void checkpointReschedule(Event *event);
 
-    virtual ~EventQueue()
-    {
-        while (!empty())
-            deschedule(getHead());
-    }
+    virtual ~EventQueue();
 };
 
 inline void
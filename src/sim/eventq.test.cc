@@ -0,0 +1,329 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Records the order events run in */
+class RecordEvent : public Event
+{
+  public:
+    std::vector<int> &order;
+    const int id;
+
+    RecordEvent(std::vector<int> &_order, int _id, Priority p)
+        : Event(p), order(_order), id(_id)
+    {}
+
+    void process() override { order.push_back(id); }
+};
+
+/**
+ * Run the same random mix of schedules, deschedules and reschedules on
+ * a queue, with or without a calendar, and return the order the events
+ * ran in.
+ */
+std::vector<int>
+runRandom(bool use_calendar, unsigned seed, Tick max_delay)
+{
+    EventQueue eq("eq");
+    eq.useCalendar(use_calendar);
+    curEventQueue(&eq);
+
+    std::vector<int> order;
+    std::vector<RecordEvent *> events;
+    const int num_events = 500;
+    for (int i = 0; i < num_events; i++) {
+        // few priorities and coarse times so many events share bins
+        events.push_back(new RecordEvent(order, i,
+                                         Event::Default_Pri + i % 3));
+    }
+
+    std::mt19937 rng(seed);
+    auto delay = [&]() { return (rng() % max_delay) / 500 * 500; };
+
+    for (int step = 0; step < 20000; step++) {
+        RecordEvent *event = events[rng() % num_events];
+        switch (rng() % 4) {
+          case 0:
+          case 1:
+            if (!event->scheduled())
+                eq.schedule(event, eq.getCurTick() + delay());
+            break;
+          case 2:
+            if (event->scheduled())
+                eq.deschedule(event);
+            break;
+          case 3:
+            eq.reschedule(event, eq.getCurTick() + delay(), true);
+            break;
+        }
+
+        if (rng() % 4 == 0 && !eq.empty())
+            eq.serviceOne();
+    }
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    for (auto *event : events)
+        delete event;
+    curEventQueue(nullptr);
+
+    return order;
+}
+
+} // anonymous namespace
+
+/** Events within the calendar window run in the same order. */
+TEST(EventQueueTest, CalendarKeepsOrderNearFuture)
+{
+    for (unsigned seed = 0; seed < 4; seed++) {
+        auto list = runRandom(false, seed, 100000);
+        EXPECT_FALSE(list.empty());
+        EXPECT_EQ(list, runRandom(true, seed, 100000));
+    }
+}
+
+/** Events past the calendar window run in the same order. */
+TEST(EventQueueTest, CalendarKeepsOrderFarFuture)
+{
+    for (unsigned seed = 0; seed < 4; seed++) {
+        auto list = runRandom(false, seed, 100000000);
+        EXPECT_FALSE(list.empty());
+        EXPECT_EQ(list, runRandom(true, seed, 100000000));
+    }
+}
+
+/** Events of the same time and priority run last in, first out. */
+TEST(EventQueueTest, CalendarSameBinIsLifo)
+{
+    EventQueue eq("eq");
+    eq.useCalendar(true);
+    curEventQueue(&eq);
+
+    std::vector<int> order;
+    RecordEvent a(order, 0, Event::Default_Pri);
+    RecordEvent b(order, 1, Event::Default_Pri);
+    RecordEvent c(order, 2, Event::Default_Pri - 1);
+    eq.schedule(&a, 1000);
+    eq.schedule(&b, 1000);
+    eq.schedule(&c, 1000);
+
+    while (!eq.empty())
+        eq.serviceOne();
+    curEventQueue(nullptr);
+
+    EXPECT_EQ(order, std::vector<int>({2, 1, 0}));
+}
+
+/**
+ * Moving the current tick back and replacing the head, as Ruby does to
+ * flush and warm up its caches, keeps the calendar consistent.
+ */
+TEST(EventQueueTest, CalendarSurvivesReplacedHead)
+{
+    EventQueue eq("eq");
+    eq.useCalendar(true);
+    curEventQueue(&eq);
+
+    std::vector<int> order;
+    RecordEvent a(order, 0, Event::Default_Pri);
+    RecordEvent b(order, 1, Event::Default_Pri);
+    RecordEvent c(order, 2, Event::Default_Pri);
+    eq.setCurTick(50000000);
+    eq.schedule(&a, 60000000);
+
+    Event *saved = eq.replaceHead(nullptr);
+    eq.setCurTick(0);
+    eq.schedule(&b, 2000);
+    while (!eq.empty())
+        eq.serviceOne();
+
+    eq.replaceHead(saved);
+    eq.setCurTick(50000000);
+    eq.schedule(&c, 50001000);
+    while (!eq.empty())
+        eq.serviceOne();
+    curEventQueue(nullptr);
+
+    EXPECT_EQ(order, std::vector<int>({1, 2, 0}));
+}
+
+namespace
+{
+
+// The ticks of a slot and of the whole window of the calendar
+const Tick slotTicks = 256;
+const Tick windowTicks = 4096 * slotTicks;
+
+/** Run all the events of a queue. */
+void
+drain(EventQueue &eq)
+{
+    while (!eq.empty())
+        eq.serviceOne();
+}
+
+} // anonymous namespace
+
+/**
+ * Events on both sides of the point where the slots of the window wrap
+ * around, including events a whole window apart, which share a slot,
+ * run in time order.
+ */
+TEST(EventQueueTest, CalendarWrapsAround)
+{
+    EventQueue eq("eq");
+    const Tick start = 3 * windowTicks - 10 * slotTicks;
+    eq.setCurTick(start);
+    eq.useCalendar(true);
+    curEventQueue(&eq);
+
+    std::vector<int> order;
+    const std::vector<Tick> whens = {
+        start,
+        3 * windowTicks - 1,
+        3 * windowTicks + 2 * slotTicks,
+        start + 5 * slotTicks,
+        3 * windowTicks,
+        start + windowTicks + 5 * slotTicks,    // same slot as id 3
+        4 * windowTicks - 1,
+    };
+    std::vector<std::unique_ptr<RecordEvent>> events;
+    for (std::size_t i = 0; i < whens.size(); i++) {
+        events.emplace_back(
+            new RecordEvent(order, i, Event::Default_Pri));
+        eq.schedule(events.back().get(), whens[i]);
+    }
+
+    drain(eq);
+    curEventQueue(nullptr);
+
+    EXPECT_EQ(order, std::vector<int>({0, 3, 1, 4, 2, 5, 6}));
+}
+
+/**
+ * Events past the window join it as it moves forward, and keep their
+ * order with the events scheduled among them once they are in it.
+ */
+TEST(EventQueueTest, CalendarWindowMoves)
+{
+    EventQueue eq("eq");
+    eq.useCalendar(true);
+    curEventQueue(&eq);
+
+    std::vector<int> order;
+    RecordEvent near(order, 0, Event::Default_Pri);
+    RecordEvent far1(order, 1, Event::Default_Pri);
+    RecordEvent far2(order, 2, Event::Default_Pri);
+    RecordEvent far3(order, 3, Event::Default_Pri);
+    RecordEvent between(order, 4, Event::Default_Pri);
+    RecordEvent same(order, 5, Event::Default_Pri);
+    RecordEvent after(order, 6, Event::Default_Pri);
+    eq.schedule(&far3, 5 * windowTicks + 100);
+    eq.schedule(&far1, 2 * windowTicks + 100);
+    eq.schedule(&far2, 2 * windowTicks + 3 * slotTicks);
+    eq.schedule(&near, 1000);
+
+    eq.serviceOne();
+    eq.serviceOne();
+    EXPECT_EQ(order, std::vector<int>({0, 1}));
+
+    // far2 is now in the window, far3 is still past it
+    eq.schedule(&between, 2 * windowTicks + 2 * slotTicks);
+    eq.schedule(&after, 2 * windowTicks + 5 * slotTicks);
+    eq.schedule(&same, 5 * windowTicks + 100);
+    drain(eq);
+    curEventQueue(nullptr);
+
+    EXPECT_EQ(order, std::vector<int>({0, 1, 4, 2, 6, 5, 3}));
+}
+
+/**
+ * Events of the same tick run in priority order whatever order they
+ * were scheduled in, and only after the events of earlier ticks.
+ */
+TEST(EventQueueTest, CalendarSameTickPriorities)
+{
+    EventQueue eq("eq");
+    eq.useCalendar(true);
+    curEventQueue(&eq);
+
+    std::vector<int> order;
+    const std::vector<Event::Priority> prios = {
+        Event::Default_Pri, Event::Minimum_Pri, Event::Maximum_Pri,
+        Event::CPU_Tick_Pri, Event::Progress_Event_Pri,
+        Event::Sim_Exit_Pri - 1,
+    };
+    std::vector<std::unique_ptr<RecordEvent>> events;
+    for (std::size_t i = 0; i < prios.size(); i++) {
+        events.emplace_back(new RecordEvent(order, i, prios[i]));
+        eq.schedule(events.back().get(), 2 * slotTicks);
+    }
+    // A low priority event of an earlier tick of the same slot
+    RecordEvent earlier(order, 10, Event::Maximum_Pri);
+    eq.schedule(&earlier, 2 * slotTicks - 1);
+
+    drain(eq);
+    curEventQueue(nullptr);
+
+    EXPECT_EQ(order, std::vector<int>({10, 1, 0, 3, 4, 5, 2}));
+}
+
+/**
+ * Descheduling the first, last or only bin of a slot, and rescheduling
+ * events within, into and out of the window, keeps the calendar in step
+ * with the queue.
+ */
+TEST(EventQueueTest, CalendarDescheduleReschedule)
+{
+    EventQueue eq("eq");
+    eq.useCalendar(true);
+    curEventQueue(&eq);
+
+    std::vector<int> order;
+    std::vector<std::unique_ptr<RecordEvent>> events;
+    for (int i = 0; i < 8; i++)
+        events.emplace_back(new RecordEvent(order, i, Event::Default_Pri));
+    auto ev = [&](int i) { return events[i].get(); };
+
+    // Three bins in slot 4, one in slot 5
+    eq.schedule(ev(0), 4 * slotTicks + 10);
+    eq.schedule(ev(1), 4 * slotTicks + 20);
+    eq.schedule(ev(2), 4 * slotTicks + 30);
+    eq.schedule(ev(3), 5 * slotTicks);
+    eq.schedule(ev(4), 4 * slotTicks + 20);
+
+    // First bin of the slot, top of a shared bin, only bin of a slot
+    eq.deschedule(ev(0));
+    eq.deschedule(ev(4));
+    eq.deschedule(ev(3));
+    EXPECT_FALSE(ev(0)->scheduled());
+    EXPECT_TRUE(ev(1)->scheduled());
+
+    // Back into the emptied slots, out of the window and back in
+    eq.schedule(ev(3), 5 * slotTicks + 1);
+    eq.reschedule(ev(2), 3 * windowTicks);
+    eq.reschedule(ev(2), 4 * slotTicks + 5);
+    eq.schedule(ev(5), 4 * slotTicks + 40);
+    eq.reschedule(ev(1), 2 * windowTicks);
+    eq.reschedule(ev(6), 6 * slotTicks, true);
+    eq.schedule(ev(7), 4 * slotTicks + 40);
+    eq.deschedule(ev(5));
+
+    drain(eq);
+    curEventQueue(nullptr);
+
+    EXPECT_EQ(order, std::vector<int>({2, 7, 3, 6, 1}));
+    for (auto &event : events)
+        EXPECT_FALSE(event->scheduled());
+}
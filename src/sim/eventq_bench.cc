@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+/**
+ * A microbenchmark of the event queue with and without a calendar. It
+ * times scheduling and descheduling a number of pending events, and
+ * servicing them in the classic hold model, where each event reschedules
+ * itself when it runs, a bit like the clocked objects of a many-core
+ * system. Both queues do the same work in the same order, only the time
+ * to do so differs. It is not a unit test, so it is not run with them;
+ * build and run it with e.g.:
+ *
+ *   scons build/NULL/sim/eventq_bench.opt && build/NULL/sim/eventq_bench.opt
+ */
+
+namespace
+{
+
+class HoldEvent : public Event
+{
+  public:
+    EventQueue &eq;
+    std::mt19937 &rng;
+    const Tick period;
+    uint64_t &count;
+
+    HoldEvent(EventQueue &_eq, std::mt19937 &_rng, Tick _period,
+              uint64_t &_count)
+        : eq(_eq), rng(_rng), period(_period), count(_count)
+    {}
+
+    void
+    process() override
+    {
+        ++count;
+        // mostly the next cycle, now and then a longer stall
+        const Tick delay = rng() % 16 ? period : period * (1 + rng() % 64);
+        eq.schedule(this, eq.getCurTick() + delay);
+    }
+};
+
+using Clock = std::chrono::steady_clock;
+
+double
+seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/** Operations per second of each part of the benchmark */
+struct Rates
+{
+    double schedule;
+    double deschedule;
+    double service;
+};
+
+/**
+ * Schedule and deschedule the pending events until ops of each have
+ * been done, then service events until ops have run.
+ */
+Rates
+run(bool use_calendar, unsigned pending, uint64_t ops)
+{
+    EventQueue eq("eq");
+    eq.useCalendar(use_calendar);
+    curEventQueue(&eq);
+
+    std::mt19937 rng(1);
+    uint64_t count = 0;
+    std::vector<HoldEvent *> events;
+    std::vector<Tick> when;
+    for (unsigned i = 0; i < pending; i++) {
+        // periods of clocks between 250 MHz and 4 GHz, in ps
+        const Tick period = 250 * (1 + rng() % 16);
+        events.push_back(new HoldEvent(eq, rng, period, count));
+        when.push_back(rng() % (period * 64));
+    }
+
+    // Descheduling in another order than the events were scheduled in
+    // keeps the queue from always removing its head or its tail
+    std::vector<HoldEvent *> shuffled(events);
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    Rates rates;
+    double schedule_secs = 0, deschedule_secs = 0;
+    uint64_t done = 0;
+    while (done < ops) {
+        auto start = Clock::now();
+        for (unsigned i = 0; i < pending; i++)
+            eq.schedule(events[i], when[i]);
+        schedule_secs += seconds(start);
+
+        start = Clock::now();
+        for (auto *event : shuffled)
+            eq.deschedule(event);
+        deschedule_secs += seconds(start);
+
+        done += pending;
+    }
+    rates.schedule = done / schedule_secs;
+    rates.deschedule = done / deschedule_secs;
+
+    for (unsigned i = 0; i < pending; i++)
+        eq.schedule(events[i], when[i]);
+    const auto start = Clock::now();
+    while (count < ops)
+        eq.serviceOne();
+    rates.service = ops / seconds(start);
+
+    for (auto *event : events) {
+        eq.deschedule(event);
+        delete event;
+    }
+    curEventQueue(nullptr);
+
+    return rates;
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    const uint64_t ops = 2000000;
+    for (unsigned pending : {16, 128, 512, 2048}) {
+        const Rates list = run(false, pending, ops);
+        const Rates calendar = run(true, pending, ops);
+        cprintf("%d pending events, M/s list/calendar:\n", pending);
+        cprintf("  schedule   %7.2f %7.2f\n",
+                list.schedule / 1e6, calendar.schedule / 1e6);
+        cprintf("  deschedule %7.2f %7.2f\n",
+                list.deschedule / 1e6, calendar.deschedule / 1e6);
+        cprintf("  service    %7.2f %7.2f\n",
+                list.service / 1e6, calendar.service / 1e6);
+    }
+
+    return 0;
+}
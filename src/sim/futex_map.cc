@@ -28,6 +28,9 @@
 
 #include <sim/futex_map.hh>
 
+#include "sim/process.hh"
+#include "sim/se_workload.hh"
+
 namespace gem5
 {
 
@@ -73,7 +76,7 @@ FutexMap::wakeup(Addr addr, uint64_t tgid, int count)
         // must only count threads that were actually
         // woken up by this syscall.
         auto& tc = waiterList.front().tc;
-        tc->activate();
+        tc->getProcessPtr()->seWorkload->activateContext(tc);
         woken_up++;
         waiterList.pop_front();
         waitingTcs.erase(tc);
@@ -122,7 +125,8 @@ FutexMap::wakeup_bitset(Addr addr, uint64_t tgid, int bitmask)
         WaiterState& waiter = *iter;
 
         if (waiter.checkMask(bitmask)) {
-            waiter.tc->activate();
+            waiter.tc->getProcessPtr()->seWorkload->activateContext(
+                waiter.tc);
             waitingTcs.erase(waiter.tc);
             iter = waiterList.erase(iter);
             woken_up++;
@@ -150,7 +154,8 @@ FutexMap::requeue(Addr addr1, uint64_t tgid, int count, int count2, Addr addr2)
     auto &waiterList1 = it1->second;
 
     while (!waiterList1.empty() && woken_up < count) {
-        waiterList1.front().tc->activate();
+        auto *tc = waiterList1.front().tc;
+        tc->getProcessPtr()->seWorkload->activateContext(tc);
         waiterList1.pop_front();
         woken_up++;
     }
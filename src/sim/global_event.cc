@@ -29,6 +29,8 @@
 
 #include "sim/global_event.hh"
 
+#include <algorithm>
+
 #include "sim/cur_tick.hh"
 
 namespace gem5
@@ -146,6 +148,8 @@ GlobalSyncEvent::BarrierEvent::process()
     // wait for all queues to arrive at barrier, then process event
     if (globalBarrier()) {
         _globalEvent->process();
+        // the events sent from now on are merged at the next barrier
+        asyncEpoch++;
     }
 
     // second barrier to force all queues to wait for event processing
@@ -158,7 +162,19 @@ void
 GlobalSyncEvent::process()
 {
     if (repeat) {
-        schedule(curTick() + repeat);
+        Tick when = curTick() + repeat;
+        if (lookahead) {
+            // every thread waits at the barrier, so the queues hold
+            // still while we look at them
+            Tick next_send = MaxTick;
+            for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+                next_send = std::min(next_send,
+                                     mainEventQueue[i]->nextSendTick());
+            }
+            if (next_send < MaxTick - repeat)
+                when = std::max(when, next_send + repeat);
+        }
+        schedule(when);
     }
 }
 
@@ -30,6 +30,7 @@
 #ifndef __SIM_GLOBAL_EVENT_HH__
 #define __SIM_GLOBAL_EVENT_HH__
 
+#include <chrono>
 #include <mutex>
 #include <vector>
 
@@ -101,7 +102,12 @@ class BaseGlobalEvent : public EventBase
             // while waiting on the barrier to prevent deadlocks if
             // another thread wants to lock the event queue.
             EventQueue::ScopedRelease release(curEventQueue());
-            return _globalEvent->barrier.wait();
+            const auto start = std::chrono::steady_clock::now();
+            const bool last = _globalEvent->barrier.wait();
+            const std::chrono::duration<double> wait =
+                std::chrono::steady_clock::now() - start;
+            curEventQueue()->addBarrierWait(wait.count());
+            return last;
         }
 
       public:
@@ -222,11 +228,11 @@ class GlobalSyncEvent : public BaseGlobalEventTemplate<GlobalSyncEvent>
     };
 
     GlobalSyncEvent(Priority p, Flags f)
-        : Base(p, f), repeat(0)
+        : Base(p, f), repeat(0), lookahead(false)
     { }
 
     GlobalSyncEvent(Tick when, Tick _repeat, Priority p, Flags f)
-        : Base(p, f), repeat(_repeat)
+        : Base(p, f), repeat(_repeat), lookahead(false)
     {
         schedule(when);
     }
@@ -238,6 +244,12 @@ class GlobalSyncEvent : public BaseGlobalEventTemplate<GlobalSyncEvent>
     const char *description() const;
 
     Tick repeat;
+
+    /**
+     * Repeat at least repeat ticks after the earliest event pending on
+     * any queue rather than after this one, see adaptiveQuantum.
+     */
+    bool lookahead;
 };
 
 } // namespace gem5
@@ -404,6 +404,7 @@ Process::replicatePage(Addr vaddr, Addr new_paddr, ThreadContext *old_tc,
 bool
 Process::fixupFault(Addr vaddr)
 {
+    SEWorkload::StateLock lock(seWorkload);
     return memState->fixupFault(vaddr);
 }
 
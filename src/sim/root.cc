@@ -75,6 +75,19 @@ Root::RootStats::RootStats()
              "The number of ticks simulated per host second (ticks/s)"),
     ADD_STAT(hostMemory, statistics::units::Byte::get(),
              "Number of bytes of host memory used"),
+    ADD_STAT(packetAllocs, statistics::units::Count::get(),
+             "Number of packets allocated"),
+    ADD_STAT(packetHeapAllocs, statistics::units::Count::get(),
+             "Number of packet allocations not served by the free list"),
+    ADD_STAT(requestAllocs, statistics::units::Count::get(),
+             "Number of requests allocated"),
+    ADD_STAT(requestHeapAllocs, statistics::units::Count::get(),
+             "Number of request allocations not served by the free list"),
+    ADD_STAT(barrierWait, statistics::units::Second::get(),
+             "Real time each event queue waited for the others at "
+             "synchronization barriers"),
+    ADD_STAT(barriers, statistics::units::Count::get(),
+             "Number of synchronization barriers of each event queue"),
 
     statTime(true),
     startTick(0)
@@ -99,17 +112,72 @@ Root::RootStats::RootStats()
 
     hostTickRate.precision(0);
 
+    packetAllocs.functor([this]() {
+            return PoolAlloc<Packet>::counts().allocs -
+                startPacketCounts.allocs;
+        });
+    packetHeapAllocs.functor([this]() {
+            return PoolAlloc<Packet>::counts().heapAllocs -
+                startPacketCounts.heapAllocs;
+        });
+    requestAllocs.functor([this]() {
+            return PoolAlloc<Request>::counts().allocs -
+                startRequestCounts.allocs;
+        });
+    requestHeapAllocs.functor([this]() {
+            return PoolAlloc<Request>::counts().heapAllocs -
+                startRequestCounts.heapAllocs;
+        });
+
     simSeconds = simTicks / simFreq;
     hostTickRate = simTicks / hostSeconds;
 }
 
+void
+Root::RootStats::regStats()
+{
+    statistics::Group::regStats();
+
+    // every object, and so every event queue, exists by now
+    barrierWait
+        .init(numMainEventQueues)
+        .flags(statistics::nozero)
+        .precision(2)
+        ;
+    barriers
+        .init(numMainEventQueues)
+        .flags(statistics::nozero)
+        ;
+    startBarrierWait.assign(numMainEventQueues, 0);
+    startBarriers.assign(numMainEventQueues, 0);
+}
+
 void
 Root::RootStats::resetStats()
 {
     statTime.setTimer();
     startTick = curTick();
+    startPacketCounts = PoolAlloc<Packet>::counts();
+    startRequestCounts = PoolAlloc<Request>::counts();
 
     statistics::Group::resetStats();
+
+    for (uint32_t i = 0; i < startBarriers.size(); ++i) {
+        startBarrierWait[i] = mainEventQueue[i]->barrierWaitSeconds();
+        startBarriers[i] = mainEventQueue[i]->barrierCount();
+    }
+}
+
+void
+Root::RootStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    for (uint32_t i = 0; i < startBarriers.size(); ++i) {
+        barrierWait[i] =
+            mainEventQueue[i]->barrierWaitSeconds() - startBarrierWait[i];
+        barriers[i] = mainEventQueue[i]->barrierCount() - startBarriers[i];
+    }
 }
 
 /*
@@ -187,6 +255,11 @@ Root::Root(const RootParams &p, int)
     lastTime.setTimer();
 
     simQuantum = p.sim_quantum;
+    adaptiveQuantum = p.adaptive_quantum;
+
+    calendarEventQueues = p.calendar_event_queues;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->useCalendar(calendarEventQueues);
 
     // Some of the statistics are global and need to be accessed by
     // stat formulas. The most convenient way to implement that is by
@@ -51,6 +51,7 @@
 #ifndef __SIM_ROOT_HH__
 #define __SIM_ROOT_HH__
 
+#include "base/pool_alloc.hh"
 #include "base/statistics.hh"
 #include "base/time.hh"
 #include "base/types.hh"
@@ -62,6 +63,9 @@
 namespace gem5
 {
 
+class Packet;
+class Request;
+
 class Root : public SimObject
 {
   private:
@@ -99,7 +103,9 @@ class Root : public SimObject
   public: // Global statistics
     struct RootStats : public statistics::Group
     {
+        void regStats() override;
         void resetStats() override;
+        void preDumpStats() override;
 
         statistics::Formula simSeconds;
         statistics::Value simTicks;
@@ -110,6 +116,14 @@ class Root : public SimObject
         statistics::Formula hostTickRate;
         statistics::Value hostMemory;
 
+        statistics::Value packetAllocs;
+        statistics::Value packetHeapAllocs;
+        statistics::Value requestAllocs;
+        statistics::Value requestHeapAllocs;
+
+        statistics::Vector barrierWait;
+        statistics::Vector barriers;
+
         static RootStats instance;
 
       private:
@@ -120,6 +134,14 @@ class Root : public SimObject
 
         Time statTime;
         Tick startTick;
+
+        /** Pool allocation counts at the last stats reset */
+        PoolAlloc<Packet>::Counts startPacketCounts;
+        PoolAlloc<Request>::Counts startRequestCounts;
+
+        /** Barrier accounting of each event queue at the last reset */
+        std::vector<double> startBarrierWait;
+        std::vector<Counter> startBarriers;
     };
 
   public:
@@ -27,8 +27,10 @@
 
 #include "sim/se_workload.hh"
 
+#include "cpu/base.hh"
 #include "cpu/thread_context.hh"
 #include "params/SEWorkload.hh"
+#include "sim/eventq.hh"
 #include "sim/process.hh"
 #include "sim/system.hh"
 
@@ -71,6 +73,75 @@ SEWorkload::syscall(ThreadContext *tc)
     tc->getProcessPtr()->syscall(tc);
 }
 
+SEWorkload::StateLock::StateLock(SEWorkload *workload)
+    : mutex(workload->stateMutex)
+{
+    if (mutex.try_lock())
+        return;
+
+    EventQueue::ScopedRelease release(curEventQueue());
+    mutex.lock();
+}
+
+SEWorkload::StateLock::~StateLock()
+{
+    mutex.unlock();
+}
+
+void
+SEWorkload::onQueueOf(ThreadContext *tc, const std::string &name,
+                      const std::function<void()> &action)
+{
+    EventQueue *eq = tc->getCpuPtr()->eventQueue();
+    if (!inParallelMode || eq == curEventQueue()) {
+        action();
+        return;
+    }
+
+    auto deferred = [this, action]() {
+        StateLock lock(this);
+        action();
+    };
+    eq->schedule(new EventFunctionWrapper(deferred, name, true),
+                 curTick() + simQuantum);
+}
+
+void
+SEWorkload::activateContext(ThreadContext *tc)
+{
+    activating.insert(tc);
+    auto activate = [this, tc]() {
+        activating.erase(tc);
+        if (!*tc->getProcessPtr()->exitGroup)
+            tc->activate();
+    };
+    onQueueOf(tc, tc->getCpuPtr()->name() + ".activateContext", activate);
+}
+
+void
+SEWorkload::haltContext(ThreadContext *tc,
+                        const std::function<void()> &halted)
+{
+    auto halt = [tc, halted]() {
+        if (tc->status() != ThreadContext::Halted &&
+            tc->status() != ThreadContext::Halting) {
+            tc->halt();
+            halted();
+        }
+    };
+    onQueueOf(tc, tc->getCpuPtr()->name() + ".haltContext", halt);
+}
+
+ThreadContext *
+SEWorkload::findFreeContext()
+{
+    for (auto *tc : system->threads) {
+        if (tc->status() == ThreadContext::Halted && !activating.count(tc))
+            return tc;
+    }
+    return nullptr;
+}
+
 Addr
 SEWorkload::allocPhysPages(int npages, int pool_id)
 {
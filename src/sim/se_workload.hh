@@ -28,6 +28,10 @@
 #ifndef __SIM_SE_WORKLOAD_HH__
 #define __SIM_SE_WORKLOAD_HH__
 
+#include <functional>
+#include <mutex>
+#include <set>
+
 #include "params/SEWorkload.hh"
 #include "sim/mem_pool.hh"
 #include "sim/workload.hh"
@@ -35,13 +39,50 @@
 namespace gem5
 {
 
+class ThreadContext;
+
 class SEWorkload : public Workload
 {
   protected:
     /** Memory allocation objects for all physical memories in the system. */
     MemPools memPools;
 
+    /**
+     * Held by the thread of a core making a syscall or taking a page
+     * fault, see StateLock. Recursive as syscalls take page faults.
+     */
+    std::recursive_mutex stateMutex;
+
+    /** Contexts which a syscall activated from another event queue. */
+    std::set<ThreadContext *> activating;
+
+    /**
+     * Call action right away if tc is on the caller's event queue, or a
+     * quantum later on the queue of tc, under the state lock.
+     */
+    void onQueueOf(ThreadContext *tc, const std::string &name,
+                   const std::function<void()> &action);
+
   public:
+    /**
+     * Hold the state shared by the processes of the workload, e.g. its
+     * memory pools, the page tables, the file descriptors and the futex
+     * map, while making a syscall or taking a page fault. The cores of a
+     * process may run on event queues of their own and keep to them, so
+     * only their syscalls are serialized. A thread waiting for the lock
+     * releases its queue, which the holder may have to migrate to, e.g.
+     * to access memory through a ThreadBridge.
+     */
+    class StateLock
+    {
+      public:
+        StateLock(SEWorkload *workload);
+        ~StateLock();
+
+      private:
+        std::recursive_mutex &mutex;
+    };
+
     using Params = SEWorkloadParams;
 
     SEWorkload(const Params &p, Addr page_shift=0);
@@ -89,6 +130,27 @@ class SEWorkload : public Workload
     // For now, assume the only type of events are system calls.
     void event(ThreadContext *tc) override { syscall(tc); }
 
+    /**
+     * Activate a context, e.g. one a futex wakes. A context on another
+     * event queue than the caller's is activated a quantum later, as any
+     * event sent between queues, so that it wakes at the same tick in
+     * every run. It is not activated if its thread group exited by then.
+     */
+    void activateContext(ThreadContext *tc);
+
+    /**
+     * Halt a context of an exiting thread group, a quantum later if it
+     * is on another event queue than the caller's, then call halted.
+     */
+    void haltContext(ThreadContext *tc,
+                     const std::function<void()> &halted);
+
+    /** Return a halted context that no syscall is activating. */
+    ThreadContext *findFreeContext();
+
+    /** Return the number of contexts being activated. */
+    int numActivating() const { return activating.size(); }
+
     Addr allocPhysPages(int npages, int pool_id=0);
     void deallocPhysPage(Addr paddr, int pool_id=0);
     Addr memSize(int pool_id=0) const;
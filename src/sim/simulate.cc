@@ -230,7 +230,10 @@ simulate(Tick num_cycles)
         quantum_event.reset(
             new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
                                 EventBase::Progress_Event_Pri, 0));
+        quantum_event->lookahead = adaptiveQuantum;
 
+        // every thread merges the events sent before it started
+        asyncEpoch++;
         inParallelMode = true;
     }
 
@@ -31,6 +31,8 @@
 
 #include "base/types.hh"
 #include "sim/eventq.hh"
+#include "sim/process.hh"
+#include "sim/se_workload.hh"
 #include "sim/syscall_debug_macros.hh"
 
 namespace gem5
@@ -43,6 +45,8 @@ SyscallDesc::doSyscall(ThreadContext *tc)
 {
     DPRINTF_SYSCALL(Base, "Calling %s...\n", dumper(name(), tc));
 
+    // the cores of a process may run on event queues of their own
+    SEWorkload::StateLock lock(tc->getProcessPtr()->seWorkload);
     SyscallReturn retval = executor(this, tc);
 
     if (retval.needsRetry()) {
@@ -62,6 +66,7 @@ SyscallDesc::retrySyscall(ThreadContext *tc)
 {
     DPRINTF_SYSCALL(Base, "Retrying %s...\n", dumper(name(), tc));
 
+    SEWorkload::StateLock lock(tc->getProcessPtr()->seWorkload);
     SyscallReturn retval = executor(this, tc);
 
     if (retval.needsRetry()) {
@@ -116,6 +116,35 @@ exitFutexWake(ThreadContext *tc, VPtr<> addr, uint64_t tgid)
     futex_map.wakeup(addr, tgid, 1);
 }
 
+/**
+ * Check to see if there is no more active thread in the system. If so,
+ * exit the simulation loop.
+ */
+static void
+exitIfLastContext(Process *p, int status)
+{
+    // the contexts being activated are halted until they reach their queue
+    int activeContexts = p->seWorkload->numActivating();
+    for (auto &system: p->system->systemList)
+        activeContexts += system->threads.numRunning();
+
+    if (activeContexts == 0) {
+        /**
+         * Even though we are terminating the final thread context, dist-gem5
+         * requires the simulation to remain active and provide
+         * synchronization messages to the switch process. So we just halt
+         * the last thread context and return. The simulation will be
+         * terminated by dist-gem5 in a coordinated manner once all nodes
+         * have signaled their readiness to exit. For non dist-gem5
+         * simulations, readyToExit() always returns true.
+         */
+        if (!DistIface::readyToExit(0))
+            return;
+
+        exitSimLoop("exiting with last active thread context", status & 0xff);
+    }
+}
+
 static SyscallReturn
 exitImpl(SyscallDesc *desc, ThreadContext *tc, bool group, int status)
 {
@@ -169,7 +198,9 @@ exitImpl(SyscallDesc *desc, ThreadContext *tc, bool group, int status)
                  * all threads in the group.
                  */
                 if (*(p->exitGroup)) {
-                    tc->halt();
+                    p->seWorkload->haltContext(tc, [p, status]() {
+                        exitIfLastContext(p, status);
+                    });
                 } else {
                     last_thread = false;
                 }
@@ -213,36 +244,11 @@ exitImpl(SyscallDesc *desc, ThreadContext *tc, bool group, int status)
     if (!p->vforkContexts.empty()) {
         ThreadContext *vtc = sys->threads[p->vforkContexts.front()];
         assert(vtc->status() == ThreadContext::Suspended);
-        vtc->activate();
+        p->seWorkload->activateContext(vtc);
     }
 
     tc->halt();
-
-    /**
-     * check to see if there is no more active thread in the system. If so,
-     * exit the simulation loop
-     */
-    int activeContexts = 0;
-    for (auto &system: sys->systemList)
-        activeContexts += system->threads.numRunning();
-
-    if (activeContexts == 0) {
-        /**
-         * Even though we are terminating the final thread context, dist-gem5
-         * requires the simulation to remain active and provide
-         * synchronization messages to the switch process. So we just halt
-         * the last thread context and return. The simulation will be
-         * terminated by dist-gem5 in a coordinated manner once all nodes
-         * have signaled their readiness to exit. For non dist-gem5
-         * simulations, readyToExit() always returns true.
-         */
-        if (!DistIface::readyToExit(0)) {
-            return status;
-        }
-
-        exitSimLoop("exiting with last active thread context", status & 0xff);
-        return status;
-    }
+    exitIfLastContext(p, status);
 
     return status;
 }
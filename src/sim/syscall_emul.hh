@@ -105,6 +105,7 @@
 #include "sim/guest_abi.hh"
 #include "sim/process.hh"
 #include "sim/proxy_ptr.hh"
+#include "sim/se_workload.hh"
 #include "sim/syscall_debug_macros.hh"
 #include "sim/syscall_desc.hh"
 #include "sim/syscall_emul_buf.hh"
@@ -1765,7 +1766,7 @@ doClone(SyscallDesc *desc, ThreadContext *tc, RegVal flags, RegVal newStack,
         return -EINVAL;
 
     ThreadContext *ctc;
-    if (!(ctc = tc->getSystemPtr()->threads.findFree())) {
+    if (!(ctc = p->seWorkload->findFreeContext())) {
         DPRINTF_SYSCALL(Verbose, "clone: no spare thread context in system"
                         "[cpu %d, thread %d]", tc->cpuId(), tc->threadId());
         return -EAGAIN;
@@ -1854,7 +1855,7 @@ doClone(SyscallDesc *desc, ThreadContext *tc, RegVal flags, RegVal newStack,
 
     desc->returnInto(ctc, 0);
 
-    ctc->activate();
+    p->seWorkload->activateContext(ctc);
 
     if (flags & OS::TGT_CLONE_VFORK) {
         tc->suspend();
@@ -2383,7 +2384,7 @@ execveFunc(SyscallDesc *desc, ThreadContext *tc,
     if (!p->vforkContexts.empty()) {
         ThreadContext *vtc = p->system->threads[p->vforkContexts.front()];
         assert(vtc->status() == ThreadContext::Suspended);
-        vtc->activate();
+        p->seWorkload->activateContext(vtc);
     }
 
     /**
@@ -24,12 +24,29 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+import argparse
+
 import m5
 from m5.objects import *
 
 m5.util.addToPath("../../../configs/")
 from common.Caches import *
 
+parser = argparse.ArgumentParser()
+parser.add_argument(
+    "--snoop-filter-assoc",
+    type=int,
+    default=0,
+    help="Make the snoop filter of the L2 crossbar finite, with sets of "
+    "this many ways, so that it back-invalidates the L1s",
+)
+parser.add_argument(
+    "--snoop-filter-capacity",
+    default="32KiB",
+    help="Capacity of a finite snoop filter",
+)
+args = parser.parse_args()
+
 # MAX CORES IS 8 with the fals sharing method
 nb_cores = 8
 cpus = [MemTest(max_loads=1e5, progress_interval=1e4) for i in range(nb_cores)]
@@ -49,6 +66,12 @@ system.cpu_clk_domain = SrcClockDomain(
 )
 
 system.toL2Bus = L2XBar(clk_domain=system.cpu_clk_domain)
+if args.snoop_filter_assoc:
+    system.toL2Bus.snoop_filter = SnoopFilter(
+        lookup_latency=0,
+        max_capacity=args.snoop_filter_capacity,
+        assoc=args.snoop_filter_assoc,
+    )
 system.l2c = L2Cache(clk_domain=system.cpu_clk_domain, size="64KiB", assoc=8)
 system.l2c.cpu_side = system.toL2Bus.mem_side_ports
 
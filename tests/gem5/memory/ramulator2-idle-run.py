@@ -0,0 +1,166 @@
+"""
+Check that descheduling the Ramulator2 clock while the memory system is
+idle does not change timing. Two identical systems, one with the DRAM
+clock always ticking and one with idle cycle skipping, are driven by the
+same bursty traffic side by side and their statistics are compared.
+With a frontend latency, the skipping system also batches DRAM cycles
+per tick event, which must not change timing either, including when
+the outstanding requests are limited and the traffic waits for retries.
+"""
+
+import argparse
+import sys
+
+import m5
+from m5.objects import *
+from m5.stats.gem5stats import get_simstat
+
+parser = argparse.ArgumentParser(
+    description="Compare Ramulator2 with and without idle cycle skipping"
+)
+parser.add_argument(
+    "--config-path",
+    default="ext/ramulator2/ramulator2/gem5_base_ram.yaml",
+    help="The Ramulator2 configuration to use for both systems",
+)
+parser.add_argument(
+    "--frontend-latency",
+    default="0ns",
+    help="Static frontend latency of both controllers",
+)
+parser.add_argument(
+    "--max-outstanding",
+    type=int,
+    default=None,
+    help="Limit the requests in flight in both controllers",
+)
+parser.add_argument(
+    "--bursts",
+    type=int,
+    default=8,
+    help="Number of traffic bursts separated by idle phases",
+)
+
+args = parser.parse_args()
+
+if "Ramulator2" not in globals():
+    m5.fatal("Ramulator2 is required for the idle skipping test")
+
+MEM_SIZE = "512MiB"
+BURST = 200000
+IDLE = 1000000
+
+# Stats that describe how the DRAM clock was driven rather than what it
+# did, and so are expected to differ between the two systems
+CLOCK_STATS = ("skippedCycles", "idleWakeups", "tickEvents")
+
+
+def build_system(skip_idle_cycles):
+    system = System(
+        membus=IOXBar(width=64),
+        clk_domain=SrcClockDomain(
+            clock="3GHz", voltage_domain=VoltageDomain()
+        ),
+    )
+    system.mem_mode = "timing"
+    system.mem_ranges = [AddrRange(MEM_SIZE)]
+
+    system.tgen = PyTrafficGen()
+    system.mem = Ramulator2(
+        config_path=args.config_path,
+        output_dir=f"ramulator_skip_{skip_idle_cycles}_out",
+        skip_idle_cycles=skip_idle_cycles,
+        tick_batching=skip_idle_cycles,
+        static_frontend_latency=args.frontend_latency,
+    )
+    if args.max_outstanding:
+        system.mem.max_outstanding = args.max_outstanding
+    system.mem.range = system.mem_ranges[0]
+
+    system.tgen.port = system.membus.cpu_side_ports
+    system.system_port = system.membus.cpu_side_ports
+    system.mem.port = system.membus.mem_side_ports
+
+    return system
+
+
+def traffic(tgen):
+    end = AddrRange(MEM_SIZE).size() - 1
+    phases = []
+    for i in range(args.bursts):
+        phases.append(
+            tgen.createLinear(BURST, 0, end, 64, 1000, 1000, 50, 0)
+        )
+        # idle phases of increasing length so the clock goes to sleep
+        # across refresh intervals as well as for a few cycles
+        phases.append(tgen.createIdle(IDLE * (i + 1)))
+        phases.append(
+            tgen.createRandom(BURST, 0, end, 64, 500, 1500, 65, 0)
+        )
+    return phases
+
+
+def flatten(stats):
+    return {
+        key: value
+        for key, value in stats.items()
+        if not key.split(".")[-1] in CLOCK_STATS
+    }
+
+
+root = Root(full_system=False)
+root.ticking = build_system(False)
+root.skipping = build_system(True)
+
+m5.instantiate()
+
+root.ticking.tgen.start(traffic(root.ticking.tgen))
+root.skipping.tgen.start(traffic(root.skipping.tgen))
+
+# stop in the middle of a final idle phase, while the clock of the
+# skipping system is asleep
+duration = sum(2 * BURST + IDLE * (i + 1) for i in range(args.bursts))
+exit_event = m5.simulate(duration + IDLE // 2)
+print(f"Exiting @ tick {m5.curTick()} because {exit_event.getCause()}.")
+
+COMPARED = ("tgen", "membus", "mem")
+
+
+def system_stats(system, prepare_stats):
+    stats = get_simstat(
+        [getattr(system, name) for name in COMPARED],
+        prepare_stats=prepare_stats,
+    ).to_json()
+    return {name: stats[name] for name in COMPARED}
+
+
+ticking = system_stats(root.ticking, True)
+skipping = system_stats(root.skipping, False)
+
+
+def leaves(tree, prefix=""):
+    if isinstance(tree, dict):
+        if "value" in tree and "type" in tree:
+            return {prefix: tree["value"]}
+        result = {}
+        for key, value in tree.items():
+            result.update(leaves(value, f"{prefix}.{key}" if prefix else key))
+        return result
+    return {prefix: tree}
+
+
+ticking = flatten(leaves(ticking))
+skipping = flatten(leaves(skipping))
+
+if ticking.keys() != skipping.keys():
+    print("Stat names differ between the ticking and skipping systems")
+    sys.exit(1)
+
+diffs = [key for key in ticking if ticking[key] != skipping[key]]
+for key in sorted(diffs):
+    print(f"{key}: ticking={ticking[key]} skipping={skipping[key]}")
+
+if diffs:
+    sys.exit(1)
+
+print("Ramulator2 idle cycle skipping matches the always ticking mode")
@@ -70,6 +70,45 @@ gem5_verify_config(
     length=constants.long_tag,
 )
 
+# A finite snoop filter back-invalidates the L1s with cache clean
+# snoops, which also hit their pending writebacks. MemTest fails on any
+# dirty data these lose.
+gem5_verify_config(
+    name="memtest_finite_snoop_filter",
+    verifiers=(),  # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), "memtest-run.py"),
+    config_args=["--snoop-filter-assoc", "2"],
+    valid_isas=(constants.null_tag,),
+    length=constants.long_tag,
+)
+
+gem5_verify_config(
+    name="ramulator2_idle_skip",
+    verifiers=(),  # The config compares both modes and exits non-zero on fail
+    config=joinpath(getcwd(), "ramulator2-idle-run.py"),
+    config_args=[],
+    valid_isas=(constants.null_tag,),
+    length=constants.long_tag,
+)
+
+gem5_verify_config(
+    name="ramulator2_tick_batching",
+    verifiers=(),  # The config compares both modes and exits non-zero on fail
+    config=joinpath(getcwd(), "ramulator2-idle-run.py"),
+    config_args=["--frontend-latency", "6ns"],
+    valid_isas=(constants.null_tag,),
+    length=constants.long_tag,
+)
+
+gem5_verify_config(
+    name="ramulator2_tick_batching_saturated",
+    verifiers=(),  # The config compares both modes and exits non-zero on fail
+    config=joinpath(getcwd(), "ramulator2-idle-run.py"),
+    config_args=["--frontend-latency", "6ns", "--max-outstanding", "4"],
+    valid_isas=(constants.null_tag,),
+    length=constants.long_tag,
+)
+
 null_tests = [
     ("garnet_synth_traffic", None, ["--sim-cycles", "5000000"]),
     ("memcheck", None, ["--maxtick", "2000000000", "--prefetchers"]),
@@ -0,0 +1,128 @@
+"""
+Check that a setting leaves the statistics of a config untouched.
+
+Runs the config once per variant and compares every statistics dump of
+the runs, apart from the host stats. Each run is forked before anything
+is instantiated and writes to a directory of its own in the output
+directory. A variant is a space separated list of SimObject parameter
+defaults to set, e.g. "BaseO3CPU.sleepOnMemoryStall=True", and of extra
+config arguments, starting with a dash. Without variants the config runs
+twice unchanged, which checks that it is deterministic. Exits non-zero
+if a run fails or a stat differs. As variants may hold config arguments,
+pass them as --variant=VARIANT.
+"""
+
+import argparse
+import ast
+import os
+import re
+import runpy
+import sys
+
+import m5
+import m5.objects
+
+from _m5.core import setOutputDir
+
+sys.path.insert(
+    0,
+    os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), *[os.pardir] * 3, "util"
+    ),
+)
+import statslib
+
+parser = argparse.ArgumentParser(
+    description="Compare the stats of a config run with several settings"
+)
+parser.add_argument(
+    "--variant",
+    action="append",
+    default=[],
+    help="Parameter defaults and config arguments of a run",
+)
+parser.add_argument(
+    "--ignore",
+    action="append",
+    default=[],
+    help="Regex of stats expected to differ between the runs",
+)
+parser.add_argument(
+    "--nonzero",
+    default=None,
+    help="Regex of stats of which one must be non-zero in some run, so "
+    "that the setting was exercised",
+)
+parser.add_argument(
+    "--zero",
+    default=None,
+    help="Regex of stats that must be zero in every run",
+)
+parser.add_argument("config", help="The config to run")
+parser.add_argument(
+    "config_args", nargs=argparse.REMAINDER, help="The config arguments"
+)
+
+args = parser.parse_args()
+variants = args.variant or ["", ""]
+outdir = m5.options.outdir
+
+
+def run(index, variant):
+    m5.options.outdir = os.path.join(outdir, f"variant{index}")
+    os.makedirs(m5.options.outdir, exist_ok=True)
+    setOutputDir(m5.options.outdir)
+
+    sys.argv = [args.config] + args.config_args
+    for item in variant.split():
+        if item.startswith("-"):
+            sys.argv.append(item)
+            continue
+        name, value = item.split("=", 1)
+        cls, param = name.rsplit(".", 1)
+        setattr(getattr(m5.objects, cls), param, ast.literal_eval(value))
+
+    # Leaves through the normal exit of gem5, which dumps the stats
+    runpy.run_path(args.config, run_name="__m5_main__")
+    sys.exit(0)
+
+
+dumps = []
+for index, variant in enumerate(variants):
+    pid = os.fork()
+    if pid == 0:
+        run(index, variant)
+    _, status = os.waitpid(pid, 0)
+    if status != 0:
+        m5.fatal(f"Run {index} ({variant}) failed")
+    dumps.append(
+        statslib.read_dumps(
+            os.path.join(outdir, f"variant{index}", "stats.txt")
+        )
+    )
+
+ignored = re.compile("|".join(args.ignore)) if args.ignore else None
+
+failed = False
+for index in range(1, len(variants)):
+    differ = statslib.diff_dumps(dumps[0], dumps[index], ignored)
+    print(f"{len(differ)} stats differ between run 0 and run {index}")
+    statslib.print_diff(differ, "in run 0", f"in run {index}")
+    failed = failed or bool(differ)
+
+if args.nonzero:
+    nonzero = re.compile(args.nonzero)
+    if not any(statslib.total(d, nonzero) for d in dumps):
+        print(f"No run has a non-zero stat matching {args.nonzero}")
+        failed = True
+
+if args.zero:
+    zero = re.compile(args.zero)
+    for index, d in enumerate(dumps):
+        for dump, stats in enumerate(d):
+            for name, value in stats.items():
+                if zero.search(name) and float(value) != 0:
+                    print(f"  dump {dump}, {name}: {value} in run {index}")
+                    failed = True
+
+sys.exit(1 if failed else 0)
@@ -0,0 +1,60 @@
+"""
+Runs a binary on several timing simple CPUs in SE mode, each CPU on an
+event queue of its own, to check that partitioned simulations are
+deterministic. Every CPU runs a process of its own, straight on the
+memory bus, and the memory is a SimpleMemory, as the cores take their
+page faults in host order, which decides the physical pages they get.
+"""
+
+import argparse
+
+import m5
+from m5.objects import *
+
+from gem5.utils.eventq_partition import partition_event_queues
+
+parser = argparse.ArgumentParser()
+parser.add_argument("binary", type=str)
+parser.add_argument("--num-cpus", type=int, default=4)
+parser.add_argument("--crossing-latency", default="2ns")
+
+args = parser.parse_args()
+
+system = System()
+
+system.workload = SEWorkload.init_compatible(args.binary)
+
+system.clk_domain = SrcClockDomain()
+system.clk_domain.clock = "1GHz"
+system.clk_domain.voltage_domain = VoltageDomain()
+
+system.mem_mode = "timing"
+system.mem_ranges = [AddrRange("512MiB")]
+
+system.membus = SystemXBar()
+system.cpu = [X86TimingSimpleCPU(cpu_id=i) for i in range(args.num_cpus)]
+for i, cpu in enumerate(system.cpu):
+    cpu.icache_port = system.membus.cpu_side_ports
+    cpu.dcache_port = system.membus.cpu_side_ports
+    cpu.createInterruptController()
+    cpu.interrupts[0].pio = system.membus.mem_side_ports
+    cpu.interrupts[0].int_requestor = system.membus.cpu_side_ports
+    cpu.interrupts[0].int_responder = system.membus.mem_side_ports
+
+    cpu.workload = Process(pid=100 + i, cmd=[args.binary])
+    cpu.createThreads()
+
+system.mem_ctrl = SimpleMemory(latency="30ns", range=system.mem_ranges[0])
+system.mem_ctrl.port = system.membus.mem_side_ports
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system=False, system=system)
+partition_event_queues(
+    root, [[cpu] for cpu in system.cpu], args.crossing_latency
+)
+
+m5.instantiate()
+exit_event = m5.simulate()
+
+if exit_event.getCause() != "exiting with last active thread context":
+    m5.fatal(f"Simulation exited early: {exit_event.getCause()}")
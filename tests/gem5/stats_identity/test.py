@@ -0,0 +1,101 @@
+"""
+Checks that settings meant to only speed gem5 up leave the statistics
+untouched, and that simulations partitioned over event queues are
+deterministic. Each test runs a config once per setting, or twice, with
+identity-run.py and compares every stats dump of the runs.
+"""
+
+from testlib import *
+
+identity_run = joinpath(getcwd(), "identity-run.py")
+
+gem5_verify_config(
+    name="calendar_event_queues_identity",
+    verifiers=(),  # identity-run.py exits non-zero if a stat differs
+    config=identity_run,
+    config_args=[
+        "--variant=Root.calendar_event_queues=False",
+        "--variant=Root.calendar_event_queues=True",
+        joinpath(config.base_dir, "configs", "example", "memtest.py"),
+        "--maxtick",
+        "2000000000",
+    ],
+    valid_isas=(constants.null_tag,),
+    length=constants.long_tag,
+)
+
+# Sleeping O3 CPUs replay the cycles they skipped, so nothing may change
+bubblesort = DownloadedProgram(
+    config.resource_url + "/test-progs/cpu-tests/bin/x86/Bubblesort",
+    joinpath(config.bin_path, "cpu_tests", "x86"),
+    "Bubblesort",
+)
+gem5_verify_config(
+    name="o3_sleep_on_memory_stall_identity",
+    verifiers=(),
+    config=identity_run,
+    config_args=[
+        "--variant=BaseO3CPU.sleepOnMemoryStall=False",
+        "--variant=BaseO3CPU.sleepOnMemoryStall=True",
+        "--ignore",
+        r"\.memoryStallSleeps$",
+        "--nonzero",
+        r"\.memoryStallSleeps$",
+        joinpath(config.base_dir, "tests", "gem5", "cpu_tests", "run.py"),
+        "--cpu=X86DerivO3CPU",
+        "--mem=DDR3_1600_8x8",
+        bubblesort.filename,
+    ],
+    valid_isas=(constants.all_compiled_tag,),
+    fixtures=[bubblesort],
+    length=constants.long_tag,
+)
+
+# Routers only wake for the flits and credits sent to them, so with one
+# sender and one destination in the first row of a 4x4 XY mesh, only the
+# routers of that row may ever wake, whether idle stages are skipped or not
+gem5_verify_config(
+    name="garnet_activity_tracking_identity",
+    verifiers=(),
+    config=identity_run,
+    config_args=[
+        "--variant=",
+        "--variant=--garnet-no-activity-tracking",
+        "--ignore",
+        r"\.wakeups$|\.idle_stage_skips$",
+        "--nonzero",
+        r"\.routers03\.wakeups$",
+        "--zero",
+        r"\.routers(0[4-9]|1[0-5])\.wakeups$",
+        joinpath(
+            config.base_dir, "configs", "example", "garnet_synth_traffic.py"
+        ),
+        "--network=garnet",
+        "--topology=Mesh_XY",
+        "--num-cpus=16",
+        "--num-dirs=16",
+        "--mesh-rows=4",
+        "--single-sender-id=0",
+        "--single-dest-id=3",
+        "--injectionrate=0.1",
+        "--sim-cycles=100000",
+    ],
+    valid_isas=(constants.null_tag,),
+    length=constants.long_tag,
+)
+
+# Cores on event queues of their own make their syscalls on their own
+# queue, and wake each other a quantum later, so two runs must match
+gem5_verify_config(
+    name="partitioned_se_determinism",
+    verifiers=(),
+    config=identity_run,
+    config_args=[
+        joinpath(getcwd(), "partitioned-se.py"),
+        "--num-cpus=4",
+        bubblesort.filename,
+    ],
+    valid_isas=(constants.all_compiled_tag,),
+    fixtures=[bubblesort],
+    length=constants.long_tag,
+)
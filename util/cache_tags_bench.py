@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+
+# Time the tag lookups of the classic caches
+#
+# Runs the memory tester on a classic cache hierarchy with each of the
+# given gem5 binaries, e.g. one built before and one after a change to
+# the tags, and prints the host time of each run along with the tag
+# accesses it made per host second. The testers mostly hit in their L1s
+# and often miss in the shared levels, so tag lookups are a large part of
+# the host time. When several binaries are given, every stats dump of
+# their runs is compared too, apart from the host stats, as the lookup
+# must not change timing. Needs a gem5 build with the classic caches, e.g.:
+#
+#   cache_tags_bench.py build/NULL/gem5.opt
+#   cache_tags_bench.py old/gem5.opt build/NULL/gem5.opt --caches 2:2:1 \
+#       --testers 1:1:0:2 --maxtick 1000000000
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+import statslib
+
+TAG_ACCESSES = re.compile(r"\.tags\.tagAccesses$")
+
+
+def run(args, gem5, outdir):
+    cmd = [
+        gem5,
+        f"--outdir={outdir}",
+        "configs/example/memtest.py",
+        f"--caches={args.caches}",
+        f"--testers={args.testers}",
+        f"--maxtick={args.maxtick}",
+        f"--functional={args.functional}",
+        f"--uncacheable={args.uncacheable}",
+    ]
+    start = time.monotonic()
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+    secs = time.monotonic() - start
+    return secs, statslib.read_dumps(os.path.join(outdir, "stats.txt"))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Time the tag lookups of the classic caches"
+    )
+    parser.add_argument("gem5", nargs="+", help="The gem5 binaries to run")
+    parser.add_argument("--caches", default="2:2:1")
+    parser.add_argument("--testers", default="1:1:0:2")
+    parser.add_argument("--maxtick", type=int, default=1000000000)
+    parser.add_argument("--functional", type=int, default=0)
+    parser.add_argument("--uncacheable", type=int, default=0)
+    parser.add_argument(
+        "--repeat",
+        type=int,
+        default=3,
+        help="Runs per binary, of which the fastest is reported",
+    )
+    args = parser.parse_args()
+
+    stats = []
+    with tempfile.TemporaryDirectory() as tmp:
+        for i, gem5 in enumerate(args.gem5):
+            secs = None
+            for r in range(args.repeat):
+                outdir = os.path.join(tmp, f"{i}_{r}")
+                run_secs, stats_i = run(args, gem5, outdir)
+                secs = run_secs if secs is None else min(secs, run_secs)
+            accesses = statslib.total(stats_i, TAG_ACCESSES)
+            print(
+                f"{gem5}: {secs:.2f} s, {accesses:.0f} tag accesses, "
+                f"{accesses / secs / 1e6:.2f} M/s"
+            )
+            stats.append(stats_i)
+
+    failed = False
+    for i in range(1, len(stats)):
+        differ = statslib.diff_dumps(stats[0], stats[i])
+        statslib.print_diff(
+            differ, f"with {args.gem5[0]}", f"with {args.gem5[i]}"
+        )
+        failed = failed or bool(differ)
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
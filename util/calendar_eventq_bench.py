@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+
+# Time event queues with and without a calendar
+#
+# Runs a gem5 config twice, once with the event queues walked as a list
+# and once indexed with a calendar (Root.calendar_event_queues), and
+# prints the host time of each. The calendar pays off once hundreds of
+# events are pending, e.g. with many cores or routers. As the calendar
+# must not change the order events run in, every stats dump of both runs
+# is compared too, apart from the host stats. Any config works, as the
+# default of the Root parameter is set before it runs, e.g.:
+#
+#   calendar_eventq_bench.py build/Garnet_standalone/gem5.opt \
+#       configs/example/garnet_synth_traffic.py --network=garnet \
+#       --topology=Mesh_XY --num-cpus=256 --num-dirs=256 --mesh-rows=16 \
+#       --injectionrate=0.02 --sim-cycles=100000
+#
+# src/sim/eventq_bench.cc times the queue operations on their own.
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+import statslib
+
+# Runs the config with the default of the calendar parameter changed
+WRAPPER = """\
+import runpy
+import sys
+
+from m5.objects import Root
+
+Root.calendar_event_queues = {calendar}
+sys.argv = {argv}
+runpy.run_path(sys.argv[0], run_name="__m5_main__")
+"""
+
+
+def run(args, calendar, tmp):
+    outdir = os.path.join(tmp, f"calendar_{calendar}")
+    wrapper = os.path.join(tmp, f"calendar_{calendar}.py")
+    with open(wrapper, "w") as f:
+        f.write(
+            WRAPPER.format(
+                calendar=calendar,
+                argv=[os.path.abspath(args.config)] + args.config_args,
+            )
+        )
+    cmd = [args.gem5, f"--outdir={outdir}", wrapper]
+    start = time.monotonic()
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+    secs = time.monotonic() - start
+    return secs, statslib.read_dumps(os.path.join(outdir, "stats.txt"))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Time event queues with and without a calendar"
+    )
+    parser.add_argument("gem5", help="The gem5 binary to run")
+    parser.add_argument("config", help="The config to run")
+    parser.add_argument(
+        "config_args",
+        nargs=argparse.REMAINDER,
+        help="The arguments of the config",
+    )
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        times = {}
+        stats = {}
+        for calendar in (False, True):
+            times[calendar], stats[calendar] = run(args, calendar, tmp)
+
+    differ = statslib.diff_dumps(stats[False], stats[True])
+    print(
+        f"{times[False]:.2f} s as a list, {times[True]:.2f} s with a "
+        f"calendar, speedup {times[False] / times[True]:.2f}"
+    )
+    statslib.print_diff(differ, "as a list", "with a calendar")
+
+    sys.exit(1 if differ else 0)
+
+
+if __name__ == "__main__":
+    main()
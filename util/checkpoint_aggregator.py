@@ -29,7 +29,9 @@
 import gzip
 import os
 import re
+import struct
 import sys
+import zlib
 from configparser import ConfigParser
 
 
@@ -41,6 +43,55 @@ class myCP(ConfigParser):
         return optionstr
 
 
+class ChunkedImage:
+    """Reads a chunked memory image, see src/mem/physical.cc"""
+
+    magic = b"gem5pmc1"
+    raw_magic = b"gem5pmr1"
+    raw_align = 1 << 16
+
+    def __init__(self, f, raw):
+        f.seek(len(self.magic))
+        self.chunk_size, num_chunks, index_offset = struct.unpack(
+            "<3Q", f.read(24)
+        )
+        f.seek(index_offset)
+        self.sizes = struct.unpack(f"<{num_chunks}Q", f.read(8 * num_chunks))
+        self.offset = len(self.magic) + 24
+        self.f = f
+        self.raw = raw
+        self.next_chunk = 0
+        self.buf = b""
+
+    def read(self, size):
+        while len(self.buf) < size and self.next_chunk < len(self.sizes):
+            chunk = self.sizes[self.next_chunk]
+            self.next_chunk += 1
+            if chunk == 0:
+                self.buf += bytes(self.chunk_size)
+                continue
+            if self.raw:
+                align = self.raw_align
+                self.offset = (self.offset + align - 1) // align * align
+            self.f.seek(self.offset)
+            data = self.f.read(chunk)
+            self.offset += chunk
+            self.buf += data if self.raw else zlib.decompress(data)
+        data, self.buf = self.buf[:size], self.buf[size:]
+        return data
+
+    def close(self):
+        pass
+
+
+def open_memory_image(f):
+    magic = f.read(len(ChunkedImage.magic))
+    if magic in (ChunkedImage.magic, ChunkedImage.raw_magic):
+        return ChunkedImage(f, magic == ChunkedImage.raw_magic)
+    f.seek(0)
+    return gzip.GzipFile(fileobj=f, mode="rb")
+
+
 def aggregate(output_dir, cpts, no_compress, memory_size):
     merged_config = None
     page_ptr = 0
@@ -102,7 +153,7 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
         print("pages to be read: ", pages)
 
         f = open(cpts[i] + "/system.physmem.store0.pmem", "rb")
-        gf = gzip.GzipFile(fileobj=f, mode="rb")
+        gf = open_memory_image(f)
 
         x = 0
         while x < pages:
@@ -138,6 +189,8 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
     merged_config.set(
         "system.physmem.store0", "range_size", page_ptr * 4 * 1024
     )
+    # the merged image is a single stream rather than chunked
+    merged_config.remove_option("system.physmem.store0", "chunk_size")
 
     merged_config.add_section("Globals")
     merged_config.set("Globals", "curTick", max_curtick)
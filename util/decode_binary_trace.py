@@ -0,0 +1,461 @@
+#!/usr/bin/env python3
+
+# Decode the binary debug traces written with --debug-binary into the
+# text the debug flags print otherwise, see trace::BinaryLogger.
+#
+#   decode_binary_trace.py m5out/trace.bin
+#   decode_binary_trace.py m5out/trace.bin --flags DRAM,Cache --start 1000
+#
+# The messages are formatted the way cprintf does. The messages of every
+# thread are in order, --sort merges the threads by tick.
+
+import argparse
+import heapq
+import mmap
+import struct
+import sys
+
+MAGIC = b"gem5dbt1"
+MAX_TICK = 2**64 - 1
+
+DEFINE_STRING = 1
+MESSAGE = 2
+
+SIGNED, UNSIGNED, FLOAT, STRING, CHAR, BOOL, POINTER = range(1, 8)
+
+CHUNK = struct.Struct("<IIQ")
+DEFINE = struct.Struct("<BBHII")
+HEADER = struct.Struct("<BBHIIIQ")
+INTS = {
+    (SIGNED, 1): "b",
+    (SIGNED, 2): "h",
+    (SIGNED, 4): "i",
+    (SIGNED, 8): "q",
+    (UNSIGNED, 1): "B",
+    (UNSIGNED, 2): "H",
+    (UNSIGNED, 4): "I",
+    (UNSIGNED, 8): "Q",
+}
+
+
+class Message:
+    __slots__ = ("thread", "tick", "fmt", "name", "flag", "args")
+
+    def __init__(self, thread, tick, fmt, name, flag, args):
+        self.thread = thread
+        self.tick = tick
+        self.fmt = fmt
+        self.name = name
+        self.flag = flag
+        self.args = args
+
+
+def read_messages(path):
+    """Yield the messages of a binary trace, in file order"""
+    with open(path, "rb") as f:
+        data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+    if data[: len(MAGIC)] != MAGIC:
+        raise ValueError(f"{path} is not a binary trace")
+
+    strings = {}
+    pos = len(MAGIC)
+    while pos + CHUNK.size <= len(data):
+        thread, _, size = CHUNK.unpack_from(data, pos)
+        pos += CHUNK.size
+        end = pos + size
+        if end > len(data):
+            print("Truncated trace", file=sys.stderr)
+            return
+
+        while pos < end:
+            kind = data[pos]
+            if kind == DEFINE_STRING:
+                _, _, _, id, length = DEFINE.unpack_from(data, pos)
+                pos += DEFINE.size
+                strings[id] = data[pos : pos + length].decode(
+                    errors="replace"
+                )
+                pos += length
+            elif kind == MESSAGE:
+                _, nargs, _, fmt, name, flag, tick = HEADER.unpack_from(
+                    data, pos
+                )
+                pos += HEADER.size
+                args = []
+                for _ in range(nargs):
+                    arg, pos = _read_arg(data, pos)
+                    args.append(arg)
+                yield Message(
+                    thread,
+                    tick,
+                    strings[fmt],
+                    strings[name],
+                    strings[flag],
+                    args,
+                )
+            else:
+                raise ValueError(f"Unknown record type {kind} at {pos}")
+
+
+def _read_arg(data, pos):
+    # an argument is its (type, size, value)
+    type = data[pos]
+    kind, size = type >> 4, type & 0xF
+    pos += 1
+    if kind == STRING:
+        (length,) = struct.unpack_from("<I", data, pos)
+        pos += 4
+        value = data[pos : pos + length].decode(errors="replace")
+        return (kind, length, value), pos + length
+    if kind in (SIGNED, UNSIGNED):
+        (value,) = struct.unpack_from("<" + INTS[kind, size], data, pos)
+    elif kind == FLOAT:
+        (value,) = struct.unpack_from("<d", data, pos)
+    elif kind == CHAR:
+        value = chr(data[pos])
+    elif kind == BOOL:
+        value = bool(data[pos])
+    elif kind == POINTER:
+        (value,) = struct.unpack_from("<Q", data, pos)
+    else:
+        raise ValueError(f"Unknown argument type {type:#x} at {pos - 1}")
+    return (kind, size, value), pos + size
+
+
+class Spec:
+    """A conversion of a format, parsed like cp::Print::processFlag"""
+
+    def __init__(self):
+        self.alternate = False
+        self.left = False
+        self.sign = False
+        self.zero = False
+        self.upper = False
+        self.base = 10
+        self.format = None
+        self.float_format = "g"
+        self.precision = -1
+        self.width = 0
+        self.get_width = False
+        self.get_precision = False
+
+
+def parse_format(fmt):
+    """Split a format into literal text and Specs"""
+    parts = []
+    text = []
+    i = 0
+    while i < len(fmt):
+        c = fmt[i]
+        if c != "%":
+            if c == "\r":
+                if fmt[i + 1 : i + 2] != "\n":
+                    text.append("\n")
+            else:
+                text.append(c)
+            i += 1
+            continue
+        if fmt[i + 1 : i + 2] == "%":
+            text.append("%")
+            i += 2
+            continue
+
+        if text:
+            parts.append("".join(text))
+            text = []
+        spec, i = _parse_spec(fmt, i)
+        parts.append(spec)
+
+    if text:
+        parts.append("".join(text))
+    return parts
+
+
+def _parse_spec(fmt, i):
+    spec = Spec()
+    number = 0
+    have_precision = False
+    end_number = False
+    done = False
+    while not done:
+        i += 1
+        c = fmt[i] if i < len(fmt) else ""
+        if c.isdigit():
+            if end_number:
+                continue
+        elif number > 0:
+            end_number = True
+
+        if c == "s":
+            spec.format = "s"
+            done = True
+        elif c == "c":
+            spec.format = "c"
+            done = True
+        elif c == "l":
+            continue
+        elif c in ("p", "x", "X"):
+            spec.format = "i"
+            spec.base = 16
+            spec.alternate |= c == "p"
+            spec.upper = c == "X"
+            done = True
+        elif c == "o":
+            spec.format = "i"
+            spec.base = 8
+            done = True
+        elif c in ("d", "i", "u"):
+            spec.format = "i"
+            done = True
+        elif c in ("g", "G", "e", "E", "f"):
+            spec.format = "f"
+            spec.float_format = c.lower()
+            spec.upper = c.isupper()
+            done = True
+        elif c == "#":
+            spec.alternate = True
+        elif c == "-":
+            spec.left = True
+        elif c == "+":
+            spec.sign = True
+        elif c == " ":
+            pass
+        elif c == ".":
+            spec.width = number
+            spec.precision = 0
+            have_precision = True
+            number = 0
+            end_number = False
+        elif c == "0" and number == 0:
+            spec.zero = True
+        elif c.isdigit():
+            number = number * 10 + int(c)
+        elif c == "*":
+            if have_precision:
+                spec.get_precision = True
+            else:
+                spec.get_width = True
+        else:
+            done = True
+
+        if end_number:
+            if have_precision:
+                spec.precision = number
+            else:
+                spec.width = number
+            end_number = False
+            number = 0
+
+    if spec.format == "i" and have_precision:
+        spec.width = spec.precision
+        spec.zero = True
+    elif spec.format == "f" and not have_precision and spec.zero:
+        spec.precision = spec.width
+    return spec, i + 1
+
+
+def _pad(text, spec, fill=" "):
+    if len(text) >= spec.width:
+        return text
+    if spec.left and fill == " ":
+        return text.ljust(spec.width)
+    return text.rjust(spec.width, fill)
+
+
+def _text(kind, size, value):
+    # what "out << value" prints
+    if kind in (SIGNED, UNSIGNED):
+        return chr(value & 0xFF) if size == 1 else str(value)
+    if kind == FLOAT:
+        return f"{value:g}"
+    if kind == BOOL:
+        return "1" if value else "0"
+    if kind == POINTER:
+        return hex(value) if value else "0"
+    return value
+
+
+def _format_int(spec, kind, size, value):
+    if kind not in (SIGNED, UNSIGNED, BOOL, CHAR):
+        return _pad(_text(kind, size, value), spec)
+    if kind == CHAR:
+        value = ord(value)
+    value = int(value)
+    if spec.base != 10 and value < 0:
+        value &= (1 << (8 * (size if size > 1 else 4))) - 1
+
+    digits = {10: "d", 16: "x", 8: "o"}[spec.base]
+    digits = format(abs(value), digits)
+    if spec.upper:
+        digits = digits.upper()
+    sign = "-" if value < 0 else "+" if spec.sign else ""
+
+    width = spec.width
+    prefix = ""
+    if spec.alternate and value != 0:
+        prefix = {10: "", 16: "0X" if spec.upper else "0x", 8: "0"}[
+            spec.base
+        ]
+    if spec.alternate and spec.zero:
+        # cprintf prints the prefix ahead of the padding
+        prefix = {10: "", 16: "0x", 8: "0"}[spec.base]
+        width -= len(prefix)
+        return prefix + (sign + digits).rjust(width, "0")
+
+    text = sign + prefix + digits
+    if len(text) >= width:
+        return text
+    if spec.zero:
+        return text.rjust(width, "0")
+    return text.ljust(width) if spec.left else text.rjust(width)
+
+
+def _format_float(spec, kind, size, value):
+    if kind != FLOAT:
+        return "<bad arg type for float format>"
+
+    precision = spec.precision
+    if spec.float_format == "e" and precision != -1:
+        text = (
+            f"{value:.1g}" if precision == 0 else f"{value:.{precision}e}"
+        )
+    elif spec.float_format == "f" and precision != -1:
+        text = f"{value:.{precision}f}"
+    elif spec.float_format == "g" and precision != -1:
+        text = f"{value:.{precision}g}"
+    else:
+        text = f"{value:g}"
+    if spec.upper:
+        text = text.upper()
+    return _pad(text, spec, "0" if spec.zero else " ")
+
+
+def _format_char(spec, kind, size, value):
+    if kind == CHAR:
+        return value
+    if kind in (SIGNED, UNSIGNED):
+        return chr(value & 0xFF)
+    return "<bad arg type for char format>"
+
+
+FORMATTERS = {
+    "i": _format_int,
+    "f": _format_float,
+    "c": _format_char,
+    "s": lambda spec, *arg: _pad(_text(*arg), spec),
+}
+
+
+def render(parts, args):
+    """The text of a message, from its parsed format and arguments"""
+    out = []
+    args = iter(args)
+    for part in parts:
+        if isinstance(part, str):
+            out.append(part)
+            continue
+
+        spec = part
+        if spec.get_width or spec.get_precision:
+            spec = Spec()
+            spec.__dict__.update(part.__dict__)
+            if spec.get_width:
+                spec.width = next(args, (0, 0, 0))[2]
+            if spec.get_precision:
+                spec.precision = next(args, (0, 0, 0))[2]
+
+        arg = next(args, None)
+        if arg is None:
+            out.append("<missing arg for format>")
+        elif spec.format is None:
+            out.append("<bad format>")
+        else:
+            out.append(FORMATTERS[spec.format](spec, *arg))
+
+    if next(args, None) is not None:
+        out.append("<extra arg>")
+    return "".join(out)
+
+
+def _merge_by_tick(messages):
+    # the messages of each thread, keyed by the tick of the last message
+    # with one, as DPRINTFR and the like have none
+    threads = {}
+    for msg in messages:
+        thread = threads.setdefault(msg.thread, [0, []])
+        if msg.tick != MAX_TICK:
+            thread[0] = msg.tick
+        thread[1].append((thread[0], msg))
+    return (
+        msg
+        for _, msg in heapq.merge(
+            *(t[1] for t in threads.values()), key=lambda m: m[0]
+        )
+    )
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode a binary gem5 debug trace"
+    )
+    parser.add_argument("file", help="Binary trace written by --debug-binary")
+    parser.add_argument(
+        "--flags", help="Only print the messages of these flags, comma "
+        "separated"
+    )
+    parser.add_argument(
+        "--start", type=int, default=0, help="Skip the messages before"
+    )
+    parser.add_argument(
+        "--end", type=int, default=MAX_TICK, help="Skip the messages after"
+    )
+    parser.add_argument(
+        "--sort", action="store_true", help="Merge the threads by tick"
+    )
+    parser.add_argument(
+        "--show-flag",
+        action="store_true",
+        help="Print the flag of every message, like FmtFlag",
+    )
+    parser.add_argument(
+        "--no-ticks",
+        action="store_true",
+        help="Don't print the ticks, like FmtTicksOff",
+    )
+    args = parser.parse_args()
+
+    flags = set(args.flags.split(",")) if args.flags else None
+    formats = {}
+
+    messages = read_messages(args.file)
+    if args.sort:
+        messages = _merge_by_tick(messages)
+
+    out = sys.stdout
+    try:
+        for msg in messages:
+            if flags is not None and msg.flag not in flags:
+                continue
+            if msg.tick != MAX_TICK and not (
+                args.start <= msg.tick <= args.end
+            ):
+                continue
+
+            parts = formats.get(msg.fmt)
+            if parts is None:
+                parts = formats[msg.fmt] = parse_format(msg.fmt)
+
+            if msg.tick != MAX_TICK and not args.no_ticks:
+                out.write(f"{msg.tick:7d}: ")
+            if args.show_flag and msg.flag:
+                out.write(f"{msg.flag}: ")
+            if msg.name:
+                out.write(f"{msg.name}: ")
+            out.write(render(parts, msg.args))
+    except BrokenPipeError:
+        pass
+
+
+if __name__ == "__main__":
+    main()
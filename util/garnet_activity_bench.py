@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+
+# Time Garnet with and without activity tracking
+#
+# Runs the synthetic traffic example on meshes at a low injection rate,
+# once with every stage of a woken router evaluated and once with only
+# the stages that have flits to move, and prints the host time of each.
+# As tracking must not change timing, every stats dump of both runs is
+# compared too, apart from the host stats and the router stats counting
+# how the routers were evaluated. Needs a gem5 build with Garnet and
+# Garnet_standalone, e.g.:
+#
+#   garnet_activity_bench.py build/Garnet_standalone/gem5.opt
+#   garnet_activity_bench.py build/Garnet_standalone/gem5.opt \
+#       --mesh-rows 8 --injectionrate 0.01
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+import statslib
+
+# Stats that describe how the routers were evaluated rather than what
+# they did, and so are expected to differ between the two runs
+IGNORED = statslib.ignoring(r"\.wakeups$", r"\.idle_stage_skips$")
+
+
+def run(args, rows, tracking, outdir):
+    cmd = [
+        args.gem5,
+        f"--outdir={outdir}",
+        "configs/example/garnet_synth_traffic.py",
+        "--network=garnet",
+        "--topology=Mesh_XY",
+        f"--num-cpus={rows * rows}",
+        f"--num-dirs={rows * rows}",
+        f"--mesh-rows={rows}",
+        f"--synthetic={args.synthetic}",
+        f"--injectionrate={args.injectionrate}",
+        f"--sim-cycles={args.sim_cycles}",
+    ]
+    if not tracking:
+        cmd.append("--garnet-no-activity-tracking")
+    start = time.monotonic()
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+    secs = time.monotonic() - start
+    return secs, statslib.read_dumps(
+        os.path.join(outdir, "stats.txt"), IGNORED
+    )
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Time Garnet with and without activity tracking"
+    )
+    parser.add_argument("gem5", help="The gem5 binary to run")
+    parser.add_argument(
+        "--mesh-rows",
+        type=int,
+        nargs="+",
+        default=[8, 16],
+        help="The sizes of the square meshes to run",
+    )
+    parser.add_argument("--injectionrate", type=float, default=0.02)
+    parser.add_argument("--synthetic", default="uniform_random")
+    parser.add_argument("--sim-cycles", type=int, default=100000)
+    args = parser.parse_args()
+
+    failed = False
+    with tempfile.TemporaryDirectory() as tmp:
+        for rows in args.mesh_rows:
+            times = {}
+            stats = {}
+            for tracking in (False, True):
+                outdir = os.path.join(tmp, f"{rows}_{tracking}")
+                times[tracking], stats[tracking] = run(
+                    args, rows, tracking, outdir
+                )
+            differ = statslib.diff_dumps(stats[False], stats[True])
+            print(
+                f"{rows}x{rows} mesh: {times[False]:.2f} s untracked, "
+                f"{times[True]:.2f} s tracked, "
+                f"speedup {times[False] / times[True]:.2f}"
+            )
+            statslib.print_diff(differ, "untracked", "tracked")
+            failed = failed or bool(differ)
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
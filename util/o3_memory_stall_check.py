@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+
+# Check that sleeping on memory stalls does not change the O3 stats
+#
+# Runs a gem5 config twice, once with the O3 CPUs ticking through their
+# memory stalls and once descheduling their tick until the response
+# arrives (BaseO3CPU.sleepOnMemoryStall), and compares the statistics of
+# every dump of both runs, apart from the host stats. The skipped cycles
+# are replayed through skipStalledCycles() once the CPU wakes, so every
+# stat must match but memoryStallSleeps, which counts the times a CPU
+# went to sleep, as a run that never sleeps checks nothing. Any config
+# works, as the default of the O3 parameter is set before it runs, e.g.:
+#
+#   o3_memory_stall_check.py build/X86/gem5.opt tests/gem5/cpu_tests/run.py \
+#       --cpu=X86DerivO3CPU --mem=DDR3_1600_8x8 path/to/Bubblesort
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+import statslib
+
+# Counts the times an O3 CPU descheduled its tick
+SLEEPS = re.compile(r"\.memoryStallSleeps$")
+
+# Runs the config with the default of the O3 parameter changed
+WRAPPER = """\
+import runpy
+import sys
+
+from m5.objects import BaseO3CPU
+
+BaseO3CPU.sleepOnMemoryStall = {sleep}
+sys.argv = {argv}
+runpy.run_path(sys.argv[0], run_name="__m5_main__")
+"""
+
+
+def run(args, sleep, tmp):
+    outdir = os.path.join(tmp, f"sleep_{sleep}")
+    wrapper = os.path.join(tmp, f"sleep_{sleep}.py")
+    with open(wrapper, "w") as f:
+        f.write(
+            WRAPPER.format(
+                sleep=sleep,
+                argv=[os.path.abspath(args.config)] + args.config_args,
+            )
+        )
+    cmd = [args.gem5, f"--outdir={outdir}", wrapper]
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+    return statslib.read_dumps(os.path.join(outdir, "stats.txt"))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Check that sleeping on memory stalls does not change "
+        "the O3 stats"
+    )
+    parser.add_argument("gem5", help="The gem5 binary to run")
+    parser.add_argument("config", help="The config to run")
+    parser.add_argument(
+        "config_args",
+        nargs=argparse.REMAINDER,
+        help="The arguments of the config",
+    )
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        stats = {}
+        for sleep in (False, True):
+            stats[sleep] = run(args, sleep, tmp)
+
+    sleeps = statslib.total(stats[True], SLEEPS)
+    differ = statslib.diff_dumps(stats[False], stats[True], SLEEPS)
+    print(f"{sleeps:.0f} sleeps, {len(differ)} stats differ")
+    statslib.print_diff(differ, "ticking", "sleeping")
+    if not sleeps:
+        print("  The O3 CPUs never slept, pick a config with slower memory")
+
+    sys.exit(1 if differ or not sleeps else 0)
+
+
+if __name__ == "__main__":
+    main()
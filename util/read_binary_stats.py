@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+
+# Read the binary stat files written with --stats-file=bin://stats.bin
+#
+# The file is memory mapped and the frames of every schema are exposed
+# as one numpy array, with a row per dump and a column per stat value,
+# without copying them. Used as a module:
+#
+#   from read_binary_stats import BinaryStats
+#   stats = BinaryStats("m5out/stats.bin")
+#   ipc = stats["system.cpu0.ipc"]
+#   misses = stats.match(r"system\.dcaches\d+\.overallMisses::.*")
+#
+# or from the command line, to list the stats or print some of them as
+# CSV:
+#
+#   read_binary_stats.py m5out/stats.bin --list
+#   read_binary_stats.py m5out/stats.bin simTicks "system.cpu0.ipc"
+#
+# Vectors only have a column per element, not the ::total of stats.txt,
+# so sum the elements instead.
+
+import argparse
+import json
+import mmap
+import re
+import struct
+import sys
+
+try:
+    import numpy as np
+except ImportError:
+    print("Reading binary stats needs numpy", file=sys.stderr)
+    sys.exit(1)
+
+MAGIC = b"gem5bst1"
+SCHEMA = 1
+FRAME = 2
+RECORD_HEADER = struct.Struct("<IIQ")
+
+
+class Segment:
+    """The frames written with one schema"""
+
+    def __init__(self, schema, frames):
+        self.schema = schema
+        self.stats = schema["stats"]
+        self.columns = schema["columns"]
+        self.index = {name: i for i, name in enumerate(self.columns)}
+        self.ticks = frames["tick"]
+        # one row per dump, one column per value
+        self.values = frames["values"]
+
+    def __len__(self):
+        return len(self.ticks)
+
+
+class BinaryStats:
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+        if self._map[: len(MAGIC)] != MAGIC:
+            raise ValueError(f"{path} is not a binary stat file")
+
+        self.segments = []
+        pos = len(MAGIC)
+        schema = None
+        while pos + RECORD_HEADER.size <= len(self._map):
+            kind, _, size = RECORD_HEADER.unpack_from(self._map, pos)
+            payload = pos + RECORD_HEADER.size
+            if payload + size > len(self._map):
+                # a dump still being written
+                break
+
+            if kind == SCHEMA:
+                schema = json.loads(self._map[payload : payload + size])
+                pos = payload + size
+            elif kind == FRAME:
+                pos = self._read_frames(schema, pos)
+            else:
+                raise ValueError(f"Unknown record type {kind} at {pos}")
+
+    def _read_frames(self, schema, pos):
+        # the frames of a schema follow each other and are all the same
+        # size, so they map to one structured array
+        n = len(schema["columns"])
+        frame = np.dtype(
+            [
+                ("kind", "<u4"),
+                ("zero", "<u4"),
+                ("size", "<u8"),
+                ("tick", "<u8"),
+                ("values", "<f8", (n,)),
+            ]
+        )
+        count = 0
+        end = pos
+        while end + frame.itemsize <= len(self._map):
+            kind, _, size = RECORD_HEADER.unpack_from(self._map, end)
+            if kind != FRAME or size != frame.itemsize - RECORD_HEADER.size:
+                break
+            count += 1
+            end += frame.itemsize
+
+        if count == 0:
+            raise ValueError(f"Frame at {pos} does not match its schema")
+
+        frames = np.frombuffer(self._map, frame, count, pos)
+        self.segments.append(Segment(schema, frames))
+        return end
+
+    @property
+    def columns(self):
+        """Names of all values, of every schema"""
+        seen = {}
+        for segment in self.segments:
+            seen.update(dict.fromkeys(segment.columns))
+        return list(seen)
+
+    @property
+    def ticks(self):
+        """Tick of every dump"""
+        return np.concatenate([s.ticks for s in self.segments])
+
+    def __len__(self):
+        return sum(len(s) for s in self.segments)
+
+    def __getitem__(self, name):
+        """Values of one column over all dumps, NaN where it is missing"""
+        parts = []
+        for segment in self.segments:
+            i = segment.index.get(name)
+            if i is None:
+                parts.append(np.full(len(segment), np.nan))
+            else:
+                parts.append(segment.values[:, i])
+        if not any(name in s.index for s in self.segments):
+            raise KeyError(name)
+        return np.concatenate(parts)
+
+    def match(self, pattern):
+        """Values of all columns whose name matches a regex, by name"""
+        regex = re.compile(pattern)
+        return {
+            name: self[name]
+            for name in self.columns
+            if regex.fullmatch(name)
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Read a binary gem5 stat file"
+    )
+    parser.add_argument("file", help="Binary stat file")
+    parser.add_argument(
+        "columns",
+        nargs="*",
+        help="Columns to print as CSV, regular expressions",
+    )
+    parser.add_argument(
+        "--list", action="store_true", help="List the stats of the file"
+    )
+    args = parser.parse_args()
+
+    stats = BinaryStats(args.file)
+
+    if args.list or not args.columns:
+        for segment in stats.segments:
+            print(f"# {len(segment)} dumps")
+            for stat in segment.stats:
+                print(f"{stat['name']} ({stat['type']}, {stat['unit']})")
+        return
+
+    selected = {}
+    for pattern in args.columns:
+        selected.update(stats.match(pattern))
+
+    print(",".join(["tick"] + list(selected)))
+    for row, tick in enumerate(stats.ticks):
+        print(
+            ",".join(
+                [str(tick)] + [repr(float(v[row])) for v in selected.values()]
+            )
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+
+# Time the protocol transitions of Ruby
+#
+# Runs the Ruby memory tester with each of the given gem5 binaries and
+# prints the host time of each run along with the protocol transitions it
+# made per host second. Every transition looks its line up in the
+# CacheMemory of its controller, usually several times, so this tracks
+# the cost of the tag lookups under a real protocol. Each binary is built
+# for one protocol, e.g. MESI_Two_Level or CHI. With --compare, the
+# binaries must share a protocol, e.g. one built before and one after a
+# change, and every stats dump of their runs is compared too, apart from
+# the host stats, as the lookup must not change timing:
+#
+#   ruby_cache_memory_bench.py build/MESI_Two_Level/gem5.opt build/CHI/gem5.opt
+#   ruby_cache_memory_bench.py --compare old/MESI_Two_Level/gem5.opt \
+#       build/MESI_Two_Level/gem5.opt --num-cpus 8
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+import statslib
+
+# The per state and event transition counts of the controllers
+TRANSITIONS = re.compile(r"_Controller\.\w+\.\w+::total$")
+
+
+def run(args, gem5, outdir):
+    cmd = [
+        gem5,
+        f"--outdir={outdir}",
+        "configs/example/ruby_mem_test.py",
+        f"--num-cpus={args.num_cpus}",
+        f"--abs-max-tick={args.abs_max_tick}",
+        f"--l1d_size={args.l1d_size}",
+        f"--l2_size={args.l2_size}",
+        "--functional=0",
+        "--network=simple",
+    ]
+    start = time.monotonic()
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+    secs = time.monotonic() - start
+    return secs, statslib.read_dumps(os.path.join(outdir, "stats.txt"))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Time the protocol transitions of Ruby"
+    )
+    parser.add_argument("gem5", nargs="+", help="The gem5 binaries to run")
+    parser.add_argument(
+        "--compare",
+        action="store_true",
+        help="Check that the stats of all the binaries match",
+    )
+    parser.add_argument("--num-cpus", type=int, default=4)
+    parser.add_argument("--abs-max-tick", type=int, default=200000000)
+    parser.add_argument("--l1d_size", default="16KiB")
+    parser.add_argument("--l2_size", default="256KiB")
+    parser.add_argument(
+        "--repeat",
+        type=int,
+        default=3,
+        help="Runs per binary, of which the fastest is reported",
+    )
+    args = parser.parse_args()
+
+    stats = []
+    with tempfile.TemporaryDirectory() as tmp:
+        for i, gem5 in enumerate(args.gem5):
+            secs = None
+            for r in range(args.repeat):
+                outdir = os.path.join(tmp, f"{i}_{r}")
+                run_secs, stats_i = run(args, gem5, outdir)
+                secs = run_secs if secs is None else min(secs, run_secs)
+            transitions = statslib.total(stats_i, TRANSITIONS)
+            print(
+                f"{gem5}: {secs:.2f} s, {transitions:.0f} transitions, "
+                f"{transitions / secs / 1e6:.2f} M/s"
+            )
+            stats.append(stats_i)
+
+    failed = False
+    for i in range(1, len(stats) if args.compare else 0):
+        differ = statslib.diff_dumps(stats[0], stats[i])
+        statslib.print_diff(
+            differ, f"with {args.gem5[0]}", f"with {args.gem5[i]}"
+        )
+        failed = failed or bool(differ)
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+
+# Read and compare the text statistics of gem5 runs
+#
+# Shared by the scripts that check that a change or a setting leaves the
+# simulation untouched, by comparing the statistics of a run with it and
+# a run without it. Every dump of a stats.txt is kept, in order, so that
+# the intermediate dumps are compared as well as the final one.
+
+import re
+
+# Stats that describe the host rather than the simulation
+HOST = re.compile(r"^host")
+
+# The line starting each dump
+BEGIN = "---------- Begin Simulation Statistics ----------"
+
+
+def ignoring(*patterns):
+    """Return a regex of the host stats and of the given patterns"""
+    return re.compile("|".join((HOST.pattern,) + patterns))
+
+
+def read_dumps(path, ignored=HOST):
+    """Return a dict of the stats of each dump in a stats.txt file"""
+    dumps = []
+    with open(path) as f:
+        for line in f:
+            if line.startswith(BEGIN):
+                dumps.append({})
+                continue
+            fields = line.split()
+            if not dumps or len(fields) < 2 or line.startswith("-"):
+                continue
+            if not ignored.search(fields[0]):
+                dumps[-1][fields[0]] = fields[1]
+    return dumps
+
+
+def diff_dumps(a, b, ignored=None):
+    """Return (dump, stat, value in a, value in b) for every difference"""
+    differ = []
+    for i, (stats_a, stats_b) in enumerate(zip(a, b)):
+        differ += [
+            (i, name, stats_a.get(name), stats_b.get(name))
+            for name in sorted(stats_a.keys() | stats_b.keys())
+            if stats_a.get(name) != stats_b.get(name)
+            and not (ignored and ignored.search(name))
+        ]
+    if len(a) != len(b):
+        differ.append((min(len(a), len(b)), "dumps", len(a), len(b)))
+    return differ
+
+
+def print_diff(differ, label_a, label_b):
+    for dump, name, value_a, value_b in differ:
+        print(
+            f"  dump {dump}, {name}: {value_a} {label_a}, {value_b} {label_b}"
+        )
+
+
+def total(dumps, pattern):
+    """Return the sum of the stats matching a regex in the last dump"""
+    if not dumps:
+        return 0.0
+    return sum(
+        float(value)
+        for name, value in dumps[-1].items()
+        if pattern.search(name)
+    )